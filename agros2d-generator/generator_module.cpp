@@ -581,12 +581,15 @@ void Agros2DGeneratorModule::generatePluginErrorCalculator()
 
                         expression->SetValue("EXPRESSION", exprCpp.toStdString());
 
+                        int variableIndex = 0;
                         foreach(QString key, m_volumeVariables.keys())
                         {
                             ctemplate::TemplateDictionary *subField = 0;
                             subField = expression->AddSectionDictionary("VARIABLE_SOURCE");
                             subField->SetValue("VARIABLE", key.toStdString());
                             subField->SetValue("VARIABLE_SHORT", m_volumeVariables.value(key).toStdString());
+                            // index to MaterialTable
+                            subField->SetValue("VARIABLE_INDEX", QString::number(variableIndex++).toStdString());
                         }
                     }
                 }
@@ -753,6 +756,7 @@ void Agros2DGeneratorModule::generatePluginFilterFiles()
     ctemplate::ExpandTemplate(compatibleFilename(QString("%1/%2/filter_h.tpl").arg(QApplication::applicationDirPath()).arg(GENERATOR_TEMPLATEROOT)).toStdString(),
                               ctemplate::DO_NOT_STRIP, &output, &text);
 
+    int materialIndex = 0;
     foreach (XMLModule::quantity quantity, m_module->volume().quantity())
     {
         if (quantity.shortname().present())
@@ -760,6 +764,8 @@ void Agros2DGeneratorModule::generatePluginFilterFiles()
             ctemplate::TemplateDictionary *variable = output.AddSectionDictionary("VARIABLE_MATERIAL");
 
             variable->SetValue("MATERIAL_VARIABLE", quantity.id());
+            // index to MaterialTable
+            variable->SetValue("MATERIAL_INDEX", QString::number(materialIndex++).toStdString());
         }
     }
 
@@ -876,6 +882,7 @@ void Agros2DGeneratorModule::generatePluginForceFiles()
 
     // force
     XMLModule::force force = m_module->postprocessor().force();
+    int materialIndex = 0;
     foreach (XMLModule::quantity quantity, m_module->volume().quantity())
     {
         if (quantity.shortname().present())
@@ -883,6 +890,8 @@ void Agros2DGeneratorModule::generatePluginForceFiles()
             ctemplate::TemplateDictionary *variable = output.AddSectionDictionary("VARIABLE_MATERIAL");
 
             variable->SetValue("MATERIAL_VARIABLE", quantity.id());
+            // index to MaterialTable
+            variable->SetValue("MATERIAL_INDEX", QString::number(materialIndex++).toStdString());
         }
     }
 
@@ -959,6 +968,7 @@ void Agros2DGeneratorModule::generatePluginLocalPointFiles()
     ctemplate::ExpandTemplate(compatibleFilename(QString("%1/%2/localvalue_h.tpl").arg(QApplication::applicationDirPath()).arg(GENERATOR_TEMPLATEROOT)).toStdString(),
                               ctemplate::DO_NOT_STRIP, &output, &text);
 
+    int materialIndex = 0;
     foreach (XMLModule::quantity quantity, m_module->volume().quantity())
     {
         if (quantity.shortname().present())
@@ -966,6 +976,8 @@ void Agros2DGeneratorModule::generatePluginLocalPointFiles()
             ctemplate::TemplateDictionary *variable = output.AddSectionDictionary("VARIABLE_MATERIAL");
 
             variable->SetValue("MATERIAL_VARIABLE", quantity.id());
+            // index to MaterialTable
+            variable->SetValue("MATERIAL_INDEX", QString::number(materialIndex++).toStdString());
         }
     }
 
@@ -1037,6 +1049,7 @@ void Agros2DGeneratorModule::generatePluginSurfaceIntegralFiles()
     ctemplate::ExpandTemplate(compatibleFilename(QString("%1/%2/surfaceintegral_h.tpl").arg(QApplication::applicationDirPath()).arg(GENERATOR_TEMPLATEROOT)).toStdString(),
                               ctemplate::DO_NOT_STRIP, &output, &text);
 
+    int materialIndex = 0;
     foreach (XMLModule::quantity quantity, m_module->volume().quantity())
     {
         if (quantity.shortname().present())
@@ -1044,6 +1057,8 @@ void Agros2DGeneratorModule::generatePluginSurfaceIntegralFiles()
             ctemplate::TemplateDictionary *variable = output.AddSectionDictionary("VARIABLE_MATERIAL");
 
             variable->SetValue("MATERIAL_VARIABLE", quantity.id());
+            // index to MaterialTable
+            variable->SetValue("MATERIAL_INDEX", QString::number(materialIndex++).toStdString());
         }
     }
 
@@ -1118,6 +1133,7 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
     ctemplate::ExpandTemplate(compatibleFilename(QString("%1/%2/volumeintegral_h.tpl").arg(QApplication::applicationDirPath()).arg(GENERATOR_TEMPLATEROOT)).toStdString(),
                               ctemplate::DO_NOT_STRIP, &output, &text);
 
+    int materialIndex = 0;
     foreach (XMLModule::quantity quantity, m_module->volume().quantity())
     {
         if (quantity.shortname().present())
@@ -1125,6 +1141,8 @@ void Agros2DGeneratorModule::generatePluginVolumeIntegralFiles()
             ctemplate::TemplateDictionary *variable = output.AddSectionDictionary("VARIABLE_MATERIAL");
 
             variable->SetValue("MATERIAL_VARIABLE", quantity.id());
+            // index to MaterialTable
+            variable->SetValue("MATERIAL_INDEX", QString::number(materialIndex++).toStdString());
         }
     }
 
@@ -1368,6 +1386,12 @@ void Agros2DGeneratorModule::createFilterExpression(ctemplate::TemplateDictionar
     {
         ctemplate::TemplateDictionary *expression = output.AddSectionDictionary("VARIABLE_SOURCE");
 
+        // name of the specialised filter class
+        expression->SetValue("FILTER_ID", QString("%1_%2_%3_%4").
+                             arg(variable).
+                             arg(analysisTypeToStringKey(analysisType)).
+                             arg(coordinateTypeToStringKey(coordinateType)).
+                             arg(physicFieldVariableCompToStringKey(physicFieldVariableComp)).toStdString());
         expression->SetValue("VARIABLE_HASH", QString::number(qHash(variable)).toStdString());
         expression->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
         expression->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
@@ -1392,6 +1416,10 @@ void Agros2DGeneratorModule::createLocalValueExpression(ctemplate::TemplateDicti
     expression->SetValue("EXPRESSION_SCALAR", exprScalar.isEmpty() ? "0" : parsePostprocessorExpression(analysisType, coordinateType, exprScalar, true).replace("[i]", "").toStdString());
     expression->SetValue("EXPRESSION_VECTORX", exprVectorX.isEmpty() ? "0" : parsePostprocessorExpression(analysisType, coordinateType, exprVectorX, true).replace("[i]", "").toStdString());
     expression->SetValue("EXPRESSION_VECTORY", exprVectorY.isEmpty() ? "0" : parsePostprocessorExpression(analysisType, coordinateType, exprVectorY, true).replace("[i]", "").toStdString());
+
+    // vector components are stored only for vector variables
+    if (!exprVectorX.isEmpty())
+        expression->AddSectionDictionary("VARIABLE_VECTOR");
 }
 
 void Agros2DGeneratorModule::createIntegralExpression(ctemplate::TemplateDictionary &output,
@@ -1404,12 +1432,25 @@ void Agros2DGeneratorModule::createIntegralExpression(ctemplate::TemplateDiction
 {
     if (!expr.isEmpty())
     {
+        QString exprCpp = parsePostprocessorExpression(analysisType, coordinateType, expr, true);
+
+        // polynomial degree of the integrand in the solution and coordinates (quadrature order)
+        int expressionOrder = qMin(exprCpp.count(QRegExp("\\b(value|dudx|dudy)\\[")), 2);
+        int coordinateOrder = qMin(exprCpp.count(QRegExp("\\b[xy]\\[i\\]")), 2);
+
+        // materials (possibly nonlinear), division and functions are not polynomials (the fixed order is used)
+        if (exprCpp.contains("material") || exprCpp.contains("/")
+                || exprCpp.contains(QRegExp("\\b(sqrt|pow|exp|log|sin|cos|tan|atan|atan2|fabs|abs)\\s*\\(")))
+            expressionOrder = -1;
+
         ctemplate::TemplateDictionary *expression = output.AddSectionDictionary(section.toStdString());
 
         expression->SetValue("VARIABLE", variable.toStdString());
         expression->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
         expression->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
-        expression->SetValue("EXPRESSION", parsePostprocessorExpression(analysisType, coordinateType, expr, true).toStdString());
+        expression->SetValue("EXPRESSION", exprCpp.toStdString());
+        expression->SetValue("EXPRESSION_ORDER", QString::number(expressionOrder).toStdString());
+        expression->SetValue("COORDINATE_ORDER", QString::number(coordinateOrder).toStdString());
         expression->SetValue("POSITION", QString::number(pos).toStdString());
     }
 }
@@ -2139,8 +2180,12 @@ void Agros2DGeneratorModule::generateExtFunction(XMLModule::quantity quantity, A
 
         // nonlinear or constant (in which case numberFromTable returns just a constant number)
         QString valueMethod("numberFromTable");
+        QString batchMethod("numbersFromTable");
         if(derivative)
+        {
             valueMethod = "derivativeFromTable";
+            batchMethod = "derivativesFromTable";
+        }
 
         // other dependence
         if(quantity.dependence().present())
@@ -2148,8 +2193,15 @@ void Agros2DGeneratorModule::generateExtFunction(XMLModule::quantity quantity, A
             if(quantity.dependence().get() == "time")
             {
                 valueMethod = "numberAtTime";
+                batchMethod = "";
                 dependence = "Agros2D::problem()->actualTime(), false";
             }
+            else if((quantity.dependence().get() == "space") || (quantity.dependence().get() == "time-space"))
+            {
+                // expression evaluated at the integration points
+                valueMethod = "";
+                batchMethod = "numbersAtTimeAndPoints";
+            }
             else if(quantity.dependence().get() == "")
             {
                 // todo: why are for some quantities in XML dependence=""? remove?
@@ -2162,6 +2214,20 @@ void Agros2DGeneratorModule::generateExtFunction(XMLModule::quantity quantity, A
         }
         field->SetValue("DEPENDENCE", dependence.toStdString());
         field->SetValue("VALUE_METHOD", valueMethod.toStdString());
+        // tables and coordinate dependent expressions are evaluated for all integration points of the element at once
+        if(batchMethod.isEmpty())
+        {
+            field->ShowSection("VALUE_POINTWISE");
+        }
+        else if(valueMethod.isEmpty())
+        {
+            field->ShowSection("VALUE_POINTS");
+        }
+        else
+        {
+            field->SetValue("BATCH_METHOD", batchMethod.toStdString());
+            field->ShowSection("VALUE_TABLE");
+        }
         field->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
         field->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
         field->SetValue("LINEARITY_TYPE", Agros2DGenerator::linearityTypeStringEnum(linearityType).toStdString());
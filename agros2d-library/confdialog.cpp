@@ -247,8 +247,10 @@ QWidget *ConfigComputerDialog::createSolverWidget()
     // general
     chkUseSolverCache = new QCheckBox(tr("Use solver cache (large memory requirements)"));
     txtCacheSize = new QSpinBox(this);
-    txtCacheSize->setMinimum(2);
-    txtCacheSize->setMaximum(50);
+    txtCacheSize->setMinimum(CACHE_SIZE_MIN);
+    txtCacheSize->setMaximum(CACHE_SIZE_MAX);
+    txtCacheSize->setSingleStep(64);
+    txtCacheSize->setSuffix(" MB");
 
     txtNumOfThreads = new QSpinBox(this);
     txtNumOfThreads->setMinimum(1);
@@ -257,7 +259,7 @@ QWidget *ConfigComputerDialog::createSolverWidget()
     QGridLayout *layoutSolver = new QGridLayout();
     layoutSolver->addWidget(new QLabel(tr("Number of threads:")), 0, 0);
     layoutSolver->addWidget(txtNumOfThreads, 0, 1);
-    layoutSolver->addWidget(new QLabel(tr("Number of cache slots:")), 1, 0);
+    layoutSolver->addWidget(new QLabel(tr("Solution cache size:")), 1, 0);
     layoutSolver->addWidget(txtCacheSize, 1, 1);
     layoutSolver->addWidget(chkUseSolverCache, 2, 0, 1, 2);
 
@@ -191,6 +191,50 @@ double DataTable::value(double x) const
         assert(0);
 }
 
+void DataTable::values(int n, const double *x, double *result) const
+{
+    assert(m_valid);
+
+    if (m_type == DataTableType_PiecewiseLinear)
+    {
+        m_linear.data()->values(n, x, result);
+    }
+    else if (m_type == DataTableType_CubicSpline)
+    {
+        for (int i = 0; i < n; i++)
+            result[i] = m_spline.data()->value(x[i]);
+    }
+    else if (m_type == DataTableType_Constant)
+    {
+        for (int i = 0; i < n; i++)
+            result[i] = m_constant.data()->value(x[i]);
+    }
+    else
+        assert(0);
+}
+
+void DataTable::derivatives(int n, const double *x, double *result) const
+{
+    assert(m_valid);
+
+    if (m_type == DataTableType_PiecewiseLinear)
+    {
+        m_linear.data()->derivatives(n, x, result);
+    }
+    else if (m_type == DataTableType_CubicSpline)
+    {
+        for (int i = 0; i < n; i++)
+            result[i] = m_spline.data()->derivative(x[i]);
+    }
+    else if (m_type == DataTableType_Constant)
+    {
+        for (int i = 0; i < n; i++)
+            result[i] = m_constant.data()->derivative(x[i]);
+    }
+    else
+        assert(0);
+}
+
 double DataTable::derivative(double x) const
 {    
 //    // todo: get rid of this, make derivative const function !
@@ -445,6 +489,78 @@ PiecewiseLinear::PiecewiseLinear(Hermes::vector<double> points, Hermes::vector<d
     {
         m_derivatives.push_back((m_values[i+1] - m_values[i]) / (m_points[i+1] - m_points[i]));
     }
+
+    createGrid();
+}
+
+void PiecewiseLinear::createGrid()
+{
+    m_gridSize = 0;
+    m_gridInvStep = 0.0;
+    m_gridIndex.clear();
+
+    if (m_size < 2)
+        return;
+
+    double length = m_points[m_size - 1] - m_points[0];
+    if (length <= 0.0)
+        return;
+
+    // two cells per interval (the scan from the cell index is short for nonuniform tables)
+    m_gridSize = 2 * (m_size - 1);
+    m_gridInvStep = m_gridSize / length;
+    m_gridIndex.resize(m_gridSize);
+
+    int leftIdx = 0;
+    for (int cell = 0; cell < m_gridSize; cell++)
+    {
+        double cellStart = m_points[0] + cell / m_gridInvStep;
+        while ((leftIdx < m_size - 2) && (m_points[leftIdx + 1] < cellStart))
+            leftIdx++;
+
+        m_gridIndex[cell] = leftIdx;
+    }
+}
+
+void PiecewiseLinear::values(int n, const double *x, double *result) const
+{
+    for (int i = 0; i < n; i++)
+    {
+        double key = x[i];
+        if (key < m_points.front())
+        {
+            result[i] = m_values.front();
+        }
+        else if (key > m_points.back())
+        {
+            result[i] = m_values[m_size - 1];
+        }
+        else if (m_gridSize == 0)
+        {
+            result[i] = m_values.front();
+        }
+        else
+        {
+            int leftIdx = gridLeftIndex(key);
+            result[i] = m_values[leftIdx] + m_derivatives[leftIdx] * (key - m_points[leftIdx]);
+        }
+    }
+}
+
+void PiecewiseLinear::derivatives(int n, const double *x, double *result) const
+{
+    for (int i = 0; i < n; i++)
+    {
+        double key = x[i];
+        if ((key < m_points.front()) || (key > m_points.back()) || (m_gridSize == 0))
+        {
+            result[i] = 0.0;
+        }
+        else
+        {
+            result[i] = m_derivatives[gridLeftIndex(key)];
+        }
+    }
 }
 
 int PiecewiseLinear::leftIndex(double x)
@@ -31,14 +31,40 @@ public:
     double value(double x);
     double derivative(double x);
 
+    // batch evaluation (x and result may be the same array)
+    void values(int n, const double *x, double *result) const;
+    void derivatives(int n, const double *x, double *result) const;
+
 private:
     int leftIndex(double x);
+    // left index found through the uniform grid (x has to be inside of the table)
+    inline int gridLeftIndex(double x) const
+    {
+        int cell = (int) ((x - m_points[0]) * m_gridInvStep);
+        if (cell >= m_gridSize)
+            cell = m_gridSize - 1;
+        else if (cell < 0)
+            cell = 0;
+
+        int leftIdx = m_gridIndex[cell];
+        while ((leftIdx < m_size - 2) && (m_points[leftIdx + 1] < x))
+            leftIdx++;
+
+        return leftIdx;
+    }
+
+    void createGrid();
 
     Hermes::vector<double> m_points;
     Hermes::vector<double> m_values;
 
     Hermes::vector<double> m_derivatives;
     int m_size;
+
+    // uniform grid over the table points, each cell stores the smallest possible left index
+    QVector<int> m_gridIndex;
+    int m_gridSize;
+    double m_gridInvStep;
 };
 
 // for testing.. returns average value. Simple "linearization" of the problem
@@ -70,6 +96,9 @@ public:
 
     double value(double x) const;
     double derivative(double x) const;
+    // batch evaluation (x and result may be the same array)
+    void values(int n, const double *x, double *result) const;
+    void derivatives(int n, const double *x, double *result) const;
     inline int size() const { return m_numPoints; }
     inline bool isEmpty() const {return m_isEmpty; }
     DataTableType type() const {return m_type;}
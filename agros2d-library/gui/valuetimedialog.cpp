@@ -167,17 +167,25 @@ void ValueTimeDialog::plotFunction()
     // time step
     double dt = totalTime / (count + 1);
 
-    QVector<double> pointsVector;
-    QVector<double> valuesVector;
+    QVector<double> pointsVector(count);
+    QVector<double> zerosVector(count, 0.0);
+    QVector<double> valuesVector(count);
+    for (int i = 0; i < count; i++)
+        pointsVector[i] = i*dt;
 
+    // all times are evaluated at once
     Value val(txtLineEdit->text());
+    val.numbersAtTimeAndPoints(count, pointsVector.constData(), zerosVector.constData(), zerosVector.constData(), valuesVector.data());
+
+    // values up to the first error
     for (int i = 0; i < count; i++)
     {
-        if (!val.evaluateAtTime(i*dt))
+        if (!qIsFinite(valuesVector[i]))
+        {
+            pointsVector.resize(i);
+            valuesVector.resize(i);
             break;
-
-        pointsVector.append(i*dt);
-        valuesVector.append(val.number());
+        }
     }
 
     chart->graph(0)->setData(pointsVector, valuesVector);
@@ -75,6 +75,81 @@ Hermes::Ord BDF2Table::vectorFormCoefficient(Hermes::Hermes2D::Func<Hermes::Ord>
     return coef;
 }
 
+QVector<double> BDF2Table::predictorCoefficients(int order, QList<double> previousStepsLengths)
+{
+    int numSteps = previousStepsLengths.length();
+    assert(numSteps > order);
+
+    // distances of the previous levels from the actual time
+    QVector<double> distances(order + 1);
+    double distance = 0.0;
+    for (int i = 0; i < order + 1; i++)
+    {
+        distance += previousStepsLengths[numSteps - 1 - i];
+        distances[i] = distance;
+    }
+
+    // Lagrange extrapolation to the actual time
+    QVector<double> coefficients(order + 1);
+    for (int i = 0; i < order + 1; i++)
+    {
+        coefficients[i] = 1.0;
+        for (int j = 0; j < order + 1; j++)
+            if (j != i)
+                coefficients[i] *= distances[j] / (distances[j] - distances[i]);
+    }
+
+    return coefficients;
+}
+
+double BDF2Table::predictorErrorFactor(int order, QList<double> previousStepsLengths)
+{
+    int numSteps = previousStepsLengths.length();
+    assert(numSteps > order);
+
+    // matrix coefficient of the BDF method of the given order (sum of inverse distances)
+    double matrixCoefficient = 0.0;
+    double distance = 0.0;
+    for (int i = 0; i < order; i++)
+    {
+        distance += previousStepsLengths[numSteps - 1 - i];
+        matrixCoefficient += 1.0 / distance;
+    }
+    distance += previousStepsLengths[numSteps - 1 - order];
+
+    // constant steps: 1/3 (order 1), 2/11 (order 2), 3/25 (order 3), 12/137 (order 4), 10/147 (order 5)
+    return 1.0 / (1.0 + matrixCoefficient * distance);
+}
+
+QVector<double> BDF2Table::differenceErrorCoefficients(int order, QList<double> previousStepsLengths)
+{
+    int numSteps = previousStepsLengths.length();
+    assert(numSteps > order);
+
+    // distances of the actual and the previous levels from the actual time
+    QVector<double> distances(order + 2);
+    distances[0] = 0.0;
+    for (int i = 1; i < order + 2; i++)
+        distances[i] = distances[i - 1] + previousStepsLengths[numSteps - i];
+
+    // error = 1 / (order + 1) * distances[1] * ... * distances[order + 1] * divided difference
+    // (constant steps: backward difference of the order + 1 divided by order + 1)
+    double scale = 1.0 / (order + 1);
+    for (int i = 1; i < order + 2; i++)
+        scale *= distances[i];
+
+    QVector<double> coefficients(order + 2);
+    for (int i = 0; i < order + 2; i++)
+    {
+        coefficients[i] = scale;
+        for (int j = 0; j < order + 2; j++)
+            if (j != i)
+                coefficients[i] /= (distances[j] - distances[i]);
+    }
+
+    return coefficients;
+}
+
 class Monomial
 {
 public:
@@ -115,6 +190,33 @@ void BDF2ATable::recalculate()
         m_alpha[2] = ((t1 + t0*t1 + 1) * t0*t0 / (1+t0)) / m_actualTimeStepLength;
         m_alpha[3] = ( -(1+t0) * t0*t0 * t1*t1*t1 / (t0*t1*t1 + t0*t1 + 2*t1 + 1 + t1*t1)) / m_actualTimeStepLength;
     }
+    else if (m_n <= 5)
+    {
+        // derivative of the Lagrange polynomial through the actual and m_n previous levels
+        // distances of the previous levels from the actual time
+        double distances[10];
+        double stepLength = m_actualTimeStepLength;
+        distances[0] = stepLength;
+        for (int i = 1; i < m_n; i++)
+        {
+            stepLength /= th[i - 1];
+            distances[i] = distances[i - 1] + stepLength;
+        }
+
+        // matrix coef
+        m_alpha[0] = 0.0;
+        for (int i = 0; i < m_n; i++)
+            m_alpha[0] += 1.0 / distances[i];
+
+        // vector coefs
+        for (int j = 0; j < m_n; j++)
+        {
+            m_alpha[j + 1] = -1.0 / distances[j];
+            for (int i = 0; i < m_n; i++)
+                if (i != j)
+                    m_alpha[j + 1] *= distances[i] / (distances[i] - distances[j]);
+        }
+    }
     else
         assert(0);
 }
@@ -150,11 +252,11 @@ void BDF2Table::test(bool varyLength)
 {
     BDF2ATable tableA;
 
-    double results[3][4];
+    double results[5][4];
 
     int numStepsArray[] = {100, 1000, 10000, 100000};
 
-    for(int order = 1; order <=3; order++)
+    for(int order = 1; order <=5; order++)
     {
         for(int numStepsIdx = 0; numStepsIdx < 4; numStepsIdx++)
         {
@@ -178,14 +280,7 @@ void BDF2Table::test(bool varyLength)
 
                 previousSteps.push_back(actualStepLen);
 
-                if(s == 0)
-                    realOrder = 1;
-
-                if((s == 1) && (order >= 2))
-                    realOrder = 2;
-
-                if((s == 2) && (order >= 3))
-                    realOrder = 3;
+                realOrder = min(s + 1, order);
 
                 tableA.setOrderAndPreviousSteps(realOrder, previousSteps);
                 actTime += actualStepLen;
@@ -203,7 +298,7 @@ void BDF2Table::test(bool varyLength)
         }
     }
     cout << "errors = [";
-    for(int ord = 0; ord < 3; ord++)
+    for(int ord = 0; ord < 5; ord++)
     {
         cout << "[";
         for(int st = 0; st < 4; st++)
@@ -213,7 +308,7 @@ void BDF2Table::test(bool varyLength)
                 cout << ",";
         }
         cout << "]";
-        if(ord < 2)
+        if(ord < 4)
             cout << ",";
     }
     cout << "]"<< endl << endl;
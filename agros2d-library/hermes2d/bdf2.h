@@ -42,6 +42,17 @@ public:
     double vectorFormCoefficient(Hermes::Hermes2D::Func<double> **ext, int component, int numComponents, int offsetPreviousTimeExt, int integrationPoint);
     Hermes::Ord vectorFormCoefficient(Hermes::Hermes2D::Func<Hermes::Ord> **ext, int component, int numComponents, int offsetPreviousTimeExt, int integrationPoint);
 
+    // embedded estimate of the local truncation error of the BDF method of the given order (predictor - corrector difference)
+    // predictor extrapolates the last order + 1 time levels to the actual time (the last step length is the actual step)
+    // coefficients belong to the levels from the last one backwards
+    static QVector<double> predictorCoefficients(int order, QList<double> previousStepsLengths);
+    // local truncation error of the corrector is predictorErrorFactor() * (corrector - predictor) (Milne's device)
+    static double predictorErrorFactor(int order, QList<double> previousStepsLengths);
+    // local truncation error of the BDF method of the given order estimated from the (order + 1)-th divided difference
+    // of the actual and the last order + 1 time levels (error of the neighbouring orders, as in DASSL)
+    // coefficients belong to the actual level and to the previous levels from the last one backwards
+    static QVector<double> differenceErrorCoefficients(int order, QList<double> previousStepsLengths);
+
     static void test(bool varyLength = false);
 
 protected:
@@ -57,6 +68,7 @@ protected:
     double m_alpha[10];
 };
 
+// variable step BDF method of orders 1 - 5
 class BDF2ATable : public BDF2Table
 {
     virtual void recalculate();
@@ -24,6 +24,7 @@
 #include "problem.h"
 #include "coupling.h"
 #include "scene.h"
+#include "scenemarker.h"
 #include "logview.h"
 #include "solver.h"
 #include "module.h"
@@ -170,6 +171,24 @@ bool Block::isTransient() const
     return false;
 }
 
+bool Block::hasCoordinateDependentValues() const
+{
+    foreach (Field *field, m_fields)
+    {
+        foreach (SceneBoundary *boundary, Agros2D::scene()->boundaries->filter(field->fieldInfo()).items())
+            foreach (Value value, boundary->values())
+                if (value.isCoordinateDependent())
+                    return true;
+
+        foreach (SceneMaterial *material, Agros2D::scene()->materials->filter(field->fieldInfo()).items())
+            foreach (Value value, material->values())
+                if (value.isCoordinateDependent())
+                    return true;
+    }
+
+    return false;
+}
+
 double Block::timeSkip() const
 {
     double skip = 0.;
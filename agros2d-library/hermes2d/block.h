@@ -57,6 +57,8 @@ public:
 
     LinearityType linearityType() const;
     bool isTransient() const;
+    // coordinate dependent values of materials and boundaries (evaluated during the assembly)
+    bool hasCoordinateDependentValues() const;
 
     Hermes::MatrixSolverType matrixSolver() const;
 
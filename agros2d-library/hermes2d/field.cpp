@@ -69,6 +69,14 @@ FieldInfo::FieldInfo(QString fieldId, const AnalysisType analysisType)
     setStringKeys();
     setDefaultValues();
 
+    // constants
+    foreach (XMLModule::constant cnst, m_plugin->module()->constants().constant())
+        m_constants[QString::fromStdString(cnst.id())] = cnst.value();
+
+    // analyses
+    foreach (XMLModule::analysis an, m_plugin->module()->general().analyses().analysis())
+        m_analyses[analysisTypeFromStringKey(QString::fromStdString(an.id()))] = m_plugin->localeName(QString::fromStdString(an.name()));
+
     clear();
 
     // default analysis
@@ -81,10 +89,41 @@ FieldInfo::~FieldInfo()
     delete m_plugin;
 }
 
+void FieldInfo::clearInitialMesh()
+{
+    m_initialMesh = Hermes::Hermes2D::MeshSharedPtr();
+
+    m_hermesMarkerToLabel.clear();
+    m_hermesMarkerToEdge.clear();
+}
+
 void FieldInfo::setInitialMesh(Hermes::Hermes2D::MeshSharedPtr mesh)
 {
     clearInitialMesh();
     m_initialMesh = mesh;
+
+    // marker conversion uses strings, element loops use dense tables instead
+    for (int labelIndex = 0; labelIndex < Agros2D::scene()->labels->count(); labelIndex++)
+    {
+        Hermes::Hermes2D::Mesh::MarkersConversion::IntValid marker = m_initialMesh->get_element_markers_conversion().get_internal_marker(QString::number(labelIndex).toStdString());
+        if (marker.valid && marker.marker >= 0)
+        {
+            while (m_hermesMarkerToLabel.size() <= marker.marker)
+                m_hermesMarkerToLabel.append(-1);
+            m_hermesMarkerToLabel[marker.marker] = labelIndex;
+        }
+    }
+
+    for (int edgeIndex = 0; edgeIndex < Agros2D::scene()->edges->count(); edgeIndex++)
+    {
+        Hermes::Hermes2D::Mesh::MarkersConversion::IntValid marker = m_initialMesh->get_boundary_markers_conversion().get_internal_marker(QString::number(edgeIndex).toStdString());
+        if (marker.valid && marker.marker >= 0)
+        {
+            while (m_hermesMarkerToEdge.size() <= marker.marker)
+                m_hermesMarkerToEdge.append(-1);
+            m_hermesMarkerToEdge[marker.marker] = edgeIndex;
+        }
+    }
 }
 
 void FieldInfo::setAnalysisType(AnalysisType at)
@@ -124,6 +163,8 @@ void FieldInfo::setAnalysisType(AnalysisType at)
             m_availableLinearityTypes = availableLinearityTypes(at);
         }
     }
+
+    createMetadata();
 }
 
 QList<LinearityType> FieldInfo::availableLinearityTypes(AnalysisType at) const
@@ -202,6 +243,8 @@ void FieldInfo::clear()
     m_adaptivityType = AdaptivityType_None;
     // m_matrixSolver = Hermes::SOLVER_UMFPACK;
     m_matrixSolver = Hermes::SOLVER_MUMPS;
+
+    m_metadata = Metadata();
 }
 
 void FieldInfo::refineMesh(Hermes::Hermes2D::MeshSharedPtr mesh)
@@ -267,17 +310,6 @@ QString FieldInfo::equation() const
     assert(0);
 }
 
-// constants
-QMap<QString, double> FieldInfo::constants() const
-{
-    QMap<QString, double> constants;
-    // constants
-    foreach (XMLModule::constant cnst, m_plugin->module()->constants().constant())
-        constants[QString::fromStdString(cnst.id())] = cnst.value();
-
-    return constants;
-}
-
 // macros
 QMap<QString, QString> FieldInfo::macros() const
 {
@@ -289,22 +321,51 @@ QMap<QString, QString> FieldInfo::macros() const
     return QMap<QString, QString>();
 }
 
-QMap<AnalysisType, QString> FieldInfo::analyses() const
+void FieldInfo::updateMetadata()
 {
-    QMap<AnalysisType, QString> analyses;
+    // analysis and linearity type rebuild the metadata in their setters
+    if (!m_metadata.isValid
+            || m_metadata.coordinateType != Agros2D::problem()->config()->coordinateType())
+        createMetadata();
+}
 
-    for (unsigned int i = 0; i < m_plugin->module()->general().analyses().analysis().size(); i++)
-    {
-        XMLModule::analysis an = m_plugin->module()->general().analyses().analysis().at(i);
+void FieldInfo::createMetadata()
+{
+    m_metadata = Metadata();
 
-        analyses[analysisTypeFromStringKey(QString::fromStdString(an.id()))] = m_plugin->localeName(QString::fromStdString(an.name()));
-    }
+    m_metadata.analysisType = m_analysisType;
+    m_metadata.linearityType = m_linearityType;
+    m_metadata.coordinateType = Agros2D::problem()->config()->coordinateType();
+
+    m_metadata.spaces = createSpaces();
+    m_metadata.materialTypeVariables = createMaterialTypeVariables();
+    m_metadata.boundaryTypes = createBoundaryTypes();
+    m_metadata.errorCalculators = createErrorCalculators();
+    m_metadata.localPointVariables = createLocalPointVariables();
+    m_metadata.surfaceIntegrals = createSurfaceIntegrals();
+    m_metadata.volumeIntegrals = createVolumeIntegrals();
+
+    foreach (Module::LocalVariable variable, m_metadata.localPointVariables)
+        if (!variable.isScalar())
+            m_metadata.viewVectorVariables.append(variable);
 
-    return analyses;
+    // first occurrence of id is used (the same as in previous linear search)
+    for (int i = m_metadata.materialTypeVariables.size() - 1; i >= 0; i--)
+        m_metadata.materialTypeVariableIndex[m_metadata.materialTypeVariables.at(i).id()] = i;
+    for (int i = m_metadata.boundaryTypes.size() - 1; i >= 0; i--)
+        m_metadata.boundaryTypeIndex[m_metadata.boundaryTypes.at(i).id()] = i;
+    for (int i = m_metadata.localPointVariables.size() - 1; i >= 0; i--)
+        m_metadata.localVariableIndex[m_metadata.localPointVariables.at(i).id()] = i;
+    for (int i = m_metadata.surfaceIntegrals.size() - 1; i >= 0; i--)
+        m_metadata.surfaceIntegralIndex[m_metadata.surfaceIntegrals.at(i).id()] = i;
+    for (int i = m_metadata.volumeIntegrals.size() - 1; i >= 0; i--)
+        m_metadata.volumeIntegralIndex[m_metadata.volumeIntegrals.at(i).id()] = i;
+
+    m_metadata.isValid = true;
 }
 
 // spaces
-QMap<int, Module::Space> FieldInfo::spaces() const
+QMap<int, Module::Space> FieldInfo::createSpaces() const
 {
     // spaces
     QMap<int, Module::Space> spaces;
@@ -319,7 +380,7 @@ QMap<int, Module::Space> FieldInfo::spaces() const
 }
 
 // material type
-QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
+QList<Module::MaterialTypeVariable> FieldInfo::createMaterialTypeVariables() const
 {
     // all materials variables
     QList<Module::MaterialTypeVariable> materialTypeVariablesAll;
@@ -389,7 +450,7 @@ QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
 
                         bool isTimeDep = false;
                         if (qty.dependence().present())
-                            isTimeDep = (QString::fromStdString(qty.dependence().get()) == "time");
+                            isTimeDep = (QString::fromStdString(qty.dependence().get()) == "time") || (QString::fromStdString(qty.dependence().get()) == "time-space");
 
                         materialTypeVariables.append(Module::MaterialTypeVariable(variable.id(), variable.shortname(),
                                                                                   nonlinearExpression, isTimeDep, variable.isBool(), variable.onlyIf(), variable.onlyIfNot(), variable.isSource()));
@@ -407,23 +468,18 @@ QList<Module::MaterialTypeVariable> FieldInfo::materialTypeVariables() const
 // variable by name
 bool FieldInfo::materialTypeVariableContains(const QString &id) const
 {
-    foreach (Module::MaterialTypeVariable var, materialTypeVariables())
-        if (var.id() == id)
-            return true;
-
-    return false;
+    return metadata().materialTypeVariableIndex.contains(id);
 }
 
 Module::MaterialTypeVariable FieldInfo::materialTypeVariable(const QString &id) const
 {
-    foreach (Module::MaterialTypeVariable var, materialTypeVariables())
-        if (var.id() == id)
-            return var;
+    const Metadata &data = metadata();
+    assert(data.materialTypeVariableIndex.contains(id));
 
-    assert(0);
+    return data.materialTypeVariables.at(data.materialTypeVariableIndex.value(id));
 }
 
-QList<Module::BoundaryType> FieldInfo::boundaryTypes() const
+QList<Module::BoundaryType> FieldInfo::createBoundaryTypes() const
 {
     QList<Module::BoundaryTypeVariable> boundaryTypeVariablesAll;
     for (int i = 0; i < m_plugin->module()->surface().quantity().size(); i++)
@@ -471,18 +527,14 @@ Module::BoundaryType FieldInfo::boundaryTypeDefault() const
 // variable by name
 bool FieldInfo::boundaryTypeContains(const QString &id) const
 {
-    foreach (Module::BoundaryType var, boundaryTypes())
-        if (var.id() == id)
-            return true;
-
-    return false;
+    return metadata().boundaryTypeIndex.contains(id);
 }
 
 Module::BoundaryType FieldInfo::boundaryType(const QString &id) const
 {
-    foreach (Module::BoundaryType var, boundaryTypes())
-        if (var.id() == id)
-            return var;
+    const Metadata &data = metadata();
+    if (data.boundaryTypeIndex.contains(id))
+        return data.boundaryTypes.at(data.boundaryTypeIndex.value(id));
 
     throw AgrosModuleException(QString("Boundary type %1 not found. Probably using corrupted a2d file or wrong version.").arg(id));
 }
@@ -503,7 +555,7 @@ Module::Force FieldInfo::force() const
 }
 
 // error calculators
-QList<Module::ErrorCalculator> FieldInfo::errorCalculators() const
+QList<Module::ErrorCalculator> FieldInfo::createErrorCalculators() const
 {
     QList<Module::ErrorCalculator> calculators;
     for (unsigned int i = 0; i < m_plugin->module()->error_calculator().calculator().size(); i++)
@@ -554,7 +606,7 @@ Module::DialogUI FieldInfo::boundaryUI() const
 }
 
 // local point variables
-QList<Module::LocalVariable> FieldInfo::localPointVariables() const
+QList<Module::LocalVariable> FieldInfo::createLocalPointVariables() const
 {
     // local variables
     QList<Module::LocalVariable> variables;
@@ -578,27 +630,8 @@ QList<Module::LocalVariable> FieldInfo::localPointVariables() const
     return variables;
 }
 
-// view scalar variables
-QList<Module::LocalVariable> FieldInfo::viewScalarVariables() const
-{
-    // scalar variables = local variables
-    return localPointVariables();
-}
-
-// view vector variables
-QList<Module::LocalVariable> FieldInfo::viewVectorVariables() const
-{
-    // vector variables
-    QList<Module::LocalVariable> variables;
-    foreach (Module::LocalVariable var, localPointVariables())
-        if (!var.isScalar())
-            variables.append(var);
-
-    return variables;
-}
-
 // surface integrals
-QList<Module::Integral> FieldInfo::surfaceIntegrals() const
+QList<Module::Integral> FieldInfo::createSurfaceIntegrals() const
 {
     // surface integrals
     QList<Module::Integral> surfaceIntegrals;
@@ -640,7 +673,7 @@ QList<Module::Integral> FieldInfo::surfaceIntegrals() const
 }
 
 // volume integrals
-QList<Module::Integral> FieldInfo::volumeIntegrals() const
+QList<Module::Integral> FieldInfo::createVolumeIntegrals() const
 {
     // volume integrals
     QList<Module::Integral> volumeIntegrals;
@@ -682,9 +715,9 @@ QList<Module::Integral> FieldInfo::volumeIntegrals() const
 // variable by name
 Module::LocalVariable FieldInfo::localVariable(const QString &id) const
 {
-    foreach (Module::LocalVariable var, localPointVariables())
-        if (var.id() == id)
-            return var;
+    const Metadata &data = metadata();
+    if (data.localVariableIndex.contains(id))
+        return data.localPointVariables.at(data.localVariableIndex.value(id));
 
     qDebug() << "Warning: unable to return local variable: " << id;
     return Module::LocalVariable();
@@ -692,9 +725,9 @@ Module::LocalVariable FieldInfo::localVariable(const QString &id) const
 
 Module::Integral FieldInfo::surfaceIntegral(const QString &id) const
 {
-    foreach (Module::Integral var, surfaceIntegrals())
-        if (var.id() == id)
-            return var;
+    const Metadata &data = metadata();
+    if (data.surfaceIntegralIndex.contains(id))
+        return data.surfaceIntegrals.at(data.surfaceIntegralIndex.value(id));
 
     qDebug() << "surfaceIntegral: " << id;
     assert(0);
@@ -702,9 +735,9 @@ Module::Integral FieldInfo::surfaceIntegral(const QString &id) const
 
 Module::Integral FieldInfo::volumeIntegral(const QString &id) const
 {
-    foreach (Module::Integral var, volumeIntegrals())
-        if (var.id() == id)
-            return var;
+    const Metadata &data = metadata();
+    if (data.volumeIntegralIndex.contains(id))
+        return data.volumeIntegrals.at(data.volumeIntegralIndex.value(id));
 
     qDebug() << "volumeIntegral: " << id;
     assert(0);
@@ -56,9 +56,15 @@ public:
     QString fieldId() const { return m_fieldId; }
 
     inline Hermes::Hermes2D::MeshSharedPtr initialMesh() const { return m_initialMesh; }
-    inline void clearInitialMesh() { m_initialMesh = Hermes::Hermes2D::MeshSharedPtr();}
+    void clearInitialMesh();
     void setInitialMesh(Hermes::Hermes2D::MeshSharedPtr mesh);
 
+    // scene label (edge) index of the hermes element (boundary) marker of the initial mesh, -1 if not assigned
+    inline int hermesMarkerToLabel(int marker) const { return m_hermesMarkerToLabel.value(marker, -1); }
+    inline int hermesMarkerToEdge(int marker) const { return m_hermesMarkerToEdge.value(marker, -1); }
+    // hermes element markers are from interval [0, numberOfHermesElementMarkers())
+    inline int numberOfHermesElementMarkers() const { return m_hermesMarkerToLabel.size(); }
+
     enum Type
     {
         Unknown,
@@ -102,7 +108,7 @@ public:
 
     // linearity
     inline LinearityType linearityType() const {return m_linearityType; }
-    void setLinearityType(const LinearityType lt) { m_linearityType = lt; emit changed(); }
+    void setLinearityType(const LinearityType lt) { m_linearityType = lt; createMetadata(); emit changed(); }
 
     QList<LinearityType> availableLinearityTypes(AnalysisType at) const;
 
@@ -165,24 +171,28 @@ public:
     QString equation() const;
 
     // constants
-    QMap<QString, double> constants() const;
+    inline const QMap<QString, double> &constants() const { return m_constants; }
 
     // macros
     QMap<QString, QString> macros() const;
 
-    QMap<AnalysisType, QString> analyses() const;
+    inline const QMap<AnalysisType, QString> &analyses() const { return m_analyses; }
+
+    // module metadata below depends on analysis, linearity and coordinate type
+    // it is read from the module whenever the configuration changes and returned from the cache
+    void updateMetadata();
 
     // spaces
-    QMap<int, Module::Space> spaces() const;
+    inline const QMap<int, Module::Space> &spaces() const { return metadata().spaces; }
 
     // material type
-    QList<Module::MaterialTypeVariable> materialTypeVariables() const;
+    inline const QList<Module::MaterialTypeVariable> &materialTypeVariables() const { return metadata().materialTypeVariables; }
     // variable by name
     bool materialTypeVariableContains(const QString &id) const;
     Module::MaterialTypeVariable materialTypeVariable(const QString &id) const;
 
     // boundary conditions
-    QList<Module::BoundaryType> boundaryTypes() const;
+    inline const QList<Module::BoundaryType> &boundaryTypes() const { return metadata().boundaryTypes; }
     // default boundary condition
     Module::BoundaryType boundaryTypeDefault() const;
     // variable by name
@@ -194,21 +204,21 @@ public:
     Module::Force force() const;
 
     // error calculators
-    QList<Module::ErrorCalculator> errorCalculators() const;
+    inline const QList<Module::ErrorCalculator> &errorCalculators() const { return metadata().errorCalculators; }
 
     // material and boundary user interface
     Module::DialogUI materialUI() const;
     Module::DialogUI boundaryUI() const;
 
     // local point variables
-    QList<Module::LocalVariable> localPointVariables() const;
+    inline const QList<Module::LocalVariable> &localPointVariables() const { return metadata().localPointVariables; }
     // view scalar and vector variables
-    QList<Module::LocalVariable> viewScalarVariables() const;
-    QList<Module::LocalVariable> viewVectorVariables() const;
+    inline const QList<Module::LocalVariable> &viewScalarVariables() const { return metadata().localPointVariables; }
+    inline const QList<Module::LocalVariable> &viewVectorVariables() const { return metadata().viewVectorVariables; }
     // surface integrals
-    QList<Module::Integral> surfaceIntegrals() const;
+    inline const QList<Module::Integral> &surfaceIntegrals() const { return metadata().surfaceIntegrals; }
     // volume integrals
-    QList<Module::Integral> volumeIntegrals() const;
+    inline const QList<Module::Integral> &volumeIntegrals() const { return metadata().volumeIntegrals; }
 
     // variable by name
     Module::LocalVariable localVariable(const QString &id) const;
@@ -236,6 +246,9 @@ private:
 
     // initial mesh
     Hermes::Hermes2D::MeshSharedPtr m_initialMesh;
+    // dense conversion of hermes markers (built with the initial mesh)
+    QVector<int> m_hermesMarkerToLabel;
+    QVector<int> m_hermesMarkerToEdge;
 
     // analysis type
     AnalysisType m_analysisType;
@@ -261,6 +274,50 @@ private:
     QMap<Type, QVariant> m_settingDefault;
     QMap<Type, QString> m_settingKey;
 
+    // module metadata independent of the configuration (read with the plugin)
+    QMap<QString, double> m_constants;
+    QMap<AnalysisType, QString> m_analyses;
+
+    // module metadata of one analysis, linearity and coordinate type
+    struct Metadata
+    {
+        Metadata() : isValid(false) {}
+
+        bool isValid;
+        AnalysisType analysisType;
+        LinearityType linearityType;
+        CoordinateType coordinateType;
+
+        QMap<int, Module::Space> spaces;
+        QList<Module::MaterialTypeVariable> materialTypeVariables;
+        QList<Module::BoundaryType> boundaryTypes;
+        QList<Module::ErrorCalculator> errorCalculators;
+        QList<Module::LocalVariable> localPointVariables;
+        QList<Module::LocalVariable> viewVectorVariables;
+        QList<Module::Integral> surfaceIntegrals;
+        QList<Module::Integral> volumeIntegrals;
+
+        // positions of ids in the lists above
+        QHash<QString, int> materialTypeVariableIndex;
+        QHash<QString, int> boundaryTypeIndex;
+        QHash<QString, int> localVariableIndex;
+        QHash<QString, int> surfaceIntegralIndex;
+        QHash<QString, int> volumeIntegralIndex;
+    };
+    Metadata m_metadata;
+
+    // metadata of the actual configuration (rebuilt when the configuration changes)
+    inline const Metadata &metadata() const { return m_metadata; }
+    void createMetadata();
+
+    QMap<int, Module::Space> createSpaces() const;
+    QList<Module::MaterialTypeVariable> createMaterialTypeVariables() const;
+    QList<Module::BoundaryType> createBoundaryTypes() const;
+    QList<Module::ErrorCalculator> createErrorCalculators() const;
+    QList<Module::LocalVariable> createLocalPointVariables() const;
+    QList<Module::Integral> createSurfaceIntegrals() const;
+    QList<Module::Integral> createVolumeIntegrals() const;
+
     void setDefaultValues();
     void setStringKeys();
 
@@ -423,9 +423,10 @@ void WeakFormAgros<Scalar>::registerForms()
 }
 
 template <typename Scalar>
-void WeakFormAgros<Scalar>::updateExtField()
+void WeakFormAgros<Scalar>::createExtFunctions()
 {
     Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > externalUSlns;
+    QList<AgrosExtFunction *> agrosExtFunctions;
 
     // todo: new values handling is not ready for hard coupling: offsets have to be used
     assert(m_block->fields().size() == 1);
@@ -471,30 +472,32 @@ void WeakFormAgros<Scalar>::updateExtField()
                 }
             }
 
-            Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> extFunction;
+            AgrosExtFunction *agrosExtFunction = NULL;
             if(containedInAnalysis)
-                extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(fieldInfo->plugin()->extFunction(problemId, quantityID, false, offsetI));
+                agrosExtFunction = fieldInfo->plugin()->extFunction(problemId, quantityID, false, offsetI);
             else
-                extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(new AgrosEmptyExtFunction());
+                agrosExtFunction = new AgrosEmptyExtFunction();
 
             assert(externalUSlns.size() == index);
-            externalUSlns.push_back(extFunction);
+            externalUSlns.push_back(Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(agrosExtFunction));
+            agrosExtFunctions.append(agrosExtFunction);
 
             // for nonlinear quantities, register derivative as well
             if(quantityIsNonlin[quantityID])
             {
-                extFunction = NULL;
+                agrosExtFunction = NULL;
                 if(containedInAnalysis)
-                    extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(fieldInfo->plugin()->extFunction(problemId, quantityID, true, offsetI));
+                    agrosExtFunction = fieldInfo->plugin()->extFunction(problemId, quantityID, true, offsetI);
                 else
                     // pass an empty functions if the quantity is not contained in the given analysis
                     // the reason is that we can use uniform indexing ext[n] in the weak forms (the same n for all analysis)
                     // as a result we can generate only one variant of each form (although there are more variants of ext functions because of different dependencies of nonlinear and time dependent terms)
-                    extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(new AgrosEmptyExtFunction());
+                    agrosExtFunction = new AgrosEmptyExtFunction();
 
-                assert(extFunction);
+                assert(agrosExtFunction);
                 assert(externalUSlns.size() - 1 == index);
-                externalUSlns.push_back(extFunction);
+                externalUSlns.push_back(Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(agrosExtFunction));
+                agrosExtFunctions.append(agrosExtFunction);
             }
         }
 
@@ -515,22 +518,41 @@ void WeakFormAgros<Scalar>::updateExtField()
                     break;
                 }
             }
-            Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> extFunction;
+            AgrosExtFunction *agrosExtFunction = NULL;
             if(containedInAnalysis)
-                extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(fieldInfo->plugin()->extFunction(problemId, functionID, false, offsetI));
+                agrosExtFunction = fieldInfo->plugin()->extFunction(problemId, functionID, false, offsetI);
             else
-                extFunction = Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(new AgrosEmptyExtFunction());
+                agrosExtFunction = new AgrosEmptyExtFunction();
 
             assert(externalUSlns.size() == index);
-            externalUSlns.push_back(extFunction);
+            externalUSlns.push_back(Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar>(agrosExtFunction));
+            agrosExtFunctions.append(agrosExtFunction);
         }
     }
 
-    this->set_u_ext_fn(externalUSlns);
+    m_extFunctions = externalUSlns;
+    m_agrosExtFunctions = agrosExtFunctions;
+
+    this->set_u_ext_fn(m_extFunctions);
+}
+
+template <typename Scalar>
+void WeakFormAgros<Scalar>::updateExtField()
+{
+    if (m_extFunctions.empty())
+    {
+        createExtFunctions();
+    }
+    else
+    {
+        // time dependent values are read through pointers, only tables with changed parameters are rebuilt
+        foreach (AgrosExtFunction *extFunction, m_agrosExtFunctions)
+            extFunction->update();
+    }
 
     // previous time steps solutions or solutions of coupled fields start after USlns
-    m_offsetPreviousTimeExt = externalUSlns.size();
-    m_offsetCouplingExt = externalUSlns.size();
+    m_offsetPreviousTimeExt = m_extFunctions.size();
+    m_offsetCouplingExt = m_extFunctions.size();
 
     FieldInfo* transientFieldInfo;
     CouplingInfo* couplingInfo;
@@ -591,7 +613,7 @@ void WeakFormAgros<Scalar>::updateExtField()
     // push external solution for weak coupling
     if(numTotalCouplings >= 1)
     {
-        assert(externalUSlns.size() + externalSlns.size() == m_offsetCouplingExt);
+        assert(m_extFunctions.size() + externalSlns.size() == m_offsetCouplingExt);
 
         FieldSolutionID solutionID = Agros2D::solutionStore()->lastTimeAndAdaptiveSolution(couplingInfo->sourceField(), SolutionMode_Finer);
 
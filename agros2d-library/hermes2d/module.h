@@ -161,6 +161,7 @@ public:
     ~WeakFormAgros();
 
     void registerForms();
+    // ext functions are created with the first call and reused in next time and adaptivity steps
     void updateExtField();
     inline BDF2Table* bdf2Table() { return m_bdf2Table; }
 
@@ -177,6 +178,8 @@ private:
                               SceneMaterial *materialTarget, CouplingInfo *couplingInfo);
     void addForm(WeakFormKind type, Hermes::Hermes2D::Form<Scalar>* form);
 
+    void createExtFunctions();
+
     virtual Hermes::Hermes2D::WeakForm<Scalar>* clone() const { return new WeakFormAgros<Scalar>(m_block); }
 
     Block* m_block;
@@ -191,6 +194,10 @@ private:
     int m_offsetCouplingExt;
 
     int m_numberOfForms;
+
+    // ext functions of material values and special functions (created once for the weak form)
+    Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > m_extFunctions;
+    QList<AgrosExtFunction *> m_agrosExtFunctions;
 };
 
 namespace Module
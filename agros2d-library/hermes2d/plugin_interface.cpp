@@ -8,19 +8,82 @@ AgrosExtFunction::~AgrosExtFunction()
         delete[] m_valuesPointers;
 }
 
+MaterialTable::MaterialTable(FieldInfo *fieldInfo, const QStringList &quantities)
+    : m_numberOfQuantities(quantities.count()),
+      m_materials(fieldInfo->numberOfHermesElementMarkers(), NULL),
+      m_values(fieldInfo->numberOfHermesElementMarkers() * quantities.count(), NULL)
+{
+    for (int marker = 0; marker < fieldInfo->numberOfHermesElementMarkers(); marker++)
+    {
+        int labelIndex = fieldInfo->hermesMarkerToLabel(marker);
+        if (labelIndex == -1)
+            continue;
+
+        SceneMaterial *material = Agros2D::scene()->labels->at(labelIndex)->marker(fieldInfo);
+        m_materials[marker] = material;
+        for (int i = 0; i < m_numberOfQuantities; i++)
+            m_values[marker * m_numberOfQuantities + i] = &material->value(quantities.at(i));
+    }
+}
+
+QMap<QString, double> IntegralValue::values(const QStringList &ids)
+{
+    if (ids.isEmpty())
+    {
+        if (!m_isCalculatedAll)
+        {
+            calculate(QStringList());
+            m_isCalculatedAll = true;
+        }
+
+        return m_values;
+    }
+
+    // calculate only variables which were not requested yet
+    if (!m_isCalculatedAll)
+    {
+        QStringList missing;
+        foreach (QString id, ids)
+            if (!m_calculated.contains(id))
+                missing.append(id);
+
+        if (!missing.isEmpty())
+        {
+            calculate(missing);
+            m_calculated.unite(missing.toSet());
+        }
+    }
+
+    QMap<QString, double> values;
+    foreach (QString id, ids)
+        if (m_values.contains(id))
+            values[id] = m_values[id];
+
+    return values;
+}
+
+Hermes::Ord integralOrder(int solutionOrder, int expressionDegree, int coordinateDegree)
+{
+    // integrand is not a polynomial (negative degree), fixed order
+    if (expressionDegree < 0)
+        return Hermes::Ord(20);
+
+    // the product of solution functions is integrated exactly (the margin covers curved elements)
+    return Hermes::Ord(qMin(expressionDegree * solutionOrder + coordinateDegree + 2, 20));
+}
+
 void AgrosExtFunction::getLabelValuesPointers(QString id)
 {
     if(m_valuesPointers)
         delete[] m_valuesPointers;
 
-    int labelsNum = Agros2D::scene()->labels->length();
-    m_valuesPointers = new Value*[labelsNum];
-    for(int i = 0; i < labelsNum; i++)
-    {
-        SceneLabel *label = Agros2D::scene()->labels->at(i);
-        Value* value = &label->marker(m_fieldInfo)->value(id);
-        m_valuesPointers[i] = value;
-    }
+    // elements are evaluated with hermes markers, labels are converted only once
+    MaterialTable table(m_fieldInfo, QStringList() << id);
+
+    int markersNum = m_fieldInfo->numberOfHermesElementMarkers();
+    m_valuesPointers = new Value*[markersNum];
+    for(int i = 0; i < markersNum; i++)
+        m_valuesPointers[i] = table.value(i, 0);
 }
 
 AgrosSpecialExtFunction::AgrosSpecialExtFunction(FieldInfo* fieldInfo, int offsetI, SpecialFunctionType type, int count) : AgrosExtFunction(fieldInfo, offsetI), m_type(type), m_count(count), m_conversion(nullptr)
@@ -79,9 +142,34 @@ Value** AgrosSpecialExtFunction::createValuePointers(QString id)
         valuePointers[i] = &Agros2D::scene()->labels->at(i)->marker(m_fieldInfo)->value(id);
     }
 
+    // array is released by the derived class
+    m_parameterPointers.append(valuePointers);
+
     return valuePointers;
 }
 
+QVector<double> AgrosSpecialExtFunction::parameterValues(int hermesMarker) const
+{
+    QVector<double> values;
+    foreach (Value **valuePointers, m_parameterPointers)
+        values.append(valuePointers[m_conversion[hermesMarker]]->number());
+
+    return values;
+}
+
+void AgrosSpecialExtFunction::update()
+{
+    if (!m_useTable)
+        return;
+
+    foreach (int hermesMarker, m_data.keys())
+    {
+        // material has been changed
+        if (parameterValues(hermesMarker) != m_dataParameters[hermesMarker])
+            createOneTable(hermesMarker);
+    }
+}
+
 void AgrosSpecialExtFunction::createOneTable(int hermesMarker)
 {
     double constantValue = -123456;
@@ -107,6 +195,7 @@ void AgrosSpecialExtFunction::createOneTable(int hermesMarker)
     QSharedPointer<DataTable> table(new DataTable(points, values));
     AgrosSpecialExtFunctionOneMaterial materialData(table, constantValue, extrapolationLow, extrapolationHi);
     m_data[hermesMarker] = materialData;
+    m_dataParameters[hermesMarker] = parameterValues(hermesMarker);
 }
 
 double AgrosSpecialExtFunction::valueFromTable(int hermesMarker, double h) const
@@ -36,6 +36,27 @@
 
 #include "../../resources_source/classes/coupling_xml.h"
 
+template <typename Scalar> class MultiArray;
+
+// materials and their values indexed by hermes element marker of the initial mesh
+// (resolved when the table is created, element loops do not convert markers)
+class AGROS_LIBRARY_API MaterialTable
+{
+public:
+    MaterialTable(FieldInfo *fieldInfo, const QStringList &quantities);
+
+    // NULL for markers without a scene label
+    inline SceneMaterial *material(int hermesMarker) const { return m_materials.value(hermesMarker, NULL); }
+    // quantity - index to the list of quantities given to the constructor
+    inline Value *value(int hermesMarker, int quantity) const { return m_values[hermesMarker * m_numberOfQuantities + quantity]; }
+
+private:
+    int m_numberOfQuantities;
+
+    QVector<SceneMaterial *> m_materials;
+    QVector<Value *> m_values;
+};
+
 //template <typename Scalar>
 class AGROS_LIBRARY_API AgrosExtFunction : public Hermes::Hermes2D::UExtFunction<double>
 {
@@ -52,6 +73,9 @@ public:
     }
 
     virtual void init() {}
+    // called before each solve of the session (ext functions are reused between time and adaptivity steps)
+    virtual void update() {}
+    // value pointers indexed by hermes element marker
     void getLabelValuesPointers(QString id);
 
 protected:
@@ -100,12 +124,16 @@ public:
     AgrosSpecialExtFunction(FieldInfo* fieldInfo, int offsetI, SpecialFunctionType type, int count = 0);
     ~AgrosSpecialExtFunction() { if(m_conversion) delete[] m_conversion;}
     virtual void init();
+    // rebuilds only tables of materials with changed parameters (e.g. time dependent values)
+    virtual void update();
     double getValue(int hermesMarker, double h) const;
     virtual double calculateValue(int hermesMarker, double h) const = 0;
     Value** createValuePointers(QString id);
 
 protected:
     void createOneTable(int hermesMarker);
+    // values of parameters used for the table of the given material
+    QVector<double> parameterValues(int hermesMarker) const;
 
     inline bool useInterpolation() const { return m_count > 0; }
 
@@ -117,6 +145,10 @@ protected:
     QMap<int , AgrosSpecialExtFunctionOneMaterial> m_data;
     bool m_useTable;
 
+    // parameter pointers (indexed by label) and their values at the time of table creation
+    QList<Value **> m_parameterPointers;
+    QMap<int, QVector<double> > m_dataParameters;
+
     // todo: should be done elsewhere
     void createConversion();
     // todo: should be done elsewhere
@@ -147,6 +179,14 @@ struct PointValue
     Material *material;
 };
 
+// batch of local values stored by columns, vector columns are empty for scalar variables
+struct PointValueColumns
+{
+    QVector<double> scalar;
+    QVector<double> vectorX;
+    QVector<double> vectorY;
+};
+
 class LocalValue
 {
 public:
@@ -174,14 +214,16 @@ protected:
     QMap<QString, PointValue> m_values;
 };
 
-class IntegralValue
+class AGROS_LIBRARY_API IntegralValue
 {
 public:
     IntegralValue(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
-        : m_fieldInfo(fieldInfo), m_timeStep(timeStep), m_adaptivityStep(adaptivityStep), m_solutionType(solutionType) {}
+        : m_fieldInfo(fieldInfo), m_timeStep(timeStep), m_adaptivityStep(adaptivityStep), m_solutionType(solutionType),
+          m_isCalculatedAll(false) {}
+    virtual ~IntegralValue() {}
 
-    // variables
-    inline QMap<QString, double> values() const { return m_values; }
+    // variables (all if ids are empty), calculated on the first request
+    QMap<QString, double> values(const QStringList &ids = QStringList());
 
 protected:
     // field info
@@ -192,8 +234,18 @@ protected:
 
     // variables
     QMap<QString, double> m_values;
+
+    // calculates requested variables (all if ids are empty) to m_values
+    virtual void calculate(const QStringList &ids) = 0;
+
+private:
+    bool m_isCalculatedAll;
+    QSet<QString> m_calculated;
 };
 
+// quadrature order of the integrand (polynomial of the given degree in solution and coordinates, negative degree for other integrands)
+Hermes::Ord integralOrder(int solutionOrder, int expressionDegree, int coordinateDegree);
+
 const int OFFSET_NON_DEF = -100;
 
 class FormAgrosInterface
@@ -315,6 +367,9 @@ public:
 
     // local values
     virtual LocalValue *localValue(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point) = 0;
+    // local values in many points (shared setup, points outside of the mesh have no material)
+    virtual void localValues(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                             const QVector<Point> &points, QMap<QString, PointValueColumns> &results) = 0;
     // surface integrals
     virtual IntegralValue *surfaceIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) = 0;
     // volume integrals
@@ -322,6 +377,9 @@ public:
     // force calculation
     virtual Point3 force(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                          Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity) = 0;
+    // force calculation from solutions prepared by caller (reentrant, time functions have to be updated by caller)
+    virtual Point3 force(FieldInfo *fieldInfo, int timeStep, MultiArray<double> &multiArray,
+                         Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity) = 0;
     virtual bool hasForce(FieldInfo *fieldInfo) = 0;
 
     // localization
@@ -42,6 +42,11 @@
 
 #include "pythonlab/pythonengine.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <exception>
+
 CalculationThread::CalculationThread() : QThread()
 {
 }
@@ -98,6 +103,7 @@ Problem::Problem()
     actSolveAdaptiveStep = new QAction(icon("run-step"), tr("Adaptive step"), this);
     connect(actSolveAdaptiveStep, SIGNAL(triggered()), this, SLOT(doSolveAdaptiveStepWithGUI()));
 
+    connect(m_config, SIGNAL(changed()), this, SLOT(updateFieldMetadata()));
     connect(m_config, SIGNAL(changed()), this, SLOT(clearSolution()));
 }
 
@@ -186,13 +192,23 @@ void Problem::clearSolution()
     emit clearedSolution();
 }
 
+void Problem::updateFieldMetadata()
+{
+    // module metadata depends on the coordinate type
+    foreach (FieldInfo* fieldInfo, m_fieldInfos)
+        fieldInfo->updateMetadata();
+}
+
 void Problem::clearFieldsAndConfig()
 {
     clearSolution();
+    clearMeshCache();
+    m_initialMeshesUnrefined.clear();
 
     foreach (Block* block, m_blocks)
         delete block;
     m_blocks.clear();
+    m_blockLevels.clear();
 
     // clear couplings
     foreach (CouplingInfo* couplingInfo, m_couplingInfos)
@@ -339,6 +355,38 @@ void Problem::createStructure()
         block->setWeakForm(new WeakFormAgros<double>(block));
         block->weakForm()->registerForms();
     }
+
+    createBlockLevels();
+}
+
+void Problem::createBlockLevels()
+{
+    m_blockLevels.clear();
+
+    // blocks are ordered (source of weak coupling is always before its target)
+    // level of the block is one above the highest level of blocks it depends on
+    QMap<Block *, int> levels;
+    foreach (Block* block, m_blocks)
+    {
+        int level = 0;
+        foreach (CouplingInfo* couplingInfo, m_couplingInfos)
+        {
+            if (couplingInfo->isWeak() && block->contains(couplingInfo->targetField()))
+            {
+                Block *sourceBlock = blockOfField(couplingInfo->sourceField());
+                if (sourceBlock && (sourceBlock != block))
+                {
+                    assert(levels.contains(sourceBlock));
+                    level = qMax(level, levels[sourceBlock] + 1);
+                }
+            }
+        }
+        levels[block] = level;
+
+        while (m_blockLevels.size() <= level)
+            m_blockLevels.append(QList<Block *>());
+        m_blockLevels[level].append(block);
+    }
 }
 
 bool Problem::mesh(bool emitMeshed)
@@ -431,7 +479,13 @@ bool Problem::meshAction(bool emitMeshed)
         // load mesh
         try
         {
-            readInitialMeshesFromFile(emitMeshed, meshGenerator.data()->xmldomain());
+            Agros2D::log()->printMessage(tr("Problem"), tr("Reading initial mesh from memory"));
+
+            setInitialMeshes(meshGenerator.data()->meshes(), emitMeshed);
+
+            // store meshes for the next solve
+            storeMeshCache();
+
             return true;
         }
         catch (AgrosException& e)
@@ -564,10 +618,20 @@ void Problem::solveInit(bool reCreateStructure)
         Agros2D::log()->printError(tr("Problem"), e.toString());
     }
 
-    // todo: we should not mesh always, but we would need to refine signals to determine when is it neccesary
-    // (whether, e.g., parameters of the mesh have been changed)
-    if (!mesh(false))
-        throw AgrosSolverException(tr("Could not create mesh"));
+    // mesh only if geometry or parameters of the mesh have been changed
+    if (!m_meshCache.isEmpty() && (m_meshCacheHash == meshHash()))
+    {
+        Agros2D::log()->printMessage(tr("Problem"), tr("Geometry and mesh parameters are unchanged, initial mesh reused"));
+        restoreMeshCache();
+    }
+    else
+    {
+        if (!m_meshCache.isEmpty())
+            Agros2D::log()->printDebug(tr("Problem"), tr("Geometry or mesh parameters have been changed, initial mesh is regenerated"));
+
+        if (!mesh(false))
+            throw AgrosSolverException(tr("Could not create mesh"));
+    }
 
     if (reCreateStructure || m_blocks.isEmpty())
     {
@@ -647,6 +711,9 @@ void Problem::solve(bool adaptiveStepOnly, bool commandLine)
         else
             solveAction();
 
+        // wait for the solution files and compact run time details
+        Agros2D::solutionStore()->flush();
+
         m_lastTimeElapsed = milisecondsToTime(timeCounter.elapsed());
 
         // elapsed time
@@ -773,67 +840,90 @@ void Problem::solveAction()
     bool doNextTimeStep = true;
     do
     {
-        foreach (Block* block, m_blocks)
+        foreach (QList<Block *> level, m_blockLevels)
         {
-            if (block->isTransient() && (actualTimeStep() == 0))
-            {
-                solvers[block]->solveInitialTimeStep();
-            }
-            else if(!skipThisTimeStep(block))
+            // blocks of one level do not depend on each other, simple solves are overlapped
+            // time functions, BDF tables and boundary conditions are updated in the main thread (prepareSimple),
+            // blocks with coordinate dependent values, nonlinear solvers or space adaptivity are solved sequentially
+            // (expressions evaluated during the assembly and log of the nonlinear solvers are not thread safe)
+            QList<Block *> concurrentBlocks;
+            foreach (Block* block, level)
+                if (!(block->isTransient() && (actualTimeStep() == 0)) && !skipThisTimeStep(block)
+                        && (block->adaptivityType() == AdaptivityType_None)
+                        && (block->linearityType() == LinearityType_Linear)
+                        && !block->hasCoordinateDependentValues())
+                    concurrentBlocks.append(block);
+
+            if (concurrentBlocks.size() > 1)
+                solveBlocksConcurrently(concurrentBlocks, solvers);
+            else
+                concurrentBlocks.clear();
+
+            foreach (Block* block, level)
             {
-                stepMessage(block);
-                if (block->adaptivityType() == AdaptivityType_None)
+                if (block->isTransient() && (actualTimeStep() == 0))
                 {
-                    // no adaptivity
-                    solvers[block]->solveSimple(actualTimeStep(), 0);
+                    solvers[block]->solveInitialTimeStep();
                 }
-                else
+                else if (concurrentBlocks.contains(block) || !skipThisTimeStep(block))
                 {
-                    // adaptivity
-                    int adaptStep = 1;
-                    bool doContinueAdaptivity = true;
-                    while (doContinueAdaptivity && (adaptStep <= block->adaptivitySteps()) && !m_abort)
+                    if (!concurrentBlocks.contains(block))
                     {
-                        // solve problem
-                        solvers[block]->solveReferenceAndProject(actualTimeStep(), adaptStep - 1);
-                        // create adapted space
-                        doContinueAdaptivity = solvers[block]->createAdaptedSpace(actualTimeStep(), adaptStep);
-
-                        // Python callback
-                        foreach (Field *field, block->fields())
+                        stepMessage(block);
+                        if (block->adaptivityType() == AdaptivityType_None)
                         {
-                            QString command = QString("(agros2d.field(\"%1\").adaptivity_callback(%2) if (agros2d.field(\"%1\").adaptivity_callback is not None and hasattr(agros2d.field(\"%1\").adaptivity_callback, '__call__')) else True)").
-                                    arg(field->fieldInfo()->fieldId()).
-                                    arg(adaptStep - 1);
-
-                            double cont = 1.0;
-                            bool successfulRun = currentPythonEngine()->runExpression(command, &cont);
-                            if (!successfulRun)
+                            // no adaptivity
+                            solvers[block]->solveSimple(actualTimeStep(), 0);
+                        }
+                        else
+                        {
+                            // adaptivity
+                            int adaptStep = 1;
+                            bool doContinueAdaptivity = true;
+                            while (doContinueAdaptivity && (adaptStep <= block->adaptivitySteps()) && !m_abort)
                             {
-                                ErrorResult result = currentPythonEngine()->parseError();
-                                Agros2D::log()->printError(QObject::tr("Adaptivity callback"), result.error());
+                                // solve problem
+                                solvers[block]->solveReferenceAndProject(actualTimeStep(), adaptStep - 1);
+                                // create adapted space
+                                doContinueAdaptivity = solvers[block]->createAdaptedSpace(actualTimeStep(), adaptStep);
+
+                                // Python callback
+                                foreach (Field *field, block->fields())
+                                {
+                                    QString command = QString("(agros2d.field(\"%1\").adaptivity_callback(%2) if (agros2d.field(\"%1\").adaptivity_callback is not None and hasattr(agros2d.field(\"%1\").adaptivity_callback, '__call__')) else True)").
+                                            arg(field->fieldInfo()->fieldId()).
+                                            arg(adaptStep - 1);
+
+                                    double cont = 1.0;
+                                    bool successfulRun = currentPythonEngine()->runExpression(command, &cont);
+                                    if (!successfulRun)
+                                    {
+                                        ErrorResult result = currentPythonEngine()->parseError();
+                                        Agros2D::log()->printError(QObject::tr("Adaptivity callback"), result.error());
+                                    }
+
+                                    if (!cont)
+                                        doContinueAdaptivity = false;
+                                    break;
+                                }
+
+                                adaptStep++;
                             }
-
-                            if (!cont)
-                                doContinueAdaptivity = false;
-                            break;
                         }
-
-                        adaptStep++;
                     }
-                }
 
-                // TODO: it should be estimated in the first step as well
-                // TODO: what if more blocks are transient? (take minimum? )
+                    // TODO: it should be estimated in the first step as well
+                    // TODO: what if more blocks are transient? (take minimum? )
 
-                // TODO: space + time adaptivity
-                if (block->isTransient() && (actualTimeStep() >= 1))
-                {
-                    nextTimeStep = solvers[block]->estimateTimeStepLength(actualTimeStep(), 0);
+                    // TODO: space + time adaptivity
+                    if (block->isTransient() && (actualTimeStep() >= 1))
+                    {
+                        nextTimeStep = solvers[block]->estimateTimeStepLength(actualTimeStep(), 0);
 
-                    //save actual time and indicator, whether calculation on this time was refused
-                    m_timeHistory.push_back(QPair<double, bool>(actualTime(), nextTimeStep.refuse));
-                    //qDebug() << nextTimeStep.length << ", " << actualTime() << ", " << nextTimeStep.refuse;
+                        //save actual time and indicator, whether calculation on this time was refused
+                        m_timeHistory.push_back(QPair<double, bool>(actualTime(), nextTimeStep.refuse));
+                        //qDebug() << nextTimeStep.length << ", " << actualTime() << ", " << nextTimeStep.refuse;
+                    }
                 }
             }
         }
@@ -877,6 +967,59 @@ void Problem::solveAction()
     } while (doNextTimeStep && !m_abort);
 }
 
+void Problem::solveBlocksConcurrently(const QList<Block *> &blocks, QMap<Block *, QSharedPointer<ProblemSolver<double> > > &solvers)
+{
+    int timeStep = actualTimeStep();
+
+    // forms, boundary conditions and messages are prepared in the main thread
+    QVector<ProblemSolver<double> *> blockSolvers;
+    foreach (Block* block, blocks)
+    {
+        stepMessage(block);
+        blockSolvers.append(solvers[block].data());
+        blockSolvers.last()->prepareSimple(timeStep, 0);
+    }
+
+    // each block gets its share of threads for assembling and solving
+    int numberOfThreads = Agros2D::configComputer()->numberOfThreads;
+    int numberOfBlockThreads = qMin(blocks.count(), numberOfThreads);
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, qMax(1, numberOfThreads / blocks.count()));
+
+#ifdef _OPENMP
+    int nested = omp_get_nested();
+    omp_set_nested(1);
+#endif
+
+    QVector<std::exception_ptr> exceptions(blocks.count());
+
+#pragma omp parallel for num_threads(numberOfBlockThreads) schedule(dynamic, 1)
+    for (int i = 0; i < blockSolvers.count(); i++)
+    {
+        try
+        {
+            blockSolvers[i]->solvePreparedSimple(timeStep, 0, false);
+        }
+        catch (...)
+        {
+            exceptions[i] = std::current_exception();
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_nested(nested);
+#endif
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, numberOfThreads);
+
+    // first failure (in the order of blocks) is reported
+    for (int i = 0; i < blockSolvers.count(); i++)
+        if (exceptions[i])
+            std::rethrow_exception(exceptions[i]);
+
+    // deterministic order of insertions to the solution store
+    for (int i = 0; i < blockSolvers.count(); i++)
+        blockSolvers[i]->storePendingSolution();
+}
+
 void Problem::solveAdaptiveStepAction()
 {
     solveInit(false);
@@ -957,51 +1100,128 @@ void Problem::stepMessage(Block* block)
     }
 }
 
+QByteArray Problem::meshHash() const
+{
+    // content hash of all data the initial meshes depend on
+    // values of materials and boundary conditions are not included
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    stream << (int) m_config->meshType();
+
+    foreach (SceneNode *node, Agros2D::scene()->nodes->items())
+        stream << node->point().x << node->point().y;
+
+    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+        stream << edge->nodeStart()->point().x << edge->nodeStart()->point().y
+               << edge->nodeEnd()->point().x << edge->nodeEnd()->point().y
+               << edge->angle() << edge->segments() << edge->isCurvilinear();
+
+    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
+        stream << label->point().x << label->point().y << label->area();
+
+    foreach (FieldInfo *fieldInfo, m_fieldInfos)
+    {
+        stream << fieldInfo->fieldId() << fieldInfo->value(FieldInfo::SpaceNumberOfRefinements).toInt();
+
+        // subdomains and refinements
+        foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+            stream << (edge->hasMarker(fieldInfo) && !edge->marker(fieldInfo)->isNone()) << fieldInfo->edgeRefinement(edge);
 
-void Problem::readInitialMeshesFromFile(bool emitMeshed, std::auto_ptr<XMLSubdomains::domain> xmldomain)
+        foreach (SceneLabel *label, Agros2D::scene()->labels->items())
+            stream << label->marker(fieldInfo)->isNone() << fieldInfo->labelRefinement(label);
+    }
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+void Problem::storeMeshCache()
 {
-    // load initial mesh file
-    // prepare mesh array
-    Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshesVector;
-    QMap<FieldInfo *, Hermes::Hermes2D::MeshSharedPtr> meshes;
-    foreach (FieldInfo* fieldInfo, m_fieldInfos)
+    clearMeshCache();
+
+    foreach (FieldInfo *fieldInfo, m_fieldInfos)
     {
+        // private copy, initial meshes could be modified during the solution
         Hermes::Hermes2D::MeshSharedPtr mesh(new Hermes::Hermes2D::Mesh());
+        mesh->copy(fieldInfo->initialMesh());
 
-        meshesVector.push_back(mesh);
-        // cache
-        meshes[fieldInfo] = mesh;
+        m_meshCache[fieldInfo->fieldId()] = mesh;
     }
 
-    Hermes::HermesCommonApi.set_integral_param_value(Hermes::checkMeshesOnLoad, false);
+    m_meshCacheHash = meshHash();
+}
 
-    Hermes::Hermes2D::MeshReaderH2DXML meshloader;
-    if (!xmldomain.get())
+void Problem::restoreMeshCache()
+{
+    foreach (FieldInfo *fieldInfo, m_fieldInfos)
     {
-        Agros2D::log()->printMessage(tr("Problem"), tr("Loading initial mesh from disk"));
-
-        // read from file
-        // save locale
-        char *plocale = setlocale (LC_NUMERIC, "");
-        setlocale (LC_NUMERIC, "C");
+        assert(m_meshCache.contains(fieldInfo->fieldId()));
 
-        // load mesh from file
-        QString fileName = QFileInfo(cacheProblemDir() + "/initial.msh").absoluteFilePath();
-        meshloader.set_validation(false);
-        meshloader.load(fileName.toStdString().c_str(), meshesVector);
+        Hermes::Hermes2D::MeshSharedPtr mesh(new Hermes::Hermes2D::Mesh());
+        mesh->copy(m_meshCache[fieldInfo->fieldId()]);
 
-        // set system locale
-        setlocale(LC_NUMERIC, plocale);
+        fieldInfo->setInitialMesh(mesh);
     }
+}
+
+void Problem::clearMeshCache()
+{
+    m_meshCache.clear();
+    m_meshCacheHash.clear();
+}
+
+QString Problem::initialMeshFileName() const
+{
+    return QString("%1/initial.mesh").arg(cacheProblemDir());
+}
+
+void Problem::readInitialMeshesFromFile(bool emitMeshed)
+{
+    Agros2D::log()->printMessage(tr("Problem"), tr("Loading initial mesh from disk"));
+
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::checkMeshesOnLoad, false);
+
+    // load initial mesh file (binary, legacy XML "initial.msh" is still supported)
+    Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes;
+    if (QFile::exists(initialMeshFileName()))
+        meshes = Module::readMeshFromFileBSON(initialMeshFileName());
     else
+        meshes = Module::readMeshFromFileXML(cacheProblemDir() + "/initial.msh");
+
+    setInitialMeshes(meshes, emitMeshed);
+}
+
+void Problem::writeInitialMeshesToFile()
+{
+    if (!m_initialMeshesUnrefined.empty())
+        Module::writeMeshToFileBSON(initialMeshFileName(), m_initialMeshesUnrefined);
+}
+
+void Problem::writeInitialMeshToFileXML(const QString &fileName)
+{
+    if (!m_initialMeshesUnrefined.empty())
+        Module::writeMeshToFileXML(fileName, m_initialMeshesUnrefined);
+}
+
+void Problem::setInitialMeshes(Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshesVector, bool emitMeshed)
+{
+    assert(meshesVector.size() == (unsigned int) m_fieldInfos.count());
+
+    // unrefined meshes are written to the disk only on save and export
+    m_initialMeshesUnrefined.clear();
+    for (unsigned int i = 0; i < meshesVector.size(); i++)
     {
-        Agros2D::log()->printMessage(tr("Problem"), tr("Reading initial mesh from memory"));
+        Hermes::Hermes2D::MeshSharedPtr mesh(new Hermes::Hermes2D::Mesh());
+        mesh->copy(meshesVector.at(i));
 
-        // read from memory
-        std::auto_ptr<XMLSubdomains::domain> xml(xmldomain);
-        meshloader.load(xml, meshesVector);
+        m_initialMeshesUnrefined.push_back(mesh);
     }
 
+    QMap<FieldInfo *, Hermes::Hermes2D::MeshSharedPtr> meshes;
+    int fieldIndex = 0;
+    foreach (FieldInfo* fieldInfo, m_fieldInfos)
+        meshes[fieldInfo] = meshesVector.at(fieldIndex++);
+
     QSet<int> boundaries;
     foreach (FieldInfo *fieldInfo, m_fieldInfos)
     {
@@ -1063,7 +1283,8 @@ void Problem::readSolutionsFromFile()
 {
     Agros2D::log()->printMessage(tr("Problem"), tr("Loading spaces and solutions from disk"));
 
-    if (QFile::exists(QString("%1/runtime.xml").arg(cacheProblemDir())))
+    if (QFile::exists(QString("%1/runtime.xml").arg(cacheProblemDir())) ||
+            QFile::exists(QString("%1/runtime.journal").arg(cacheProblemDir())))
     {
         // load structure
         Agros2D::solutionStore()->loadRunTimeDetails();
@@ -14,6 +14,9 @@ class ProblemConfig;
 class ProblemSetting;
 class PyProblem;
 
+template <typename Scalar>
+class ProblemSolver;
+
 class CalculationThread : public QThread
 {
    Q_OBJECT
@@ -146,7 +149,11 @@ public:
     void refuseLastTimeStepLength();
 
     // read initial meshes and solution
-    void readInitialMeshesFromFile(bool emitMeshed = true, std::auto_ptr<XMLSubdomains::domain> xmldomain = std::auto_ptr<XMLSubdomains::domain>());
+    void readInitialMeshesFromFile(bool emitMeshed = true);
+    // write unrefined initial meshes to the cache directory (save)
+    void writeInitialMeshesToFile();
+    // export initial meshes in XML format
+    void writeInitialMeshToFileXML(const QString &fileName);
     void readSolutionsFromFile();
 
     QList<QPair<double, bool> > timeStepHistory() const { return m_timeHistory; }
@@ -158,6 +165,8 @@ private:
     ProblemSetting *m_setting;
 
     QList<Block *> m_blocks;
+    // blocks grouped by levels of weak coupling dependencies (blocks of one level are independent)
+    QList<QList<Block *> > m_blockLevels;
 
     QMap<QString, FieldInfo *> m_fieldInfos;
     QMap<QPair<FieldInfo*, FieldInfo* >, CouplingInfo* > m_couplingInfos;
@@ -180,12 +189,30 @@ private:
     QList<double> m_timeStepLengths;
     QList<QPair<double, bool> > m_timeHistory;
 
+    // refined initial meshes of the last meshing and their content hash
+    QMap<QString, Hermes::Hermes2D::MeshSharedPtr> m_meshCache;
+    QByteArray m_meshCacheHash;
+    // unrefined initial meshes (written to the disk only on save and export)
+    Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> m_initialMeshesUnrefined;
+
     bool skipThisTimeStep(Block* block);
 
     bool meshAction(bool emitMeshed = true);
+    // checks and refines initial meshes (one per field) and assigns them to fields
+    void setInitialMeshes(Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshesVector, bool emitMeshed);
+    QString initialMeshFileName() const;
+
+    // reuse of initial meshes (geometry and mesh parameters are unchanged)
+    QByteArray meshHash() const;
+    void storeMeshCache();
+    void restoreMeshCache();
+    void clearMeshCache();
     void solveInit(bool reCreateStructure = true);
     void solve(bool adaptiveStepOnly, bool commandLine);
     void solveAction(); // called by solve, can throw SolverException
+    void createBlockLevels();
+    // solves independent blocks concurrently, solutions are stored in the order of blocks
+    void solveBlocksConcurrently(const QList<Block *> &blocks, QMap<Block *, QSharedPointer<ProblemSolver<double> > > &solvers);
 
     void solveAdaptiveStepAction();
     void stepMessage(Block* block);
@@ -195,6 +222,8 @@ private:
     friend class AgrosSolver;
 
 private slots:
+    void updateFieldMetadata();
+
     void doMeshWithGUI();
     void doSolveWithGUI();
     void doSolveAdaptiveStepWithGUI();
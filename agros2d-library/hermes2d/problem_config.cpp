@@ -133,6 +133,8 @@ void ProblemConfig::setStringKeys()
     m_settingKey[TimeMethod] = "TimeMethod";
     m_settingKey[TimeMethodTolerance] = "TimeMethodTolerance";
     m_settingKey[TimeOrder] = "TimeOrder";
+    m_settingKey[TimeOrderVariable] = "TimeOrderVariable";
+    m_settingKey[TimeMethodErrorEstimate] = "TimeMethodErrorEstimate";
     m_settingKey[TimeConstantTimeSteps] = "TimeSteps";
     m_settingKey[TimeTotal] = "TimeTotal";
 }
@@ -145,6 +147,8 @@ void ProblemConfig::setDefaultValues()
     m_settingDefault[TimeMethod] = TimeStepMethod_BDFNumSteps;
     m_settingDefault[TimeMethodTolerance] = 0.05;
     m_settingDefault[TimeOrder] = 2;
+    m_settingDefault[TimeOrderVariable] = false;
+    m_settingDefault[TimeMethodErrorEstimate] = TimeErrorEstimate_Embedded;
     m_settingDefault[TimeConstantTimeSteps] = 10;
     m_settingDefault[TimeTotal] = 15000.0;
 }
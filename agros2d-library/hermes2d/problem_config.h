@@ -47,6 +47,8 @@ public:
         TimeMethod,
         TimeMethodTolerance,
         TimeOrder,
+        TimeOrderVariable,
+        TimeMethodErrorEstimate,
         TimeConstantTimeSteps,
         TimeTotal
     };
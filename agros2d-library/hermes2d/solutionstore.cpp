@@ -29,24 +29,317 @@
 #include "problem.h"
 #include "problem_config.h"
 
+#include "particle/mesh_hash.h"
+
 #include "../../resources_source/classes/structure_xml.h"
 
 using namespace Hermes::Hermes2D;
 
+// number of solutions waiting for the writer before addSolution blocks
+const int SOLUTION_STORE_QUEUE_SIZE = 4;
+
+static QString runTimeFileName()
+{
+    return QString("%1/runtime.xml").arg(cacheProblemDir());
+}
+
+static QString runTimeJournalFileName()
+{
+    return QString("%1/runtime.journal").arg(cacheProblemDir());
+}
+
+enum JournalRecord
+{
+    JournalRecord_Add = 1,
+    JournalRecord_Replace = 2,
+    JournalRecord_Remove = 3
+};
+
+static void writeJournalRecord(QDataStream &stream, JournalRecord type, FieldSolutionID solutionID,
+                               const SolutionStore::SolutionRunTimeDetails &runTime)
+{
+    stream << (quint8) type;
+    stream << solutionID.group->fieldId() << (qint32) solutionID.timeStep << (qint32) solutionID.adaptivityStep
+           << solutionTypeToStringKey(solutionID.solutionMode);
+
+    if (type == JournalRecord_Remove)
+        return;
+
+    stream << runTime.timeStepLength() << runTime.adaptivityError()
+           << (qint32) runTime.DOFs() << (qint32) runTime.jacobianCalculations();
+
+    stream << (qint32) runTime.fileNames().size();
+    foreach (SolutionStore::SolutionRunTimeDetails::FileName fileName, runTime.fileNames())
+        stream << fileName.meshFileName() << fileName.spaceFileName() << fileName.solutionFileName();
+
+    stream << runTime.newtonResidual() << runTime.nonlinearDamping();
+}
+
+static bool readJournalRecord(QDataStream &stream, JournalRecord &type, QString &fieldId, int &timeStep, int &adaptivityStep,
+                              QString &solutionType, SolutionStore::SolutionRunTimeDetails &runTime)
+{
+    quint8 recordType;
+    qint32 ts, as;
+    stream >> recordType >> fieldId >> ts >> as >> solutionType;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    type = (JournalRecord) recordType;
+    timeStep = ts;
+    adaptivityStep = as;
+
+    if (type == JournalRecord_Remove)
+        return true;
+
+    double timeStepLength, adaptivityError;
+    qint32 DOFs, jacobianCalculations, numFileNames;
+    stream >> timeStepLength >> adaptivityError >> DOFs >> jacobianCalculations >> numFileNames;
+
+    QList<SolutionStore::SolutionRunTimeDetails::FileName> fileNames;
+    for (int i = 0; i < numFileNames; i++)
+    {
+        QString meshFileName, spaceFileName, solutionFileName;
+        stream >> meshFileName >> spaceFileName >> solutionFileName;
+        fileNames.append(SolutionStore::SolutionRunTimeDetails::FileName(meshFileName, spaceFileName, solutionFileName));
+    }
+
+    QVector<double> newtonResidual, nonlinearDamping;
+    stream >> newtonResidual >> nonlinearDamping;
+
+    // truncated record (interrupted write)
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    runTime = SolutionStore::SolutionRunTimeDetails(timeStepLength, adaptivityError, DOFs);
+    runTime.setJacobianCalculations(jacobianCalculations);
+    runTime.setFileNames(fileNames);
+    runTime.setNewtonResidual(newtonResidual);
+    runTime.setNonlinearDamping(nonlinearDamping);
+
+    return true;
+}
+
+// background thread writing solution files and run time journal records in order of arrival
+class SolutionStoreWriter : public QThread
+{
+public:
+    struct Task
+    {
+        JournalRecord type;
+        FieldSolutionID solutionID;
+        SolutionStore::SolutionRunTimeDetails runTime;
+
+        // solution returned by the store until it is written
+        MultiArray<double> multiSolution;
+
+        // files to be written (empty file name means already stored)
+        // deep copies, the solver keeps changing the stored spaces and meshes
+        QList<Hermes::vector<MeshSharedPtr> > meshes;
+        Hermes::vector<SpaceSharedPtr<double> > spaces;
+        Hermes::vector<MeshFunctionSharedPtr<double> > solutions;
+        QStringList meshFileNames;
+        QStringList spaceFileNames;
+        QStringList solutionFileNames;
+    };
+
+    SolutionStoreWriter() : QThread(), m_stop(false), m_busy(false) {}
+
+    ~SolutionStoreWriter()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stop = true;
+            m_queueNotEmpty.wakeAll();
+        }
+
+        wait();
+    }
+
+    void enqueue(const Task &task)
+    {
+        if (!isRunning())
+            start(QThread::LowPriority);
+
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.size() >= SOLUTION_STORE_QUEUE_SIZE)
+            m_queueNotFull.wait(&m_mutex);
+
+        m_queue.enqueue(task);
+        if (task.type == JournalRecord_Add)
+            m_pending.insert(task.solutionID, task.multiSolution);
+
+        m_queueNotEmpty.wakeOne();
+    }
+
+    // solution not written yet
+    bool pending(FieldSolutionID solutionID, MultiArray<double> &multiSolution)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_pending.contains(solutionID))
+            return false;
+
+        multiSolution = m_pending[solutionID];
+        return true;
+    }
+
+    bool isPending(FieldSolutionID solutionID)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_pending.contains(solutionID);
+    }
+
+    // blocks until all queued tasks are written
+    void waitForFinished()
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_queue.isEmpty() || m_busy)
+            m_idle.wait(&m_mutex);
+    }
+
+protected:
+    virtual void run()
+    {
+        forever
+        {
+            Task task;
+            {
+                QMutexLocker locker(&m_mutex);
+                while (m_queue.isEmpty() && !m_stop)
+                    m_queueNotEmpty.wait(&m_mutex);
+
+                if (m_queue.isEmpty() && m_stop)
+                    return;
+
+                task = m_queue.dequeue();
+                m_busy = true;
+                m_queueNotFull.wakeOne();
+            }
+
+            process(task);
+
+            {
+                QMutexLocker locker(&m_mutex);
+                if (task.type == JournalRecord_Add)
+                    m_pending.remove(task.solutionID);
+
+                m_busy = false;
+                if (m_queue.isEmpty())
+                    m_idle.wakeAll();
+            }
+        }
+    }
+
+private:
+    QQueue<Task> m_queue;
+    QMap<FieldSolutionID, MultiArray<double> > m_pending;
+
+    QMutex m_mutex;
+    QWaitCondition m_queueNotEmpty;
+    QWaitCondition m_queueNotFull;
+    QWaitCondition m_idle;
+
+    bool m_stop;
+    bool m_busy;
+
+    void process(Task &task)
+    {
+        try
+        {
+            for (int i = 0; i < task.meshFileNames.size(); i++)
+            {
+                // meshes
+                if (!task.meshFileNames[i].isEmpty())
+                    Module::writeMeshToFileBSON(task.meshFileNames[i], task.meshes[i]);
+
+                // spaces
+                if (!task.spaceFileNames[i].isEmpty())
+                    task.spaces.at(i)->save_bson(compatibleFilename(task.spaceFileNames[i]).toStdString().c_str());
+
+                // solutions
+                if (!task.solutionFileNames[i].isEmpty())
+                    dynamic_cast<Hermes::Hermes2D::Solution<double> *>(task.solutions.at(i).get())->save_bson(compatibleFilename(task.solutionFileNames[i]).toStdString().c_str());
+            }
+        }
+        catch (Hermes::Exceptions::Exception &e)
+        {
+            std::cerr << "Solution store: " << e.what() << std::endl;
+        }
+
+        // the journal record is written after all files of the solution
+        QFile file(runTimeJournalFileName());
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append))
+        {
+            QDataStream stream(&file);
+            stream.setVersion(QDataStream::Qt_4_8);
+            writeJournalRecord(stream, task.type, task.solutionID, task.runTime);
+            file.close();
+        }
+    }
+};
+
+SolutionStore::SolutionStore() : m_cacheMemory(0), m_cacheUseSequence(0), m_writer(new SolutionStoreWriter()), m_cacheMutex(QMutex::Recursive)
+{
+    resetCacheStatistics();
+}
+
+SolutionStore::~SolutionStore()
+{
+    clearAll();
+
+    delete m_writer;
+}
+
+void SolutionStore::resetCacheStatistics()
+{
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_cacheEvictions = 0;
+}
+
 void SolutionStore::printDebugCacheStatus()
 {
     assert(m_multiSolutionCacheIDOrder.size() == m_multiSolutionCache.keys().size());
     qDebug() << "solution store cache status:";
+    qDebug() << "memory:" << m_cacheMemory / 1024 / 1024 << "MB of" << Agros2D::configComputer()->cacheSize << "MB,"
+             << "hits:" << m_cacheHits << ", misses:" << m_cacheMisses << ", evictions:" << m_cacheEvictions;
     foreach(FieldSolutionID fsid, m_multiSolutionCacheIDOrder)
     {
         assert(m_multiSolutionCache.keys().contains(fsid));
-        qDebug() << fsid.toString();
+        qDebug() << fsid.toString() << m_multiSolutionCacheMemory[fsid] / 1024 << "kB";
     }
 }
 
-SolutionStore::~SolutionStore()
+qint64 SolutionStore::multiArrayMemory(MultiArray<double> multiArray)
 {
-    clearAll();
+    qint64 memory = 0;
+
+    for (int comp = 0; comp < multiArray.size(); comp++)
+    {
+        SpaceSharedPtr<double> space = multiArray.spaces().at(comp);
+        MeshSharedPtr mesh = space->get_mesh();
+
+        // mesh
+        memory += (qint64) mesh->get_max_node_id() * sizeof(Node);
+        memory += (qint64) mesh->get_max_element_id() * sizeof(Element);
+
+        // space (element data and dof assignment)
+        memory += (qint64) space->get_num_dofs() * (sizeof(int) + sizeof(double));
+
+        // solution (monomial coefficients)
+        Element *e;
+        for_all_active_elements(e, mesh)
+        {
+            int order = space->get_element_order(e->id);
+            int orderH = H2D_GET_H_ORDER(order);
+            int orderV = H2D_GET_V_ORDER(order);
+            if (e->is_triangle())
+                memory += (qint64) (orderH + 1) * (orderH + 2) / 2 * sizeof(double);
+            else
+                memory += (qint64) (orderH + 1) * (orderV + 1) * sizeof(double);
+        }
+    }
+
+    return memory;
 }
 
 QString SolutionStore::baseStoreFileName(FieldSolutionID solutionID) const
@@ -60,29 +353,72 @@ QString SolutionStore::baseStoreFileName(FieldSolutionID solutionID) const
 
 void SolutionStore::clearAll()
 {
+    // files of all solutions have to be written before removing
+    m_writer->waitForFinished();
+
     // m_multiSolutions.clear();
     foreach (FieldSolutionID sid, m_multiSolutions)
         removeSolution(sid);
 
     assert(m_multiSolutions.isEmpty());
     assert(m_multiSolutionRunTimeDetails.isEmpty());
+    assert(m_multiSolutionIndex.isEmpty());
     assert(m_multiSolutionCache.isEmpty());
+    assert(m_cacheMemory == 0);
+
+    m_writer->waitForFinished();
+    if (QFile::exists(runTimeJournalFileName()))
+        QFile::remove(runTimeJournalFileName());
+
+    resetCacheStatistics();
 }
 
-MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
+void SolutionStore::flush()
+{
+    m_writer->waitForFinished();
+
+    if (QFile::exists(runTimeJournalFileName()))
+    {
+        // compact journal
+        saveRunTimeDetails();
+        QFile::remove(runTimeJournalFileName());
+    }
+}
+
+FieldSolutionID SolutionStore::storedSolutionID(FieldSolutionID solutionID) const
 {
     if(solutionID.solutionMode == SolutionMode_Finer)
     {
         solutionID.solutionMode = SolutionMode_Reference;
-        if(!m_multiSolutions.contains(solutionID))
+        if(!contains(solutionID))
             solutionID.solutionMode = SolutionMode_Normal;
     }
 
-    assert(m_multiSolutions.contains(solutionID));
+    return solutionID;
+}
+
+MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    solutionID = storedSolutionID(solutionID);
+
+    assert(contains(solutionID));
+
+    // solution has been evicted but its files are still being written
+    MultiArray<double> msaPending;
+    if (!m_multiSolutionCache.contains(solutionID) && m_writer->pending(solutionID, msaPending))
+    {
+        m_cacheHits++;
+        insertMultiSolutionToCache(solutionID, msaPending);
+
+        return msaPending;
+    }
 
     if (!m_multiSolutionCache.contains(solutionID))
     {
         //qDebug() << "Read from disk: " << solutionID.toString();
+        m_cacheMisses++;
 
         FieldInfo *fieldInfo = solutionID.group;
         Block *block = Agros2D::problem()->blockOfField(fieldInfo);
@@ -172,13 +508,53 @@ MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
     }
     else
     {
+        m_cacheHits++;
+
+        touchMultiSolutionInCache(solutionID);
+
         return m_multiSolutionCache[solutionID];
     }
 }
 
 bool SolutionStore::contains(FieldSolutionID solutionID) const
 {
-    return m_multiSolutions.contains(solutionID);
+    return m_multiSolutionRunTimeDetails.contains(solutionID);
+}
+
+QSharedPointer<MeshHash> SolutionStore::meshHash(FieldSolutionID solutionID)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    solutionID = storedSolutionID(solutionID);
+
+    // load solution to the cache (mesh hash lives as long as the cached solution)
+    MultiArray<double> ma = multiArray(solutionID);
+
+    if (!m_meshHashCache.contains(solutionID))
+        m_meshHashCache.insert(solutionID, QSharedPointer<MeshHash>(new MeshHash(ma.solutions().at(0)->get_mesh())));
+
+    return m_meshHashCache[solutionID];
+}
+
+Hermes::Hermes2D::MeshSharedPtr SolutionStore::eggShellMesh(FieldSolutionID solutionID, const Hermes::vector<std::string> &markers)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    solutionID = storedSolutionID(solutionID);
+
+    // load solution to the cache (egg-shell lives as long as the cached solution)
+    MultiArray<double> ma = multiArray(solutionID);
+
+    QStringList keys;
+    for (int i = 0; i < markers.size(); i++)
+        keys.append(QString::fromStdString(markers.at(i)));
+    QString key = keys.join(",");
+
+    QMap<QString, Hermes::Hermes2D::MeshSharedPtr> &eggShells = m_eggShellCache[solutionID];
+    if (!eggShells.contains(key))
+        eggShells.insert(key, Hermes::Hermes2D::EggShell::get_egg_shell(ma.solutions().at(0)->get_mesh(), markers, 3));
+
+    return eggShells[key];
 }
 
 MultiArray<double> SolutionStore::multiArray(BlockSolutionID solutionID)
@@ -195,8 +571,10 @@ MultiArray<double> SolutionStore::multiArray(BlockSolutionID solutionID)
 
 void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> multiSolution, SolutionRunTimeDetails runTime)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     // qDebug() << "saving solution " << solutionID;
-    assert(!m_multiSolutions.contains(solutionID));
+    assert(!contains(solutionID));
     assert(solutionID.timeStep >= 0);
     assert(solutionID.adaptivityStep >= 0);
 
@@ -222,16 +600,32 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
         }
     }
 
-    // meshes
+    SolutionStoreWriter::Task task;
+    task.type = JournalRecord_Add;
+    task.solutionID = solutionID;
+    task.multiSolution = multiSolution;
+
     for (int i = 0; i < multiSolution.size(); i++)
     {
+        // deep copy for the writer
+        Hermes::Hermes2D::MeshSharedPtr mesh(new Hermes::Hermes2D::Mesh());
+        mesh->copy(multiSolution.spaces().at(i)->get_mesh());
+
+        Hermes::Hermes2D::Space<double>::ReferenceSpaceCreator spaceCreator(multiSolution.spaces().at(i), mesh, 0);
+        task.spaces.push_back(spaceCreator.create_ref_space());
+
+        Hermes::Hermes2D::Solution<double> *solution = new Hermes::Hermes2D::Solution<double>();
+        solution->copy(multiSolution.solutions().at(i).get());
+        task.solutions.push_back(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(solution));
+
+        // meshes
+        Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes;
         if (fileNames[i].meshFileName().isEmpty())
         {
-            Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes;
             foreach(FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
             {
                 if (fieldInfo == solutionID.group)
-                    meshes.push_back(multiSolution.spaces().at(i)->get_mesh());
+                    meshes.push_back(mesh);
                 else
                     meshes.push_back(fieldInfo->initialMesh());
             }
@@ -239,45 +633,42 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
             // QString meshFN = QString("%1_%2.msh").arg(baseFN).arg(i);
             // Module::writeMeshToFileXML(meshFN, meshes);
             QString meshFN = QString("%1_%2.mbs").arg(baseFN).arg(i);
-            Module::writeMeshToFileBSON(meshFN, meshes);
+            task.meshFileNames.append(meshFN);
 
             fileNames[i].setMeshFileName(QFileInfo(meshFN).fileName());
         }
-    }
+        else
+        {
+            task.meshFileNames.append(QString());
+        }
+        task.meshes.append(meshes);
 
-    // spaces
-    for (int i = 0; i < multiSolution.size(); i++)
-    {
+        // spaces
         if (fileNames[i].spaceFileName().isEmpty())
         {
             QString spaceFN = QString("%1_%2.spc").arg(baseFN).arg(i);
-            // multiSolution.spaces().at(i)->save(compatibleFilename(spaceFN).toStdString().c_str());
-            multiSolution.spaces().at(i)->save_bson(compatibleFilename(spaceFN).toStdString().c_str());
+            task.spaceFileNames.append(spaceFN);
 
             fileNames[i].setSpaceFileName(QFileInfo(spaceFN).fileName());
         }
-    }
-
-    // solutions
-    for (int i = 0; i < multiSolution.size(); i++)
-    {
-        if (fileNames[i].solutionFileName().isEmpty())
+        else
         {
-            QString solutionFN = QString("%1_%2.sln").arg(baseFN).arg(i);
-            // QTime time;
-            // time.start();
-            // dynamic_cast<Hermes::Hermes2D::Solution<double> *>(multiSolution.solutions().at(i).get())->save(solutionFN.toLatin1().data());
-            dynamic_cast<Hermes::Hermes2D::Solution<double> *>(multiSolution.solutions().at(i).get())->save_bson(compatibleFilename(solutionFN).toStdString().c_str());
-            // qDebug() << "SAVE" << time.elapsed();
-
-            fileNames[i].setSolutionFileName(QFileInfo(solutionFN).fileName());
+            task.spaceFileNames.append(QString());
         }
+
+        // solutions
+        QString solutionFN = QString("%1_%2.sln").arg(baseFN).arg(i);
+        task.solutionFileNames.append(solutionFN);
+
+        fileNames[i].setSolutionFileName(QFileInfo(solutionFN).fileName());
     }
 
     runTime.setFileNames(fileNames);
+    task.runTime = runTime;
 
     // append multisolution
     m_multiSolutions.append(solutionID);
+    insertSolutionToIndex(solutionID);
 
     // append properties
     m_multiSolutionRunTimeDetails.insert(solutionID, runTime);
@@ -287,8 +678,8 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
     //printDebugCacheStatus();
 
-    // save run time details to the file
-    saveRunTimeDetails();
+    // write files and run time details in background (solution stays available in memory until written)
+    m_writer->enqueue(task);
 
     // save to the memory info (for debug purposes)
     // m_memoryInfos[solutionID] = tr1::shared_ptr<MemoryInfo>(new MemoryInfo(multiSolution));
@@ -296,20 +687,20 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
 void SolutionStore::removeSolution(FieldSolutionID solutionID)
 {
-    assert(m_multiSolutions.contains(solutionID));
+    assert(contains(solutionID));
+
+    // files cannot be removed before they are written
+    if (m_writer->isPending(solutionID))
+        m_writer->waitForFinished();
 
     // remove from list
     m_multiSolutions.removeOne(solutionID);
+    removeSolutionFromIndex(solutionID);
     // remove properties
     m_multiSolutionRunTimeDetails.remove(solutionID);
     // remove from cache
     if (m_multiSolutionCache.contains(solutionID))
-    {
-        // free ma
-        m_multiSolutionCache[solutionID].clear();
-        m_multiSolutionCache.remove(solutionID);
-        m_multiSolutionCacheIDOrder.removeOne(solutionID);
-    }
+        removeMultiSolutionFromCache(solutionID);
 
     // remove old files
     QFileInfo info(Agros2D::problem()->config()->fileName());
@@ -333,8 +724,11 @@ void SolutionStore::removeSolution(FieldSolutionID solutionID)
         }
     }
 
-    // save structure to the file
-    saveRunTimeDetails();
+    // append to the run time journal
+    SolutionStoreWriter::Task task;
+    task.type = JournalRecord_Remove;
+    task.solutionID = solutionID;
+    m_writer->enqueue(task);
 }
 
 void SolutionStore::addSolution(BlockSolutionID blockSolutionID, MultiArray<double> multiSolution, SolutionRunTimeDetails runTime)
@@ -368,16 +762,45 @@ void SolutionStore::removeTimeStep(int timeStep)
 
 }
 
+void SolutionStore::insertSolutionToIndex(FieldSolutionID solutionID)
+{
+    m_multiSolutionIndex[qMakePair((const FieldInfo *) solutionID.group, solutionID.solutionMode)].insert(qMakePair(solutionID.timeStep, solutionID.adaptivityStep));
+    m_multiSolutionTimeSteps[solutionID.group][solutionID.timeStep]++;
+}
+
+void SolutionStore::removeSolutionFromIndex(FieldSolutionID solutionID)
+{
+    QPair<const FieldInfo *, SolutionMode> key = qMakePair((const FieldInfo *) solutionID.group, solutionID.solutionMode);
+    assert(m_multiSolutionIndex.contains(key));
+
+    m_multiSolutionIndex[key].erase(qMakePair(solutionID.timeStep, solutionID.adaptivityStep));
+    if (m_multiSolutionIndex[key].empty())
+        m_multiSolutionIndex.remove(key);
+
+    QMap<int, int> &timeSteps = m_multiSolutionTimeSteps[solutionID.group];
+    assert(timeSteps.contains(solutionID.timeStep));
+    if (--timeSteps[solutionID.timeStep] == 0)
+        timeSteps.remove(solutionID.timeStep);
+    if (timeSteps.isEmpty())
+        m_multiSolutionTimeSteps.remove(solutionID.group);
+}
+
+const SolutionStore::SolutionIndex *SolutionStore::solutionIndex(const FieldInfo *fieldInfo, SolutionMode solutionType) const
+{
+    QMap<QPair<const FieldInfo *, SolutionMode>, SolutionIndex>::const_iterator it = m_multiSolutionIndex.find(qMakePair(fieldInfo, solutionType));
+    if (it == m_multiSolutionIndex.end())
+        return NULL;
+
+    return &it.value();
+}
+
 int SolutionStore::lastTimeStep(const FieldInfo *fieldInfo, SolutionMode solutionType) const
 {
-    int timeStep = NOT_FOUND_SO_FAR;
-    foreach (FieldSolutionID sid, m_multiSolutions)
-    {
-        if((sid.group == fieldInfo) && (sid.solutionMode == solutionType) && (sid.timeStep > timeStep))
-            timeStep = sid.timeStep;
-    }
+    const SolutionIndex *index = solutionIndex(fieldInfo, solutionType);
+    if (!index)
+        return NOT_FOUND_SO_FAR;
 
-    return timeStep;
+    return index->rbegin()->first;
 }
 
 int SolutionStore::lastTimeStep(Block *block, SolutionMode solutionType) const
@@ -409,50 +832,55 @@ MultiArray<double> SolutionStore::multiSolutionPreviousCalculatedTS(BlockSolutio
 
 int SolutionStore::nthCalculatedTimeStep(FieldInfo* fieldInfo, int n) const
 {
+    const SolutionIndex *index = solutionIndex(fieldInfo, SolutionMode_Normal);
+    assert(index);
+
     int count = 0;
-    for(int step = 0; step <= lastTimeStep(fieldInfo, SolutionMode_Normal); step++)
+    for (SolutionIndex::const_iterator it = index->begin(); it != index->end(); ++it)
     {
-        if(this->contains(FieldSolutionID(fieldInfo, step, 0, SolutionMode_Normal)))
-            count++;
+        if (it->second != 0)
+            continue;
 
         // n is counted from zero
-        if(count == n + 1)
-            return step;
+        if (count == n)
+            return it->first;
+
+        count++;
     }
 
     assert(0);
+    return NOT_FOUND_SO_FAR;
 }
 
-
 int SolutionStore::nearestTimeStep(FieldInfo *fieldInfo, int timeStep) const
 {
-    int ts = timeStep;
-    while (!this->contains(FieldSolutionID(fieldInfo, ts, 0, SolutionMode_Normal)))
+    const SolutionIndex *index = solutionIndex(fieldInfo, SolutionMode_Normal);
+    if (!index)
+        return 0;
+
+    // last stored step not greater than timeStep
+    SolutionIndex::const_iterator it = index->upper_bound(qMakePair(timeStep, std::numeric_limits<int>::max()));
+    while (it != index->begin())
     {
-        ts--;
-        if (ts <= 0)
+        --it;
+        if (it->first <= 0)
             return 0;
+
+        // the first adaptivity step of this time step
+        it = index->lower_bound(qMakePair(it->first, 0));
+        if (it->second == 0)
+            return it->first;
     }
-    return ts;
+
+    return 0;
 }
 
 double SolutionStore::lastTime(FieldInfo *fieldInfo)
 {
     int timeStep = lastTimeStep(fieldInfo, SolutionMode_Normal);
-    double time = NOT_FOUND_SO_FAR;
+    assert(timeStep != NOT_FOUND_SO_FAR);
 
-    foreach (FieldSolutionID id, m_multiSolutions)
-    {
-        if ((id.group == fieldInfo) && (id.timeStep == timeStep))
-        {
-            if (time == NOT_FOUND_SO_FAR)
-                time = Agros2D::problem()->timeStepToTotalTime(id.timeStep);
-            else
-                assert(time == Agros2D::problem()->timeStepToTotalTime(id.timeStep));
-        }
-    }
-    assert(time != NOT_FOUND_SO_FAR);
-    return time;
+    return Agros2D::problem()->timeStepToTotalTime(timeStep);
 }
 
 double SolutionStore::lastTime(Block *block)
@@ -473,14 +901,19 @@ int SolutionStore::lastAdaptiveStep(FieldInfo *fieldInfo, SolutionMode solutionT
     if (timeStep == -1)
         timeStep = lastTimeStep(fieldInfo, solutionType);
 
-    int adaptiveStep = NOT_FOUND_SO_FAR;
-    foreach (FieldSolutionID sid, m_multiSolutions)
-    {
-        if ((sid.group == fieldInfo) && (sid.solutionMode == solutionType) && (sid.timeStep == timeStep) && (sid.adaptivityStep > adaptiveStep))
-            adaptiveStep = sid.adaptivityStep;
-    }
+    const SolutionIndex *index = solutionIndex(fieldInfo, solutionType);
+    if (!index)
+        return NOT_FOUND_SO_FAR;
 
-    return adaptiveStep;
+    SolutionIndex::const_iterator it = index->upper_bound(qMakePair(timeStep, std::numeric_limits<int>::max()));
+    if (it == index->begin())
+        return NOT_FOUND_SO_FAR;
+
+    --it;
+    if (it->first != timeStep)
+        return NOT_FOUND_SO_FAR;
+
+    return it->second;
 }
 
 int SolutionStore::lastAdaptiveStep(Block *block, SolutionMode solutionType, int timeStep)
@@ -540,31 +973,20 @@ QList<double> SolutionStore::timeLevels(const FieldInfo *fieldInfo)
 {
     QList<double> list;
 
-    foreach(FieldSolutionID fsid, m_multiSolutions)
-    {
-        if (fsid.group == fieldInfo)
-        {
-            double time = Agros2D::problem()->timeStepToTotalTime(fsid.timeStep);
-            if (!list.contains(time))
-                list.push_back(time);
-        }
-    }
+    // time steps are sorted, so are the time levels
+    foreach (int timeStep, m_multiSolutionTimeSteps.value(fieldInfo).keys())
+        list.append(Agros2D::problem()->timeStepToTotalTime(timeStep));
 
     return list;
 }
 
 int SolutionStore::timeLevelIndex(FieldInfo *fieldInfo, double time)
 {
-    int level = -1;
     QList<double> levels = timeLevels(fieldInfo);
-    if(levels.isEmpty())
+    if (levels.isEmpty())
         return 0;
 
-    foreach(double timeLevel, levels)
-    {
-        if(timeLevel <= time)
-            level++;
-    }
+    int level = qUpperBound(levels, time) - levels.begin() - 1;
     assert(level >= 0);
     return level;
 }
@@ -574,33 +996,67 @@ double SolutionStore::timeLevel(FieldInfo *fieldInfo, int timeLevelIndex)
     QList<double> levels = timeLevels(fieldInfo);
     if (timeLevelIndex >= 0 && timeLevelIndex < levels.count())
         return levels.at(timeLevelIndex);
+
+    return 0.0;
 }
 
 void SolutionStore::insertMultiSolutionToCache(FieldSolutionID solutionID, MultiArray<double> multiSolution)
 {
     if (!m_multiSolutionCache.contains(solutionID))
     {
-        // flush cache
-        if (m_multiSolutionCache.count() > Agros2D::configComputer()->cacheSize)
-        {
-            assert(! m_multiSolutionCacheIDOrder.empty());
-            FieldSolutionID idRemove = m_multiSolutionCacheIDOrder[0];
-            m_multiSolutionCacheIDOrder.removeFirst();
+        qint64 memory = multiArrayMemory(multiSolution);
+        qint64 memoryLimit = (qint64) Agros2D::configComputer()->cacheSize * 1024 * 1024;
 
-            // free ma
-            m_multiSolutionCache[idRemove].clear();
-            m_multiSolutionCache.remove(idRemove);
+        // flush least recently used solutions (keep at least the inserted one)
+        while (!m_multiSolutionCacheIDOrder.isEmpty() && (m_cacheMemory + memory > memoryLimit))
+        {
+            removeMultiSolutionFromCache(m_multiSolutionCacheIDOrder.begin().value());
+            m_cacheEvictions++;
         }
 
         // add solution
         m_multiSolutionCache.insert(solutionID, multiSolution);
-        m_multiSolutionCacheIDOrder.append(solutionID);
+        m_multiSolutionCacheMemory.insert(solutionID, memory);
+        m_cacheMemory += memory;
+
+        touchMultiSolutionInCache(solutionID);
     }
 }
 
+void SolutionStore::touchMultiSolutionInCache(FieldSolutionID solutionID)
+{
+    if (m_multiSolutionCacheLastUse.contains(solutionID))
+        m_multiSolutionCacheIDOrder.remove(m_multiSolutionCacheLastUse[solutionID]);
+
+    m_cacheUseSequence++;
+    m_multiSolutionCacheIDOrder.insert(m_cacheUseSequence, solutionID);
+    m_multiSolutionCacheLastUse[solutionID] = m_cacheUseSequence;
+}
+
+void SolutionStore::removeMultiSolutionFromCache(FieldSolutionID solutionID)
+{
+    assert(m_multiSolutionCache.contains(solutionID));
+
+    // free ma
+    m_multiSolutionCache[solutionID].clear();
+    m_multiSolutionCache.remove(solutionID);
+    m_meshHashCache.remove(solutionID);
+    m_eggShellCache.remove(solutionID);
+    m_multiSolutionCacheIDOrder.remove(m_multiSolutionCacheLastUse[solutionID]);
+    m_multiSolutionCacheLastUse.remove(solutionID);
+
+    m_cacheMemory -= m_multiSolutionCacheMemory[solutionID];
+    m_multiSolutionCacheMemory.remove(solutionID);
+}
+
 void SolutionStore::loadRunTimeDetails()
 {
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    QString fn = runTimeFileName();
+    if (!QFile::exists(fn))
+    {
+        loadRunTimeJournal();
+        return;
+    }
 
     try
     {
@@ -622,6 +1078,7 @@ void SolutionStore::loadRunTimeDetails()
                                        solutionTypeFromStringKey(QString::fromStdString(data.solution_type())));
             // append multisolution
             m_multiSolutions.append(solutionID);
+            insertSolutionToIndex(solutionID);
 
             // TODO: remove "problem time step structures"
             // define transient time step
@@ -657,11 +1114,75 @@ void SolutionStore::loadRunTimeDetails()
     {
         std::cerr << e << std::endl;
     }
+
+    // records written after the last compaction
+    loadRunTimeJournal();
+}
+
+void SolutionStore::loadRunTimeJournal()
+{
+    QFile file(runTimeJournalFileName());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_8);
+    while (!stream.atEnd())
+    {
+        JournalRecord type;
+        QString fieldId;
+        QString solutionType;
+        int timeStep, adaptivityStep;
+        SolutionRunTimeDetails runTime;
+
+        if (!readJournalRecord(stream, type, fieldId, timeStep, adaptivityStep, solutionType, runTime))
+            break;
+
+        // check field
+        if (!Agros2D::problem()->hasField(fieldId))
+            throw AgrosException(QObject::tr("Field '%1' info mismatch.").arg(fieldId));
+
+        FieldSolutionID solutionID(Agros2D::problem()->fieldInfo(fieldId), timeStep, adaptivityStep, solutionTypeFromStringKey(solutionType));
+
+        switch (type)
+        {
+        case JournalRecord_Add:
+        {
+            if (contains(solutionID))
+                break;
+
+            m_multiSolutions.append(solutionID);
+            insertSolutionToIndex(solutionID);
+
+            if (timeStep > Agros2D::problem()->actualTimeStep())
+                Agros2D::problem()->defineActualTimeStepLength(runTime.timeStepLength());
+
+            m_multiSolutionRunTimeDetails.insert(solutionID, runTime);
+        }
+            break;
+        case JournalRecord_Replace:
+        {
+            if (contains(solutionID))
+                m_multiSolutionRunTimeDetails[solutionID] = runTime;
+        }
+            break;
+        case JournalRecord_Remove:
+        {
+            if (contains(solutionID))
+            {
+                m_multiSolutions.removeOne(solutionID);
+                removeSolutionFromIndex(solutionID);
+                m_multiSolutionRunTimeDetails.remove(solutionID);
+            }
+        }
+            break;
+        }
+    }
 }
 
 void SolutionStore::saveRunTimeDetails()
 {
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    QString fn = runTimeFileName();
 
     try
     {
@@ -731,7 +1252,11 @@ void SolutionStore::multiSolutionRunTimeDetailReplace(FieldSolutionID solutionID
     assert(m_multiSolutionRunTimeDetails.contains(solutionID));
     m_multiSolutionRunTimeDetails[solutionID] = runTime;
 
-    // save structure to the file
-    saveRunTimeDetails();
+    // append to the run time journal
+    SolutionStoreWriter::Task task;
+    task.type = JournalRecord_Replace;
+    task.solutionID = solutionID;
+    task.runTime = runTime;
+    m_writer->enqueue(task);
 }
 
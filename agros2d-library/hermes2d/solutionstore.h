@@ -22,9 +22,15 @@
 
 #include "solutiontypes.h"
 
+#include <set>
+
+class SolutionStoreWriter;
+class MeshHash;
+
 class AGROS_LIBRARY_API SolutionStore
 {
 public:
+    SolutionStore();
     ~SolutionStore();
 
     class SolutionRunTimeDetails
@@ -82,6 +88,11 @@ public:
     MultiArray<double> multiArray(FieldSolutionID solutionID);
     MultiArray<double> multiArray(BlockSolutionID solutionID);
 
+    // point location on the solution mesh (cached and invalidated with the solution)
+    QSharedPointer<MeshHash> meshHash(FieldSolutionID solutionID);
+    // egg-shell around the given element markers (cached and invalidated with the solution)
+    Hermes::Hermes2D::MeshSharedPtr eggShellMesh(FieldSolutionID solutionID, const Hermes::vector<std::string> &markers);
+
     // returns MultiSolution with components related to last time step, in which was each respective field calculated
     // this time step can be different for respective fields due to time step skipping
     // intented to be used as initial condition for the newton method
@@ -120,28 +131,83 @@ public:
 
     void loadRunTimeDetails();
 
+    // waits for the background writer and compacts the run time journal into runtime.xml
+    void flush();
+
     SolutionRunTimeDetails multiSolutionRunTimeDetail(FieldSolutionID solutionID) const { assert(m_multiSolutionRunTimeDetails.contains(solutionID)); return m_multiSolutionRunTimeDetails[solutionID]; }
     void multiSolutionRunTimeDetailReplace(FieldSolutionID solutionID, SolutionRunTimeDetails runTime);
 
     inline bool isEmpty() const { return m_multiSolutions.isEmpty(); }
     void clearAll();
 
+    // cache statistics
+    inline int cacheHits() const { return m_cacheHits; }
+    inline int cacheMisses() const { return m_cacheMisses; }
+    inline int cacheEvictions() const { return m_cacheEvictions; }
+    inline int cacheCount() const { return m_multiSolutionCache.count(); }
+    // memory occupied by cached solutions (in bytes)
+    inline qint64 cacheMemory() const { return m_cacheMemory; }
+    void resetCacheStatistics();
+
     void printDebugCacheStatus();
 
+    // estimated memory footprint of meshes, spaces and solution coefficients (in bytes)
+    static qint64 multiArrayMemory(MultiArray<double> multiArray);
+
 private:
+    // sorted (time step, adaptivity step) pairs of one field and solution mode
+    typedef std::set<QPair<int, int> > SolutionIndex;
+
     QList<FieldSolutionID> m_multiSolutions;
     QMap<FieldSolutionID, SolutionRunTimeDetails> m_multiSolutionRunTimeDetails;
+
+    // index of stored solutions for each field and solution mode
+    QMap<QPair<const FieldInfo *, SolutionMode>, SolutionIndex> m_multiSolutionIndex;
+    // number of stored solutions in each time step (all modes) for each field
+    QMap<const FieldInfo *, QMap<int, int> > m_multiSolutionTimeSteps;
+
+    // LRU cache (least recently used solution is first in m_multiSolutionCacheIDOrder)
     QMap<FieldSolutionID, MultiArray<double> > m_multiSolutionCache;
-    QList<FieldSolutionID> m_multiSolutionCacheIDOrder;
+    QMap<FieldSolutionID, qint64> m_multiSolutionCacheMemory;
+    // order of use (sequence number of the last use -> solution)
+    QMap<qint64, FieldSolutionID> m_multiSolutionCacheIDOrder;
+    QMap<FieldSolutionID, qint64> m_multiSolutionCacheLastUse;
+    qint64 m_cacheUseSequence;
+    qint64 m_cacheMemory;
+    // point location of cached solutions
+    QMap<FieldSolutionID, QSharedPointer<MeshHash> > m_meshHashCache;
+    // egg-shell meshes of cached solutions (by joined element markers)
+    QMap<FieldSolutionID, QMap<QString, Hermes::Hermes2D::MeshSharedPtr> > m_eggShellCache;
+
+    int m_cacheHits;
+    int m_cacheMisses;
+    int m_cacheEvictions;
 
     void addSolution(FieldSolutionID solutionID, MultiArray<double> multiArray, SolutionRunTimeDetails runTime);
     void removeSolution(FieldSolutionID solutionID);
 
+    void insertSolutionToIndex(FieldSolutionID solutionID);
+    void removeSolutionFromIndex(FieldSolutionID solutionID);
+    const SolutionIndex *solutionIndex(const FieldInfo *fieldInfo, SolutionMode solutionType) const;
+
+    // finer solution is stored as reference (if exists) or normal solution
+    FieldSolutionID storedSolutionID(FieldSolutionID solutionID) const;
+
     void insertMultiSolutionToCache(FieldSolutionID solutionID, MultiArray<double> multiArray);
+    // promote to the most recently used
+    void touchMultiSolutionInCache(FieldSolutionID solutionID);
+    void removeMultiSolutionFromCache(FieldSolutionID solutionID);
 
     QString baseStoreFileName(FieldSolutionID solutionID) const;
 
+    // write-behind of solution files and run time journal
+    SolutionStoreWriter *m_writer;
+
+    // cache is shared by concurrently solved independent blocks
+    QMutex m_cacheMutex;
+
     void saveRunTimeDetails();
+    void loadRunTimeJournal();
 };
 
 #endif // SOLUTIONSTORE_H
@@ -434,24 +434,30 @@ Scalar *ProblemSolver<Scalar>::solveOneProblem(Hermes::vector<Hermes::Hermes2D::
     if (initialSolutionVector)
         delete [] initialSolutionVector;
 
+    return m_hermesSolverContainer->slnVector();
+}
+
+template <typename Scalar>
+void ProblemSolver<Scalar>::printLinearSolverStatistics()
+{
     // linear solver statistics
-    if (LoopSolver<Scalar> *iterLinearSolver = dynamic_cast<LoopSolver<Scalar> *>(linearSolver))
+    if (LoopSolver<Scalar> *iterLinearSolver = dynamic_cast<LoopSolver<Scalar> *>(m_hermesSolverContainer->linearSolver()))
         Agros2D::log()->printDebug(QObject::tr("Solver"),
                                    QObject::tr("Iterative solver statistics: %1 iterations")
                                    .arg(iterLinearSolver->get_num_iters()));
-
-    return m_hermesSolverContainer->slnVector();
 }
 
 template <typename Scalar>
 void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
 {
-    // to be used as starting vector for the Newton solver
-    MultiArray<Scalar> previousTSMultiSolutionArray;
-    // if ((m_block->isTransient() && m_block->linearityType() != LinearityType_Linear) && (timeStep > 0))
-    if ((m_block->isTransient()) && (timeStep > 0))
-        previousTSMultiSolutionArray = Agros2D::solutionStore()->multiSolutionPreviousCalculatedTS(BlockSolutionID(m_block, timeStep, adaptivityStep, SolutionMode_Normal));
+    prepareSimple(timeStep, adaptivityStep);
+    solvePreparedSimple(timeStep, adaptivityStep);
+    printLinearSolverStatistics();
+}
 
+template <typename Scalar>
+void ProblemSolver<Scalar>::prepareSimple(int timeStep, int adaptivityStep)
+{
     // check for DOFs
     int ndof = Hermes::Hermes2D::Space<Scalar>::get_num_dofs(actualSpaces());
     if (ndof == 0)
@@ -469,7 +475,7 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
 
     if (m_block->isTransient())
     {
-        int order = min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
+        int order = timeOrder(timeStep);
         bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(order, Agros2D::problem()->timeStepLengths());
         m_hermesSolverContainer->matrixUnchangedDueToBDF(matrixUnchanged);
 
@@ -480,10 +486,20 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
     m_block->weakForm()->set_current_time(Agros2D::problem()->actualTime());
     m_block->weakForm()->updateExtField();
 
+    // to be used as starting vector for the Newton solver
+    m_previousTimeStepSolution = MultiArray<Scalar>();
+    // if ((m_block->isTransient() && m_block->linearityType() != LinearityType_Linear) && (timeStep > 0))
+    if ((m_block->isTransient()) && (timeStep > 0))
+        m_previousTimeStepSolution = Agros2D::solutionStore()->multiSolutionPreviousCalculatedTS(BlockSolutionID(m_block, timeStep, adaptivityStep, SolutionMode_Normal));
+}
+
+template <typename Scalar>
+void ProblemSolver<Scalar>::solvePreparedSimple(int timeStep, int adaptivityStep, bool storeSolution)
+{
     try
     {
         Scalar *solutionVector = solveOneProblem(actualSpaces(), adaptivityStep,
-                                                 previousTSMultiSolutionArray.solutions());
+                                                 m_previousTimeStepSolution.solutions());
 
         // output
         Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions = createSolutions<Scalar>(spacesMeshes(actualSpaces()));
@@ -503,7 +519,17 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
             runTime.setJacobianCalculations(solver->jacobianCalculations());
         }
 
-        Agros2D::solutionStore()->addSolution(solutionID, MultiArray<Scalar>(actualSpaces(), solutions), runTime);       
+        if (storeSolution)
+        {
+            Agros2D::solutionStore()->addSolution(solutionID, MultiArray<Scalar>(actualSpaces(), solutions), runTime);
+        }
+        else
+        {
+            m_hasPendingSolution = true;
+            m_pendingSolutionID = solutionID;
+            m_pendingSolution = MultiArray<Scalar>(actualSpaces(), solutions);
+            m_pendingRunTime = runTime;
+        }
     }
     catch (AgrosSolverException e)
     {
@@ -512,35 +538,122 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
 }
 
 template <typename Scalar>
-TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int adaptivityStep)
+void ProblemSolver<Scalar>::storePendingSolution()
 {
-    double timeTotal = Agros2D::problem()->config()->value(ProblemConfig::TimeTotal).toDouble();
+    if (!m_hasPendingSolution)
+        return;
 
-    // TODO: move to some config?
-    const double relativeTimeStepLen = Agros2D::problem()->actualTimeStepLength() / timeTotal;
-    const double maxTimeStepRatio = relativeTimeStepLen > 0.02 ? 2.0 : 3.0; // small steps may rise faster
-    const double maxTimeStepLength = timeTotal / 10;
-    const double maxToleranceMultiplyToAccept = 2.5; //3.0;
+    printLinearSolverStatistics();
+    Agros2D::solutionStore()->addSolution(m_pendingSolutionID, m_pendingSolution, m_pendingRunTime);
 
-    TimeStepMethod timeStepMethod = (TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt();
-    if(timeStepMethod == TimeStepMethod_Fixed)
-        return TimeStepInfo(Agros2D::problem()->config()->constantTimeStepLength());
+    m_hasPendingSolution = false;
+    m_pendingSolution = MultiArray<Scalar>();
+}
 
-    MultiArray<Scalar> referenceCalculation =
-            Agros2D::solutionStore()->multiArray(Agros2D::solutionStore()->lastTimeAndAdaptiveSolution(m_block, SolutionMode_Normal));
+// linear combination of solutions (values and derivatives), used as the predictor of the time step
+template <typename Scalar>
+class LinearCombinationFilter : public Hermes::Hermes2D::Filter<Scalar>
+{
+public:
+    LinearCombinationFilter(const Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > &solutions, const QVector<double> &coefficients)
+        : Hermes::Hermes2D::Filter<Scalar>(solutions), m_coefficients(coefficients)
+    {
+        assert(solutions.size() == coefficients.size());
+    }
 
-    // todo: ensure this in gui
-    assert(Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt() >= 2);
+    virtual Hermes::Hermes2D::Func<Scalar> *get_pt_value(double x, double y, bool use_MeshHashGrid = false, Hermes::Hermes2D::Element *e = NULL)
+    {
+        Hermes::Hermes2D::Func<Scalar> *func = new Hermes::Hermes2D::Func<Scalar>(1, 1);
+        func->val = new Scalar[1];
+        func->dx = new Scalar[1];
+        func->dy = new Scalar[1];
+        func->val[0] = func->dx[0] = func->dy[0] = 0.0;
 
-    // todo: in the first step, I am acualy using order 1 and thus I am unable to decrease it!
-    // this is not good, since the second step is not calculated (and the error of the first is not being checked)
-    if (timeStep == 1)
+        for (int k = 0; k < this->num; k++)
+        {
+            Hermes::Hermes2D::Func<Scalar> *fn = this->sln[k]->get_pt_value(x, y, use_MeshHashGrid, e);
+            if (!fn)
+                continue;
+
+            func->val[0] += m_coefficients[k] * fn->val[0];
+            func->dx[0] += m_coefficients[k] * fn->dx[0];
+            func->dy[0] += m_coefficients[k] * fn->dy[0];
+
+            fn->free_fn();
+            fn->free_ord();
+            delete fn;
+        }
+
+        return func;
+    }
+
+    virtual Hermes::Hermes2D::MeshFunction<Scalar> *clone() const
     {
-        m_averageErrorToLenghtRatio = 0.;
-        return TimeStepInfo(Agros2D::problem()->actualTimeStepLength());
+        Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > slns;
+        for (int k = 0; k < this->num; k++)
+            slns.push_back(this->sln[k]->clone());
+
+        return new LinearCombinationFilter<Scalar>(slns, m_coefficients);
+    }
+
+protected:
+    virtual void precalculate(int order, int mask)
+    {
+        Hermes::Hermes2D::Quad2D *quad = this->quads[Hermes::Hermes2D::Function<Scalar>::cur_quad];
+        int np = quad->get_num_points(order, this->get_active_element()->get_mode());
+        typename Hermes::Hermes2D::Function<Scalar>::Node *node = this->new_node(Hermes::Hermes2D::H2D_FN_DEFAULT, np);
+
+        for (int i = 0; i < np; i++)
+        {
+            node->values[0][0][i] = 0.0;
+            node->values[0][1][i] = 0.0;
+            node->values[0][2][i] = 0.0;
+        }
+
+        for (int k = 0; k < this->num; k++)
+        {
+            this->sln[k]->set_quad_order(order, Hermes::Hermes2D::H2D_FN_DEFAULT);
+            Scalar *value = this->sln[k]->get_fn_values();
+            Scalar *dudx = this->sln[k]->get_dx_values();
+            Scalar *dudy = this->sln[k]->get_dy_values();
+
+            for (int i = 0; i < np; i++)
+            {
+                node->values[0][0][i] += m_coefficients[k] * value[i];
+                node->values[0][1][i] += m_coefficients[k] * dudx[i];
+                node->values[0][2][i] += m_coefficients[k] * dudy[i];
+            }
+        }
+
+        if (this->nodes->present(order))
+        {
+            assert(this->nodes->get(order) == this->cur_node);
+            ::free(this->nodes->get(order));
+        }
+        this->nodes->add(node, order);
+        this->cur_node = node;
     }
 
-    int previouslyUsedOrder = min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
+private:
+    QVector<double> m_coefficients;
+};
+
+template <typename Scalar>
+int ProblemSolver<Scalar>::timeOrder(int timeStep) const
+{
+    if (Agros2D::problem()->config()->isTransientAdaptive() && Agros2D::problem()->config()->value(ProblemConfig::TimeOrderVariable).toBool())
+        return min(timeStep, m_timeOrder);
+    else
+        return min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
+}
+
+template <typename Scalar>
+double ProblemSolver<Scalar>::timeErrorDoubleSolve(int timeStep, int adaptivityStep, MultiArray<Scalar> referenceCalculation)
+{
+    // todo: ensure this in gui
+    assert(Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt() >= 2);
+
+    int previouslyUsedOrder = timeOrder(timeStep);
     bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(previouslyUsedOrder - 1, Agros2D::problem()->timeStepLengths());
     // using different order
     assert(matrixUnchanged == false);
@@ -553,6 +666,7 @@ TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int ada
     if(timeStep > 0)
         timeReferenceSolution = referenceCalculation.solutions();
     Scalar *solutionVector = solveOneProblem(actualSpaces(), adaptivityStep, timeReferenceSolution);
+    printLinearSolverStatistics();
 
     Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes = spacesMeshes(actualSpaces());
     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions = createSolutions<Scalar>(meshes);
@@ -562,7 +676,171 @@ TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int ada
     DefaultErrorCalculator<double, HERMES_H1_NORM> errorCalculator(RelativeErrorToGlobalNorm, solutions.size());
     // calculate error the total error estimate.
     errorCalculator.calculate_errors(referenceCalculation.solutions(), solutions, false);
-    double error = errorCalculator.get_total_error_squared();
+
+    return errorCalculator.get_total_error_squared();
+}
+
+template <typename Scalar>
+bool ProblemSolver<Scalar>::previousTimeLevels(int timeStep, int numLevels, QList<MultiArray<Scalar> > &previousLevels)
+{
+    for (int backLevel = 0; backLevel < numLevels; backLevel++)
+    {
+        MultiArray<Scalar> previousLevel;
+        foreach (Field *field, m_block->fields())
+        {
+            FieldInfo *fieldInfo = field->fieldInfo();
+
+            int previousTimeStep = timeStep - 1 - backLevel;
+            int previousAdaptivityStep = Agros2D::solutionStore()->lastAdaptiveStep(fieldInfo, SolutionMode_Normal, previousTimeStep);
+            FieldSolutionID solutionID(fieldInfo, previousTimeStep, previousAdaptivityStep, SolutionMode_Reference);
+            if (!Agros2D::solutionStore()->contains(solutionID))
+                solutionID.solutionMode = SolutionMode_Normal;
+            // field skipped this time step, history is not complete
+            if (!Agros2D::solutionStore()->contains(solutionID))
+                return false;
+
+            MultiArray<Scalar> multiArray = Agros2D::solutionStore()->multiArray(solutionID);
+            previousLevel.append(multiArray.spaces(), multiArray.solutions());
+        }
+
+        previousLevels.append(previousLevel);
+    }
+
+    return true;
+}
+
+template <typename Scalar>
+double ProblemSolver<Scalar>::timeErrorEmbedded(int timeStep, int order, MultiArray<Scalar> referenceCalculation)
+{
+    QList<double> timeStepLengths = Agros2D::problem()->timeStepLengths();
+
+    QList<MultiArray<Scalar> > previousLevels;
+    if (!previousTimeLevels(timeStep, order + 1, previousLevels))
+        return -1.0;
+
+    // predictor
+    QVector<double> coefficients = BDF2Table::predictorCoefficients(order, timeStepLengths);
+
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > predictor;
+    for (int comp = 0; comp < referenceCalculation.solutions().size(); comp++)
+    {
+        Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > levels;
+        foreach (MultiArray<Scalar> previousLevel, previousLevels)
+            levels.push_back(previousLevel.solutions().at(comp));
+
+        predictor.push_back(Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar>(new LinearCombinationFilter<Scalar>(levels, coefficients)));
+    }
+
+    // error calculation
+    DefaultErrorCalculator<double, HERMES_H1_NORM> errorCalculator(RelativeErrorToGlobalNorm, predictor.size());
+    errorCalculator.calculate_errors(referenceCalculation.solutions(), predictor, false);
+
+    // local truncation error of the corrector
+    double factor = BDF2Table::predictorErrorFactor(order, timeStepLengths);
+
+    return factor * factor * errorCalculator.get_total_error_squared();
+}
+
+template <typename Scalar>
+double ProblemSolver<Scalar>::timeErrorDifference(int timeStep, int order, MultiArray<Scalar> referenceCalculation)
+{
+    QList<double> timeStepLengths = Agros2D::problem()->timeStepLengths();
+
+    QList<MultiArray<Scalar> > previousLevels;
+    if (!previousTimeLevels(timeStep, order + 1, previousLevels))
+        return -1.0;
+
+    // solution minus the error estimate (the error calculator compares it with the solution)
+    QVector<double> coefficients = BDF2Table::differenceErrorCoefficients(order, timeStepLengths);
+    for (int i = 0; i < coefficients.size(); i++)
+        coefficients[i] = - coefficients[i];
+    coefficients[0] += 1.0;
+
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > difference;
+    for (int comp = 0; comp < referenceCalculation.solutions().size(); comp++)
+    {
+        Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > levels;
+        levels.push_back(referenceCalculation.solutions().at(comp));
+        foreach (MultiArray<Scalar> previousLevel, previousLevels)
+            levels.push_back(previousLevel.solutions().at(comp));
+
+        difference.push_back(Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar>(new LinearCombinationFilter<Scalar>(levels, coefficients)));
+    }
+
+    // error calculation
+    DefaultErrorCalculator<double, HERMES_H1_NORM> errorCalculator(RelativeErrorToGlobalNorm, difference.size());
+    errorCalculator.calculate_errors(referenceCalculation.solutions(), difference, false);
+
+    return errorCalculator.get_total_error_squared();
+}
+
+template <typename Scalar>
+TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int adaptivityStep)
+{
+    double timeTotal = Agros2D::problem()->config()->value(ProblemConfig::TimeTotal).toDouble();
+
+    // TODO: move to some config?
+    const double relativeTimeStepLen = Agros2D::problem()->actualTimeStepLength() / timeTotal;
+    const double maxTimeStepRatio = relativeTimeStepLen > 0.02 ? 2.0 : 3.0; // small steps may rise faster
+    const double maxTimeStepLength = timeTotal / 10;
+    const double maxToleranceMultiplyToAccept = 2.5; //3.0;
+    const double orderChangeRatio = 1.2; // order is changed if the next step is longer by 20 %
+
+    TimeStepMethod timeStepMethod = (TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt();
+    if(timeStepMethod == TimeStepMethod_Fixed)
+        return TimeStepInfo(Agros2D::problem()->config()->constantTimeStepLength());
+
+    MultiArray<Scalar> referenceCalculation =
+            Agros2D::solutionStore()->multiArray(Agros2D::solutionStore()->lastTimeAndAdaptiveSolution(m_block, SolutionMode_Normal));
+
+    // todo: in the first step, I am acualy using order 1 and thus I am unable to decrease it!
+    // this is not good, since the second step is not calculated (and the error of the first is not being checked)
+    if (timeStep == 1)
+    {
+        m_averageErrorToLenghtRatio = 0.;
+        m_timeOrderSteps = 1;
+        return TimeStepInfo(Agros2D::problem()->actualTimeStepLength());
+    }
+
+    // embedded estimate needs order + 1 previous time levels (initial condition included)
+    int previouslyUsedOrder = timeOrder(timeStep);
+    int maxTimeOrder = Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt();
+    bool variableOrder = Agros2D::problem()->config()->value(ProblemConfig::TimeOrderVariable).toBool();
+    TimeErrorEstimate timeErrorEstimate = (TimeErrorEstimate) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimate).toInt();
+
+    // errors of the candidate orders (variable order uses embedded estimates only)
+    QMap<int, double> orderErrors;
+    if (variableOrder || (timeErrorEstimate == TimeErrorEstimate_Embedded))
+    {
+        // the order is changed after order + 1 steps with the same order
+        int minOrder = (variableOrder && (m_timeOrderSteps > previouslyUsedOrder)) ? max(1, previouslyUsedOrder - 1) : previouslyUsedOrder;
+        int maxOrder = (variableOrder && (m_timeOrderSteps > previouslyUsedOrder)) ? min(maxTimeOrder, previouslyUsedOrder + 1) : previouslyUsedOrder;
+
+        for (int order = minOrder; order <= maxOrder; order++)
+        {
+            if (timeStep <= order)
+                continue;
+
+            // Milne's device for the actual order, divided differences for the orders k - 1 and k + 1
+            // (the predictor difference is dominated by the error of the actual order)
+            double orderError = (order == previouslyUsedOrder) ? timeErrorEmbedded(timeStep, order, referenceCalculation)
+                                                               : timeErrorDifference(timeStep, order, referenceCalculation);
+            if (orderError >= 0.0)
+                orderErrors[order] = orderError;
+        }
+    }
+
+    double error = 0.0;
+    if (orderErrors.contains(previouslyUsedOrder))
+        error = orderErrors[previouslyUsedOrder];
+    else if (!variableOrder)
+        error = timeErrorDoubleSolve(timeStep, adaptivityStep, referenceCalculation);
+    else
+    {
+        // history is not complete, keep the order and the step length
+        m_timeOrderSteps++;
+        return TimeStepInfo(Agros2D::problem()->actualTimeStepLength());
+    }
 
     // update
     double actualRatio = error / Agros2D::problem()->actualTimeStepLength();
@@ -592,8 +870,43 @@ TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int ada
     bool refuseThisStep = error > maxToleranceMultiplyToAccept  * TOL;
 
     // this guess is based on assymptotic considerations
-    int timeOrder = Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt();
-    double nextTimeStepLength = pow(TOL / error, 1.0 / (timeOrder + 1)) * Agros2D::problem()->actualTimeStepLength();
+    double nextTimeStepLength = pow(TOL / error, 1.0 / (maxTimeOrder + 1)) * Agros2D::problem()->actualTimeStepLength();
+
+    if (variableOrder)
+    {
+        // order allowing the longest step (other order has to be significantly better, higher order is not used after refused step)
+        int nextTimeOrder = previouslyUsedOrder;
+        double nextTimeStepRatio = pow(TOL / error, 1.0 / (previouslyUsedOrder + 1));
+        foreach (int order, orderErrors.keys())
+        {
+            if ((order == previouslyUsedOrder) || (refuseThisStep && (order > previouslyUsedOrder)))
+                continue;
+
+            double ratio = pow(TOL / orderErrors[order], 1.0 / (order + 1));
+            if (ratio > orderChangeRatio * nextTimeStepRatio)
+            {
+                nextTimeOrder = order;
+                nextTimeStepRatio = ratio;
+            }
+        }
+
+        nextTimeStepLength = nextTimeStepRatio * Agros2D::problem()->actualTimeStepLength();
+
+        if (nextTimeOrder != previouslyUsedOrder)
+        {
+            Agros2D::log()->printDebug(m_solverID, QString("Time adaptivity, order %1 -> %2").
+                                       arg(previouslyUsedOrder).
+                                       arg(nextTimeOrder));
+
+            m_timeOrder = nextTimeOrder;
+            m_timeOrderSteps = 0;
+        }
+        else if (!refuseThisStep)
+        {
+            m_timeOrder = previouslyUsedOrder;
+            m_timeOrderSteps++;
+        }
+    }
 
     nextTimeStepLength = min(nextTimeStepLength, maxTimeStepLength);
     nextTimeStepLength = min(nextTimeStepLength, Agros2D::problem()->actualTimeStepLength() * maxTimeStepRatio);
@@ -749,7 +1062,7 @@ void ProblemSolver<Scalar>::solveReferenceAndProject(int timeStep, int adaptivit
 
     if (m_block->isTransient())
     {
-        int order = min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
+        int order = timeOrder(timeStep);
         bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(order, Agros2D::problem()->timeStepLengths());
         m_hermesSolverContainer->matrixUnchangedDueToBDF(matrixUnchanged);
     }
@@ -770,6 +1083,7 @@ void ProblemSolver<Scalar>::solveReferenceAndProject(int timeStep, int adaptivit
     m_hermesSolverContainer->setTableSpaces()->set_spaces(spacesRef);
     Scalar *solutionVector = solveOneProblem(spacesRef, adaptivityStep,
                                              Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> >());
+    printLinearSolverStatistics();
 
     // output reference solution
     Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshesRef = spacesMeshes(spacesRef);
@@ -914,6 +1228,10 @@ void ProblemSolver<Scalar>::solveInitialTimeStep()
 {
     Agros2D::log()->printDebug(m_solverID, QObject::tr("Initial time step"));
 
+    // variable order starts with the first order method
+    m_timeOrder = 1;
+    m_timeOrderSteps = 0;
+
     //Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces = deepMeshAndSpaceCopy(actualSpaces(), false);
     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions;
 
@@ -22,6 +22,7 @@
 
 #include "util.h"
 #include "solutiontypes.h"
+#include "solutionstore.h"
 
 class Block;
 class FieldInfo;
@@ -122,7 +123,7 @@ template <typename Scalar>
 class ProblemSolver
 {
 public:
-    ProblemSolver() : m_hermesSolverContainer(NULL) {}
+    ProblemSolver() : m_hermesSolverContainer(NULL), m_timeOrder(1), m_timeOrderSteps(0), m_hasPendingSolution(false) {}
     ~ProblemSolver();
 
     void init(Block* block);
@@ -134,6 +135,11 @@ public:
     TimeStepInfo estimateTimeStepLength(int timeStep, int adaptivityStep);
 
     void solveSimple(int timeStep, int adaptivityStep);
+    // solveSimple in steps for blocks solved concurrently: prepareSimple and storePendingSolution are called
+    // from the main thread, solvePreparedSimple from a worker thread (no log, Python, time functions or solution store)
+    void prepareSimple(int timeStep, int adaptivityStep);
+    void solvePreparedSimple(int timeStep, int adaptivityStep, bool storeSolution = true);
+    void storePendingSolution();
     void solveReferenceAndProject(int timeStep, int adaptivityStep);
     bool createAdaptedSpace(int timeStep, int adaptivityStep, bool forceAdaptation = false);
 
@@ -157,9 +163,39 @@ private:
     // to be used in advanced time step adaptivity
     double m_averageErrorToLenghtRatio;
 
+    // order of the BDF method selected by the variable order time adaptivity
+    int m_timeOrder;
+    // number of accepted steps with the actual order
+    int m_timeOrderSteps;
+
+    // solution of solveSimple waiting for storePendingSolution
+    bool m_hasPendingSolution;
+    BlockSolutionID m_pendingSolutionID;
+    MultiArray<Scalar> m_pendingSolution;
+    SolutionStore::SolutionRunTimeDetails m_pendingRunTime;
+    // solution of the previous time step (initial vector of the solver), found by prepareSimple
+    MultiArray<Scalar> m_previousTimeStepSolution;
+
     void initSelectors(Hermes::vector<QSharedPointer<Hermes::Hermes2D::RefinementSelectors::Selector<Scalar> > >& selectors);
 
+    // order of the BDF method in the given time step (fixed or selected by the time adaptivity)
+    int timeOrder(int timeStep) const;
+
+    // squared relative error of the time discretization
+    // solves the problem again with the lower order of the BDF method
+    double timeErrorDoubleSolve(int timeStep, int adaptivityStep, MultiArray<Scalar> referenceCalculation);
+    // compares the solution with the predictor extrapolated from the previous time levels (no extra solve)
+    // error of the BDF method of the given order, negative if the history is not complete
+    double timeErrorEmbedded(int timeStep, int order, MultiArray<Scalar> referenceCalculation);
+    // error of the BDF method of the given order estimated from the divided difference of the solution and the previous time levels
+    // used for the orders other than the actual one, negative if the history is not complete
+    double timeErrorDifference(int timeStep, int order, MultiArray<Scalar> referenceCalculation);
+    // previous time levels of the block (from the last one backwards), false if the history is not complete
+    bool previousTimeLevels(int timeStep, int numLevels, QList<MultiArray<Scalar> > &previousLevels);
+
     Scalar *solveOneProblem(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces, int adaptivityStep, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousSolution = Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> >());
+    // statistics of the last solveOneProblem (main thread only)
+    void printLinearSolverStatistics();
 
     void clearActualSpaces();
     void setActualSpaces(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces);
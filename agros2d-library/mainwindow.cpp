@@ -1482,6 +1482,16 @@ void MainWindow::setControls()
 
     actDocumentExportMeshFile->setEnabled(Agros2D::problem()->isMeshed());
 
+    // process only views of the active scene view
+    if (sceneViewMesh->actSceneModeMesh->isChecked())
+        postHermes->setActiveViewMode(PostViewMode_Mesh);
+    else if (sceneViewPost2D->actSceneModePost2D->isChecked())
+        postHermes->setActiveViewMode(PostViewMode_Post2D);
+    else if (sceneViewPost3D->actSceneModePost3D->isChecked())
+        postHermes->setActiveViewMode(PostViewMode_Post3D);
+    else
+        postHermes->setActiveViewMode(PostViewMode_None);
+
     postprocessorWidget->updateControls();
 
     setUpdatesEnabled(true);
@@ -1541,8 +1551,8 @@ void MainWindow::doDocumentExportMeshFile()
             if (QFile::exists(fileName + ".msh"))
                 QFile::remove(fileName + ".msh");
 
-            // copy file
-            QFile::copy(cacheProblemDir() + "/initial.msh", fileName);
+            // write file
+            Agros2D::problem()->writeInitialMeshToFileXML(fileName);
             if (fileInfo.absoluteDir() != cacheProblemDir())
                 settings.setValue("General/LastMeshDir", fileInfo.absolutePath());
         }
@@ -36,7 +36,7 @@
 #include "hermes2d/problem.h"
 #include "hermes2d/problem_config.h"
 
-MeshGenerator::MeshGenerator() : QObject(), m_process(NULL), m_xmldomain(NULL)
+MeshGenerator::MeshGenerator() : QObject(), m_process(NULL)
 {
 }
 
@@ -48,15 +48,8 @@ MeshGenerator::~MeshGenerator()
 
 bool MeshGenerator::writeToHermes()
 {
-    // edges
-    XMLSubdomains::edges_type edges;
-    for (int i = 0; i < edgeList.count(); i++)
-        if (edgeList[i].isUsed && edgeList[i].marker != -1)
-            edges.ed().push_back(XMLSubdomains::ed(edgeList[i].node[0], edgeList[i].node[1],
-                    QString::number(edgeList[i].marker).toStdString(), i));
-
     // curved edges
-    XMLMesh::curves_type curves;
+    QList<MeshArc> arcs;
     for (int i = 0; i<edgeList.count(); i++)
     {
         if (edgeList[i].marker != -1)
@@ -81,7 +74,7 @@ bool MeshGenerator::writeToHermes()
 
                 double angle = direction * theta * chordShort / chord;
 
-                curves.arc().push_back(XMLMesh::arc(edgeList[i].node[0], edgeList[i].node[1], rad2deg(angle)));
+                arcs.append(MeshArc(edgeList[i].node[0], edgeList[i].node[1], rad2deg(angle)));
             }
         }
     }
@@ -113,24 +106,6 @@ bool MeshGenerator::writeToHermes()
         }
     }
 
-    // vertices
-    XMLMesh::vertices_type vertices;
-    for (int i = 0; i<nodeList.count(); i++)
-        vertices.v().push_back(std::auto_ptr<XMLMesh::v>(new XMLMesh::v(QString::number(nodeList[i].x).toStdString(),
-                                                                        QString::number(nodeList[i].y).toStdString(), i)));
-
-    // elements
-    XMLSubdomains::elements_type elements;
-    for (int i = 0; i<elementList.count(); i++)
-        if (elementList[i].isUsed)
-            if (elementList[i].isTriangle())
-                elements.el().push_back(XMLSubdomains::t_t(elementList[i].node[0], elementList[i].node[1], elementList[i].node[2],
-                        QString::number(elementList[i].marker).toStdString(), i));
-            else
-                elements.el().push_back(XMLSubdomains::q_t(elementList[i].node[0], elementList[i].node[1], elementList[i].node[2],
-                        QString::number(elementList[i].marker).toStdString(), i,
-                        elementList[i].node[3]));
-
     // find edge neighbours
     // for each vertex list elements that it belogns to
     QList<QSet<int> > vertexElements;
@@ -156,108 +131,201 @@ bool MeshGenerator::writeToHermes()
         }
     }
 
-    // subdomains
-    XMLSubdomains::subdomains subdomains;
-
-    if (Agros2D::problem()->fieldInfos().isEmpty())
-    {
-        // one domain
-        XMLSubdomains::subdomain subdomain(Agros2D::problem()->fieldInfos().begin().value()->fieldId().toStdString());
-        subdomains.subdomain().push_back(subdomain);
-    }
-    else
+    // subdomains (elements, boundary and inner edges of fields)
+    QList<MeshSubdomain> subdomains;
+    foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
     {
-        // more subdomains
-        foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
-        {
-            XMLSubdomains::subdomain subdomain(fieldInfo->fieldId().toStdString());
-            subdomain.elements().set(XMLSubdomains::subdomain::elements_type());
-            subdomain.boundary_edges().set(XMLSubdomains::subdomain::boundary_edges_type());
-            subdomain.inner_edges().set(XMLSubdomains::subdomain::inner_edges_type());
+        MeshSubdomain subdomain;
 
-            for (int i = 0; i<elementList.count(); i++)
-                if (elementList[i].isUsed && (Agros2D::scene()->labels->at(elementList[i].marker)->marker(fieldInfo) != SceneMaterialContainer::getNone(fieldInfo)))
-                    subdomain.elements()->i().push_back(i);
+        for (int i = 0; i<elementList.count(); i++)
+            if (elementList[i].isUsed && (Agros2D::scene()->labels->at(elementList[i].marker)->marker(fieldInfo) != SceneMaterialContainer::getNone(fieldInfo)))
+                subdomain.elements.append(i);
 
-            QList<int> unassignedEdges;
-            for (int i = 0; i < edgeList.count(); i++)
+        QList<int> unassignedEdges;
+        for (int i = 0; i < edgeList.count(); i++)
+        {
+            if (edgeList[i].isUsed && edgeList[i].marker != -1)
             {
-                if (edgeList[i].isUsed && edgeList[i].marker != -1)
+                int numNeighWithField = 0;
+                for (int neigh_i = 0; neigh_i < 2; neigh_i++)
                 {
-                    int numNeighWithField = 0;
-                    for (int neigh_i = 0; neigh_i < 2; neigh_i++)
+                    int neigh = edgeList[i].neighElem[neigh_i];
+                    if (neigh != -1)
                     {
-                        int neigh = edgeList[i].neighElem[neigh_i];
-                        if (neigh != -1)
-                        {
-                            if (Agros2D::scene()->labels->at(elementList[neigh].marker)->marker(fieldInfo)
-                                    != SceneMaterialContainer::getNone(fieldInfo))
-                                numNeighWithField++;
-                        }
+                        if (Agros2D::scene()->labels->at(elementList[neigh].marker)->marker(fieldInfo)
+                                != SceneMaterialContainer::getNone(fieldInfo))
+                            numNeighWithField++;
                     }
+                }
 
-                    // edge has boundary condition prescribed for this field
-                    bool hasFieldBoundaryCondition = (Agros2D::scene()->edges->at(edgeList[i].marker)->hasMarker(fieldInfo)
-                                                      && (Agros2D::scene()->edges->at(edgeList[i].marker)->marker(fieldInfo) != SceneBoundaryContainer::getNone(fieldInfo)));
+                // edge has boundary condition prescribed for this field
+                bool hasFieldBoundaryCondition = (Agros2D::scene()->edges->at(edgeList[i].marker)->hasMarker(fieldInfo)
+                                                  && (Agros2D::scene()->edges->at(edgeList[i].marker)->marker(fieldInfo) != SceneBoundaryContainer::getNone(fieldInfo)));
 
-                    if (numNeighWithField == 1)
-                    {
-                        // edge is on "boundary" of the field, should have boundary condition prescribed
+                if (numNeighWithField == 1)
+                {
+                    // edge is on "boundary" of the field, should have boundary condition prescribed
 
-                        if (!hasFieldBoundaryCondition)
-                            if (!unassignedEdges.contains(edgeList[i].marker))
-                                unassignedEdges.append(edgeList[i].marker);
+                    if (!hasFieldBoundaryCondition)
+                        if (!unassignedEdges.contains(edgeList[i].marker))
+                            unassignedEdges.append(edgeList[i].marker);
 
-                        subdomain.boundary_edges()->i().push_back(i);
-                    }
-                    else if (numNeighWithField == 2)
-                    {
-                        // todo: we could enforce not to have boundary conditions prescribed inside:
-                        // assert(!hasFieldBoundaryCondition);
-                        subdomain.inner_edges()->i().push_back(i);
-                    }
+                    subdomain.boundaryEdges.append(i);
+                }
+                else if (numNeighWithField == 2)
+                {
+                    // todo: we could enforce not to have boundary conditions prescribed inside:
+                    // assert(!hasFieldBoundaryCondition);
+                    subdomain.innerEdges.append(i);
                 }
             }
+        }
 
-            // not assigned boundary
-            if (unassignedEdges.count() > 0)
-            {
-                QString list;
-                foreach (int index, unassignedEdges)
-                    list += QString::number(index) + ", ";
+        // not assigned boundary
+        if (unassignedEdges.count() > 0)
+        {
+            QString list;
+            foreach (int index, unassignedEdges)
+                list += QString::number(index) + ", ";
 
-                Agros2D::log()->printError(tr("Mesh generator"), tr("Boundary condition for %1 is not assigned on following edges: %2").arg(fieldInfo->name()).arg(list.left(list.count() - 2)));
+            Agros2D::log()->printError(tr("Mesh generator"), tr("Boundary condition for %1 is not assigned on following edges: %2").arg(fieldInfo->name()).arg(list.left(list.count() - 2)));
 
-                return false;
-            }
+            return false;
+        }
+
+        subdomains.append(subdomain);
+    }
+
+    m_meshes.clear();
+
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::checkMeshesOnLoad, false);
+
+    try
+    {
+        // meshes of all fields are created directly (XML is written only on export)
+        foreach (MeshSubdomain subdomain, subdomains)
+            m_meshes.push_back(createMesh(subdomain, arcs));
+    }
+    catch (Hermes::Exceptions::Exception& e)
+    {
+        m_meshes.clear();
+
+        Agros2D::log()->printError(tr("Mesh generator"), QString::fromStdString(e.what()));
+        return false;
+    }
+
+    return true;
+}
+
+Hermes::Hermes2D::MeshSharedPtr MeshGenerator::createMesh(const MeshSubdomain &subdomain, const QList<MeshArc> &arcs)
+{
+    Hermes::Hermes2D::MeshSharedPtr mesh(new Hermes::Hermes2D::Mesh());
+
+    // hash table
+    int size = Hermes::Hermes2D::HashTable::H2D_DEFAULT_HASH_SIZE;
+    while (size < 8 * nodeList.count())
+        size *= 2;
+    mesh->init(size);
+
+    // vertices (all fields share the vertices of the generator)
+    for (int i = 0; i < nodeList.count(); i++)
+    {
+        Hermes::Hermes2D::Node *node = mesh->nodes.add();
+        node->ref = TOP_LEVEL_REF;
+        node->type = HERMES_TYPE_VERTEX;
+        node->bnd = 0;
+        node->p1 = node->p2 = -1;
+        node->next_hash = NULL;
+        node->x = nodeList[i].x;
+        node->y = nodeList[i].y;
+    }
+    mesh->ntopvert = nodeList.count();
+
+    // elements (common numbering of all fields, elements of other fields are skipped slots)
+    QSet<int> subdomainElements = subdomain.elements.toSet();
+    int elementCount = 0;
+    for (int i = 0; i < elementList.count(); i++)
+    {
+        if (!elementList[i].isUsed)
+            continue;
+
+        if (!subdomainElements.contains(i))
+        {
+            mesh->elements.skip_slot()->cm = NULL;
+            continue;
+        }
+
+        std::string marker = QString::number(elementList[i].marker).toStdString();
+        mesh->element_markers_conversion.insert_marker(marker);
+        int internalMarker = mesh->element_markers_conversion.get_internal_marker(marker).marker;
+
+        if (elementList[i].isTriangle())
+            mesh->create_triangle(internalMarker,
+                                  &mesh->nodes[elementList[i].node[0]], &mesh->nodes[elementList[i].node[1]],
+                                  &mesh->nodes[elementList[i].node[2]], NULL);
+        else
+            mesh->create_quad(internalMarker,
+                              &mesh->nodes[elementList[i].node[0]], &mesh->nodes[elementList[i].node[1]],
+                              &mesh->nodes[elementList[i].node[2]], &mesh->nodes[elementList[i].node[3]], NULL);
+
+        elementCount++;
+    }
+    mesh->nbase = mesh->nactive = elementCount;
+    mesh->ninitial = mesh->elements.get_size();
 
-            subdomains.subdomain().push_back(subdomain);
+    // edges (inner edges keep the marker, only edges of one element are on the boundary)
+    foreach (int i, subdomain.boundaryEdges + subdomain.innerEdges)
+    {
+        Hermes::Hermes2D::Node *en = mesh->peek_edge_node(edgeList[i].node[0], edgeList[i].node[1]);
+        if (!en)
+            throw Hermes::Exceptions::Exception("Boundary data error (edge does not exist)");
+
+        std::string marker = QString::number(edgeList[i].marker).toStdString();
+        mesh->boundary_markers_conversion.insert_marker(marker);
+        en->marker = mesh->boundary_markers_conversion.get_internal_marker(marker).marker;
+
+        if (en->ref < 2)
+        {
+            mesh->nodes[edgeList[i].node[0]].bnd = 1;
+            mesh->nodes[edgeList[i].node[1]].bnd = 1;
+            en->bnd = 1;
         }
     }
 
-    m_xmldomain = std::auto_ptr<XMLSubdomains::domain>(new XMLSubdomains::domain(vertices, elements, edges, subdomains));
-    m_xmldomain.get()->curves().set(curves);
+    // curved edges (rational quadratic arcs, the same as MeshReaderH2DXML)
+    foreach (MeshArc arc, arcs)
+    {
+        Hermes::Hermes2D::Node *en = mesh->peek_edge_node(arc.node[0], arc.node[1]);
+        if (!en)
+            continue;
+
+        Hermes::Hermes2D::Arc *curve = new Hermes::Hermes2D::Arc(arc.angle);
 
-    std::string mesh_schema_location(Hermes::Hermes2D::Hermes2DApi.get_text_param_value(Hermes::Hermes2D::xmlSchemasDirPath));
-    mesh_schema_location.append("/mesh_h2d_xml.xsd");
-    ::xml_schema::namespace_info namespace_info_mesh("XMLMesh", mesh_schema_location);
+        curve->pt[0][0] = nodeList[arc.node[0]].x;
+        curve->pt[0][1] = nodeList[arc.node[0]].y;
+        curve->pt[0][2] = 1.0;
 
-    std::string domain_schema_location(Hermes::Hermes2D::Hermes2DApi.get_text_param_value(Hermes::Hermes2D::xmlSchemasDirPath));
-    domain_schema_location.append("/subdomains_h2d_xml.xsd");
-    ::xml_schema::namespace_info namespace_info_domain("XMLSubdomains", domain_schema_location);
+        curve->pt[2][0] = nodeList[arc.node[1]].x;
+        curve->pt[2][1] = nodeList[arc.node[1]].y;
+        curve->pt[2][2] = 1.0;
 
-    ::xml_schema::namespace_infomap namespace_info_map;
-    namespace_info_map.insert(std::pair<std::basic_string<char>, xml_schema::namespace_info>("mesh", namespace_info_mesh));
-    namespace_info_map.insert(std::pair<std::basic_string<char>, xml_schema::namespace_info>("domain", namespace_info_domain));
+        // middle control point
+        double a = (180.0 - arc.angle) / 180.0 * M_PI;
+        double x = 1.0 / tan(a * 0.5);
+        curve->pt[1][0] = 0.5 * ((curve->pt[2][0] + curve->pt[0][0]) + (curve->pt[2][1] - curve->pt[0][1]) * x);
+        curve->pt[1][1] = 0.5 * ((curve->pt[2][1] + curve->pt[0][1]) - (curve->pt[2][0] - curve->pt[0][0]) * x);
+        curve->pt[1][2] = cos((M_PI - a) * 0.5);
 
-    QString fn = QString("%1/initial.msh").arg(cacheProblemDir());
+        Hermes::Hermes2D::MeshUtil::assign_curve(en, curve, arc.node[0], arc.node[1]);
+    }
 
-    std::ofstream out(compatibleFilename(fn).toStdString().c_str());
-    ::xml_schema::flags parsing_flags = ::xml_schema::flags::dont_pretty_print;
-    XMLSubdomains::domain_(out, *m_xmldomain.get(), namespace_info_map, "UTF-8", parsing_flags);
-    out.close();
+    // update refmap coefficients of curvilinear elements
+    Hermes::Hermes2D::Element *e;
+    for_all_used_elements(e, mesh)
+        if (e->cm)
+            e->cm->update_refmap_coeffs(e);
 
-    return true;
+    return mesh;
 }
 
 bool MeshGenerator::prepare()
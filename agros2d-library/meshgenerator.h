@@ -22,15 +22,11 @@
 
 #include "util.h"
 #include "util/loops.h"
+#include "hermes2d.h"
 #ifdef Q_WS_X11
 #include <tr1/memory>
 #endif
 
-namespace XMLSubdomains
-{
-    class domain;
-};
-
 class AGROS_LIBRARY_API MeshGenerator : public QObject
 {
     Q_OBJECT
@@ -41,7 +37,8 @@ public:
 
     virtual bool mesh() = 0;
 
-    inline std::auto_ptr<XMLSubdomains::domain> xmldomain() { return m_xmldomain; }
+    // initial meshes of all fields (the same order as Problem::fieldInfos())
+    inline Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes() const { return m_meshes; }
 
 protected:
     struct MeshEdge
@@ -139,6 +136,28 @@ protected:
         int neigh[3];
     };
 
+    // curved edge (angle in degrees)
+    struct MeshArc
+    {
+        MeshArc(int node_1, int node_2, double angle)
+        {
+            this->node[0] = node_1;
+            this->node[1] = node_2;
+            this->angle = angle;
+        }
+
+        int node[2];
+        double angle;
+    };
+
+    // elements and edges of one field (indices to elementList and edgeList)
+    struct MeshSubdomain
+    {
+        QList<int> elements;
+        QList<int> boundaryEdges;
+        QList<int> innerEdges;
+    };
+
     /*
     struct MeshNode
     {
@@ -163,10 +182,13 @@ protected:
     bool writeToHermes();
     bool prepare();
 
+    // Hermes mesh of one field built directly from the lists (element numbering common to all fields)
+    Hermes::Hermes2D::MeshSharedPtr createMesh(const MeshSubdomain &subdomain, const QList<MeshArc> &arcs);
+
     bool m_isError;
     QProcess *m_process;
 
-    std::auto_ptr<XMLSubdomains::domain> m_xmldomain;
+    Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> m_meshes;
 };
 
 #endif //MESHGENERATOR_H
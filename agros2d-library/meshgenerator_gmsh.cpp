@@ -436,12 +436,12 @@ bool MeshGeneratorGMSH::readGmshMeshFile()
 
     fileGMSH.close();
 
-    writeToHermes();
+    bool result = writeToHermes();
 
     nodeList.clear();
     edgeList.clear();
     elementList.clear();
 
-    return true;
+    return result;
 }
 
@@ -20,6 +20,7 @@
 #include "meshgenerator_triangle.h"
 
 #include "util/global.h"
+#include "util/conf.h"
 
 #include "scene.h"
 
@@ -42,6 +43,32 @@
 
 #include <QThread>
 
+#ifdef WITH_TRIANGLE_LIBRARY
+#ifndef REAL
+#define REAL double
+#endif
+#ifndef VOID
+#define VOID void
+#endif
+#define ANSI_DECLARATORS
+extern "C"
+{
+#include <triangle.h>
+}
+
+#include <csetjmp>
+
+// Triangle calls exit() on invalid input and internal errors, its sources are compiled
+// with exit() redirected to triangle_exit() (3rdparty/triangle) and the control returns
+// to meshTriangleLibrary()
+static jmp_buf triangleExit;
+
+extern "C" void triangle_exit(int status)
+{
+    longjmp(triangleExit, (status == 0) ? 1 : status);
+}
+#endif
+
 class Xsleep : public QThread
 {
 public:
@@ -61,6 +88,21 @@ bool MeshGeneratorTriangle::mesh()
 {
     m_isError = !prepare();
 
+#ifdef WITH_TRIANGLE_LIBRARY
+    if (Agros2D::configComputer()->meshTriangleLibrary)
+    {
+        if (!meshTriangleLibrary())
+            m_isError = true;
+
+        return !m_isError;
+    }
+#endif
+
+    return meshTriangleProcess();
+}
+
+bool MeshGeneratorTriangle::meshTriangleProcess()
+{
     // create triangle files
     if (writeToTriangle())
     {
@@ -98,6 +140,129 @@ bool MeshGeneratorTriangle::mesh()
     return !m_isError;
 }
 
+#ifdef WITH_TRIANGLE_LIBRARY
+bool MeshGeneratorTriangle::meshTriangleLibrary()
+{
+    TriangleGeometry geometry;
+    if (!triangleGeometry(geometry))
+        return false;
+
+    std::vector<double> pointList(2 * geometry.nodes.count());
+    for (int i = 0; i < geometry.nodes.count(); i++)
+    {
+        pointList[2*i + 0] = geometry.nodes[i].x;
+        pointList[2*i + 1] = geometry.nodes[i].y;
+    }
+
+    std::vector<int> segmentList(2 * geometry.segments.count());
+    std::vector<int> segmentMarkerList(geometry.segments.count());
+    for (int i = 0; i < geometry.segments.count(); i++)
+    {
+        segmentList[2*i + 0] = geometry.segments[i].node[0];
+        segmentList[2*i + 1] = geometry.segments[i].node[1];
+        segmentMarkerList[i] = geometry.segments[i].marker;
+    }
+
+    std::vector<double> holeList(2 * geometry.holes.count() + 1);
+    for (int i = 0; i < geometry.holes.count(); i++)
+    {
+        holeList[2*i + 0] = geometry.holes[i].x;
+        holeList[2*i + 1] = geometry.holes[i].y;
+    }
+
+    std::vector<double> regionList(4 * geometry.regions.count() + 1);
+    for (int i = 0; i < geometry.regions.count(); i++)
+    {
+        regionList[4*i + 0] = geometry.regions[i].x;
+        regionList[4*i + 1] = geometry.regions[i].y;
+        regionList[4*i + 2] = geometry.regionMarkers[i];
+        regionList[4*i + 3] = geometry.regionAreas[i];
+    }
+
+    triangulateio in, out;
+    memset(&in, 0, sizeof(triangulateio));
+    memset(&out, 0, sizeof(triangulateio));
+
+    in.numberofpoints = geometry.nodes.count();
+    in.pointlist = &pointList[0];
+    in.numberofsegments = geometry.segments.count();
+    in.segmentlist = &segmentList[0];
+    in.segmentmarkerlist = &segmentMarkerList[0];
+    in.numberofholes = geometry.holes.count();
+    in.holelist = &holeList[0];
+    in.numberofregions = geometry.regions.count();
+    in.regionlist = &regionList[0];
+
+    // same switches as the executable (-p -P -q31.0 -e -A -a -z -Q -I -n -o2)
+    char switches[] = "pPq31.0eAazQIno2";
+    if (setjmp(triangleExit) != 0)
+    {
+        // memory allocated by Triangle before the error is not released
+        Agros2D::log()->printError(tr("Mesh generator"), tr("Triangle could not mesh the geometry"));
+        return false;
+    }
+    triangulate(switches, &in, &out, NULL);
+
+    nodeList.clear();
+    edgeList.clear();
+    elementList.clear();
+
+    bool ok = true;
+
+    // triangle nodes
+    for (int i = 0; i < out.numberofpoints; i++)
+        nodeList.append(Point(out.pointlist[2*i + 0], out.pointlist[2*i + 1]));
+
+    // triangle edges (marker conversion from triangle, where it starts from 1)
+    for (int i = 0; i < out.numberofedges; i++)
+        edgeList.append(MeshEdge(out.edgelist[2*i + 0], out.edgelist[2*i + 1], out.edgemarkerlist[i] - 1));
+    int edgeCountLinear = edgeList.count();
+
+    // triangle elements
+    if (out.numberoftriangleattributes == 0)
+    {
+        Agros2D::log()->printError(tr("Mesh generator"), tr("Some areas do not have a marker"));
+        ok = false;
+    }
+
+    for (int i = 0; ok && (i < out.numberoftriangles); i++)
+        ok = appendTriangleElement(out.trianglelist + out.numberofcorners * i,
+                                   (int) out.triangleattributelist[out.numberoftriangleattributes * i]);
+    int elementCountLinear = elementList.count();
+
+    // triangle neigh
+    for (int i = 0; ok && (i < out.numberoftriangles); i++)
+    {
+        elementList[i].neigh[0] = out.neighborlist[3*i + 0];
+        elementList[i].neigh[1] = out.neighborlist[3*i + 1];
+        elementList[i].neigh[2] = out.neighborlist[3*i + 2];
+    }
+
+    trifree(out.pointlist);
+    trifree(out.pointmarkerlist);
+    trifree(out.trianglelist);
+    trifree(out.triangleattributelist);
+    trifree(out.neighborlist);
+    trifree(out.segmentlist);
+    trifree(out.segmentmarkerlist);
+    trifree(out.edgelist);
+    trifree(out.edgemarkerlist);
+
+    if (ok)
+        ok = convertTriangleMesh(edgeCountLinear, elementCountLinear);
+
+    if (ok)
+        Agros2D::log()->printMessage(tr("Mesh generator"), tr("Mesh was converted to Hermes2D mesh file"));
+
+    return ok;
+}
+#else
+bool MeshGeneratorTriangle::meshTriangleLibrary()
+{
+    return false;
+}
+#endif
+
 void MeshGeneratorTriangle::meshTriangleError(QProcess::ProcessError error)
 {
     Agros2D::log()->printError(tr("Mesh generator"), tr("Could not start Triangle"));
@@ -140,7 +305,7 @@ void MeshGeneratorTriangle::meshTriangleCreated(int exitCode)
     }
 }
 
-bool MeshGeneratorTriangle::writeToTriangle()
+bool MeshGeneratorTriangle::triangleGeometry(TriangleGeometry &geometry)
 {
     // basic check
     if (Agros2D::scene()->nodes->length() < 3)
@@ -154,151 +319,143 @@ bool MeshGeneratorTriangle::writeToTriangle()
         return false;
     }
 
-    // save current locale
-    char *plocale = setlocale (LC_NUMERIC, "");
-    setlocale (LC_NUMERIC, "C");
-
-    QDir dir;
-    dir.mkdir(QDir::temp().absolutePath() + "/agros2d");
-    QFile file(tempProblemFileName() + ".poly");
-
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        Agros2D::log()->printError(tr("Mesh generator"), tr("Could not create Triangle poly mesh file (%1)").arg(file.errorString()));
-        return false;
-    }
-    QTextStream out(&file);
-
-
     // nodes
-    QString outNodes;
-    int nodesCount = 0;
-    for (int i = 0; i<Agros2D::scene()->nodes->length(); i++)
+    QMap<SceneNode *, int> nodeIndices;
+    for (int i = 0; i < Agros2D::scene()->nodes->length(); i++)
     {
-        outNodes += QString("%1  %2  %3  %4\n").
-                arg(i).
-                arg(Agros2D::scene()->nodes->at(i)->point().x, 0, 'f', 10).
-                arg(Agros2D::scene()->nodes->at(i)->point().y, 0, 'f', 10).
-                arg(0);
-        nodesCount++;
+        geometry.nodes.append(Agros2D::scene()->nodes->at(i)->point());
+        nodeIndices[Agros2D::scene()->nodes->at(i)] = i;
     }
 
     // edges
-    QString outEdges;
-    int edgesCount = 0;
-    for (int i = 0; i<Agros2D::scene()->edges->length(); i++)
+    for (int i = 0; i < Agros2D::scene()->edges->length(); i++)
     {
-        if (Agros2D::scene()->edges->at(i)->angle() == 0)
+        SceneEdge *edge = Agros2D::scene()->edges->at(i);
+
+        if (edge->angle() == 0)
         {
             // line
-            outEdges += QString("%1  %2  %3  %4\n").
-                    arg(edgesCount).
-                    arg(Agros2D::scene()->nodes->items().indexOf(Agros2D::scene()->edges->at(i)->nodeStart())).
-                    arg(Agros2D::scene()->nodes->items().indexOf(Agros2D::scene()->edges->at(i)->nodeEnd())).
-                    arg(i+1);
-            edgesCount++;
+            geometry.segments.append(MeshEdge(nodeIndices[edge->nodeStart()], nodeIndices[edge->nodeEnd()], i+1));
         }
         else
         {
             // arc
             // add pseudo nodes
-            Point center = Agros2D::scene()->edges->at(i)->center();
-            double radius = Agros2D::scene()->edges->at(i)->radius();
-            double startAngle = atan2(center.y - Agros2D::scene()->edges->at(i)->nodeStart()->point().y,
-                                      center.x - Agros2D::scene()->edges->at(i)->nodeStart()->point().x) - M_PI;
+            Point center = edge->center();
+            double radius = edge->radius();
+            double startAngle = atan2(center.y - edge->nodeStart()->point().y,
+                                      center.x - edge->nodeStart()->point().x) - M_PI;
 
-            int segments = Agros2D::scene()->edges->at(i)->segments();
-            double theta = deg2rad(Agros2D::scene()->edges->at(i)->angle()) / double(segments);
+            int segments = edge->segments();
+            double theta = deg2rad(edge->angle()) / double(segments);
 
-            int nodeStartIndex = 0;
-            int nodeEndIndex = 0;
+            int nodeStartIndex = nodeIndices[edge->nodeStart()];
             for (int j = 0; j < segments; j++)
             {
-                double arc = startAngle + j*theta;
-
-                double x = radius * cos(arc);
-                double y = radius * sin(arc);
-
-                nodeEndIndex = nodesCount+1;
-                if (j == 0)
-                {
-                    nodeStartIndex = Agros2D::scene()->nodes->items().indexOf(Agros2D::scene()->edges->at(i)->nodeStart());
-                    nodeEndIndex = nodesCount;
-                }
+                int nodeEndIndex;
                 if (j == segments - 1)
                 {
-                    nodeEndIndex = Agros2D::scene()->nodes->items().indexOf(Agros2D::scene()->edges->at(i)->nodeEnd());
+                    nodeEndIndex = nodeIndices[edge->nodeEnd()];
                 }
-                if ((j > 0) && (j < segments))
+                else
                 {
-                    outNodes += QString("%1  %2  %3  %4\n").
-                            arg(nodesCount).
-                            arg(center.x + x, 0, 'f', 10).
-                            arg(center.y + y, 0, 'f', 10).
-                            arg(0);
-                    nodesCount++;
+                    double arc = startAngle + (j+1)*theta;
+
+                    nodeEndIndex = geometry.nodes.count();
+                    geometry.nodes.append(Point(center.x + radius * cos(arc),
+                                                center.y + radius * sin(arc)));
                 }
-                outEdges += QString("%1  %2  %3  %4\n").
-                        arg(edgesCount).
-                        arg(nodeStartIndex).
-                        arg(nodeEndIndex).
-                        arg(i+1);
-                edgesCount++;
+
+                geometry.segments.append(MeshEdge(nodeStartIndex, nodeEndIndex, i+1));
                 nodeStartIndex = nodeEndIndex;
             }
         }
     }
 
-    // holes
-    int holesCount = 0;
-    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
-        if (label->markersCount() == 0)
-            holesCount++;
-
-    QString outHoles = QString("%1\n").arg(holesCount);
-    holesCount = 0;
     foreach (SceneLabel *label, Agros2D::scene()->labels->items())
     {
         if (label->markersCount() == 0)
         {
-            outHoles += QString("%1  %2  %3\n").
-                    arg(holesCount).
-                    // arg(Agros2D::scene()->labels->items().indexOf(label) + 1).
-                    arg(label->point().x, 0, 'f', 10).
-                    arg(label->point().y, 0, 'f', 10);
-
-            holesCount++;
+            // holes
+            geometry.holes.append(label->point());
+        }
+        else
+        {
+            // labels
+            geometry.regions.append(label->point());
+            // triangle returns zero region number for areas without marker, markers must start from 1
+            geometry.regionMarkers.append(Agros2D::scene()->labels->items().indexOf(label) + 1);
+            geometry.regionAreas.append(label->area());
         }
     }
 
-    // labels
-    QString outLabels;
-    int labelsCount = 0;
-    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
+    return true;
+}
+
+bool MeshGeneratorTriangle::writeToTriangle()
+{
+    TriangleGeometry geometry;
+    if (!triangleGeometry(geometry))
+        return false;
+
+    // save current locale
+    char *plocale = setlocale (LC_NUMERIC, "");
+    setlocale (LC_NUMERIC, "C");
+
+    QDir dir;
+    dir.mkdir(QDir::temp().absolutePath() + "/agros2d");
+    QFile file(tempProblemFileName() + ".poly");
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
-        if (label->markersCount() > 0)
-        {
-            outLabels += QString("%1  %2  %3  %4  %5\n").
-                    arg(labelsCount).
-                    arg(label->point().x, 0, 'f', 10).
-                    arg(label->point().y, 0, 'f', 10).
-                    // arg(labelsCount + 1). // triangle returns zero region number for areas without marker, markers must start from 1
-                    arg(Agros2D::scene()->labels->items().indexOf(label) + 1).
-                    arg(label->area());
-            labelsCount++;
-        }
+        Agros2D::log()->printError(tr("Mesh generator"), tr("Could not create Triangle poly mesh file (%1)").arg(file.errorString()));
+        return false;
     }
+    QTextStream out(&file);
 
-    outNodes.insert(0, QString("%1 2 0 1\n").
-                    arg(nodesCount)); // + additional Agros2D::scene()->nodes
-    out << outNodes;
-    outEdges.insert(0, QString("%1 1\n").
-                    arg(edgesCount)); // + additional edges
-    out << outEdges;
-    out << outHoles;
-    outLabels.insert(0, QString("%1 1\n").
-                     arg(labelsCount)); // - holes
-    out << outLabels;
+    // nodes
+    out << QString("%1 2 0 1\n").arg(geometry.nodes.count());
+    for (int i = 0; i < geometry.nodes.count(); i++)
+    {
+        out << QString("%1  %2  %3  %4\n").
+               arg(i).
+               arg(geometry.nodes[i].x, 0, 'f', 10).
+               arg(geometry.nodes[i].y, 0, 'f', 10).
+               arg(0);
+    }
+
+    // edges
+    out << QString("%1 1\n").arg(geometry.segments.count());
+    for (int i = 0; i < geometry.segments.count(); i++)
+    {
+        out << QString("%1  %2  %3  %4\n").
+               arg(i).
+               arg(geometry.segments[i].node[0]).
+               arg(geometry.segments[i].node[1]).
+               arg(geometry.segments[i].marker);
+    }
+
+    // holes
+    out << QString("%1\n").arg(geometry.holes.count());
+    for (int i = 0; i < geometry.holes.count(); i++)
+    {
+        out << QString("%1  %2  %3\n").
+               arg(i).
+               arg(geometry.holes[i].x, 0, 'f', 10).
+               arg(geometry.holes[i].y, 0, 'f', 10);
+    }
+
+    // labels
+    out << QString("%1 1\n").arg(geometry.regions.count());
+    for (int i = 0; i < geometry.regions.count(); i++)
+    {
+        out << QString("%1  %2  %3  %4  %5\n").
+               arg(i).
+               arg(geometry.regions[i].x, 0, 'f', 10).
+               arg(geometry.regions[i].y, 0, 'f', 10).
+               arg(geometry.regionMarkers[i]).
+               arg(geometry.regionAreas[i]);
+    }
 
     file.waitForBytesWritten(0);
     file.close();
@@ -309,6 +466,44 @@ bool MeshGeneratorTriangle::writeToTriangle()
     return true;
 }
 
+bool MeshGeneratorTriangle::appendTriangleElement(const int *nodes, int marker)
+{
+    if (marker == 0)
+    {
+        Agros2D::log()->printError(tr("Mesh generator"), tr("Some areas do not have a marker"));
+        return false;
+    }
+
+    // vertices
+    int nodeA = nodes[0];
+    int nodeB = nodes[1];
+    int nodeC = nodes[2];
+    // 2nd order nodes (in the middle of edges)
+    int nodeNA = nodes[3];
+    int nodeNB = nodes[4];
+    int nodeNC = nodes[5];
+
+    if (Agros2D::problem()->config()->meshType() == MeshType_Triangle ||
+            Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadJoin ||
+            Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadRoughDivision)
+    {
+        elementList.append(MeshElement(nodeA, nodeB, nodeC, marker - 1)); // marker conversion from triangle, where it starts from 1
+    }
+
+    if (Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadFineDivision)
+    {
+        // add additional node
+        nodeList.append(Point((nodeList[nodeA].x + nodeList[nodeB].x + nodeList[nodeC].x) / 3.0,
+                              (nodeList[nodeA].y + nodeList[nodeB].y + nodeList[nodeC].y) / 3.0));
+        // add three quad elements
+        elementList.append(MeshElement(nodeNB, nodeA, nodeNC, nodeList.count() - 1, marker - 1)); // marker conversion from triangle, where it starts from 1
+        elementList.append(MeshElement(nodeNC, nodeB, nodeNA, nodeList.count() - 1, marker - 1)); // marker conversion from triangle, where it starts from 1
+        elementList.append(MeshElement(nodeNA, nodeC, nodeNB, nodeList.count() - 1, marker - 1)); // marker conversion from triangle, where it starts from 1
+    }
+
+    return true;
+}
+
 bool MeshGeneratorTriangle::readTriangleMeshFormat()
 {
     nodeList.clear();
@@ -379,7 +574,6 @@ bool MeshGeneratorTriangle::readTriangleMeshFormat()
     // triangle elements
     QString lineElement = inEle.readLine().trimmed();
     int numberOfElements = lineElement.split(whiteChar).at(0).toInt();
-    QSet<int> labelMarkersCheck;
     for (int i = 0; i < numberOfElements; i++)
     {
         QStringList parsedLine = inEle.readLine().trimmed().split(whiteChar);
@@ -388,69 +582,16 @@ bool MeshGeneratorTriangle::readTriangleMeshFormat()
             Agros2D::log()->printError(tr("Mesh generator"), tr("Some areas do not have a marker"));
             return false;
         }
-        int marker = parsedLine.at(7).toInt();
-
-        if (marker == 0)
-        {
-            Agros2D::log()->printError(tr("Mesh generator"), tr("Some areas do not have a marker"));
-            return false;
-        }
 
-        // vertices
-        int nodeA = parsedLine.at(1).toInt();
-        int nodeB = parsedLine.at(2).toInt();
-        int nodeC = parsedLine.at(3).toInt();
-        // 2nd order nodes (in the middle of edges)
-        int nodeNA = parsedLine.at(4).toInt();
-        int nodeNB = parsedLine.at(5).toInt();
-        int nodeNC = parsedLine.at(6).toInt();
-
-        if (Agros2D::problem()->config()->meshType() == MeshType_Triangle ||
-                Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadJoin ||
-                Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadRoughDivision)
-        {
-            elementList.append(MeshElement(nodeA, nodeB, nodeC, marker - 1)); // marker conversion from triangle, where it starts from 1
-        }
+        int nodes[6];
+        for (int j = 0; j < 6; j++)
+            nodes[j] = parsedLine.at(j + 1).toInt();
 
-        if (Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadFineDivision)
-        {
-            // add additional node
-            nodeList.append(Point((nodeList[nodeA].x + nodeList[nodeB].x + nodeList[nodeC].x) / 3.0,
-                                  (nodeList[nodeA].y + nodeList[nodeB].y + nodeList[nodeC].y) / 3.0));
-            // add three quad elements
-            elementList.append(MeshElement(nodeNB, nodeA, nodeNC, nodeList.count() - 1, marker - 1)); // marker conversion from triangle, where it starts from 1
-            elementList.append(MeshElement(nodeNC, nodeB, nodeNA, nodeList.count() - 1, marker - 1)); // marker conversion from triangle, where it starts from 1
-            elementList.append(MeshElement(nodeNA, nodeC, nodeNB, nodeList.count() - 1, marker - 1)); // marker conversion from triangle, where it starts from 1
-        }
-
-        labelMarkersCheck.insert(marker - 1);
+        if (!appendTriangleElement(nodes, parsedLine.at(7).toInt()))
+            return false;
     }
     int elementCountLinear = elementList.count();
 
-    // check for multiple label markers
-    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
-    {
-        // if (Agros2D::scene()->materials.indexOf(Agros2D::scene()->labels[i]->material) > 0)
-        {
-            //            if (!labelMarkersCheck.contains(i + 1))
-            //            {
-            //                emit message(tr("Label marker '%1' is not present in mesh file (multiple label markers in one area).").
-            //                             arg(i), true, 0);
-            //                return false;
-            //            }
-        }
-    }
-    labelMarkersCheck.clear();
-
-    // TODO: move
-    /*
-    if (elementList.count() < 1)
-    {
-        Agros2D::log()->printError(tr("Mesh generator"), tr("Invalid number of label markers"));
-        return false;
-    }
-    */
-
     // triangle neigh
     QString lineNeigh = inNeigh.readLine().trimmed();
     int numberOfNeigh = lineNeigh.split(whiteChar).at(0).toInt();
@@ -468,6 +609,11 @@ bool MeshGeneratorTriangle::readTriangleMeshFormat()
     fileEle.close();
     fileNeigh.close();
 
+    return convertTriangleMesh(edgeCountLinear, elementCountLinear);
+}
+
+bool MeshGeneratorTriangle::convertTriangleMesh(int edgeCountLinear, int elementCountLinear)
+{
     // heterogeneous mesh
     // element division
     if (Agros2D::problem()->config()->meshType() == MeshType_Triangle_QuadFineDivision)
@@ -38,7 +38,28 @@ public:
 
     virtual bool mesh();
 
+private:
+    // planar straight line graph (arcs are divided into segments), markers start from 1
+    struct TriangleGeometry
+    {
+        QList<Point> nodes;
+        QList<MeshEdge> segments;
+        QList<Point> holes;
+        QList<Point> regions;
+        QList<int> regionMarkers;
+        QList<double> regionAreas;
+    };
 
+    bool triangleGeometry(TriangleGeometry &geometry);
+
+    // Triangle linked as a library (no temporary files)
+    bool meshTriangleLibrary();
+    // external Triangle executable
+    bool meshTriangleProcess();
+
+    // element with vertices and 2nd order nodes (as returned by "-o2" switch), markers start from 1
+    bool appendTriangleElement(const int *nodes, int marker);
+    bool convertTriangleMesh(int edgeCountLinear, int elementCountLinear);
 };
 
 #endif //MESHGENERATOR_TRIANGLE_H
@@ -0,0 +1,590 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "expression.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // functions of one argument (math module and abs)
+    enum Function1
+    {
+        Function1_Sin, Function1_Cos, Function1_Tan, Function1_Asin, Function1_Acos, Function1_Atan,
+        Function1_Sinh, Function1_Cosh, Function1_Tanh, Function1_Exp, Function1_Log, Function1_Log10,
+        Function1_Sqrt, Function1_Fabs, Function1_Abs, Function1_Floor, Function1_Ceil,
+        Function1_Degrees, Function1_Radians
+    };
+
+    const char *functions1[] = { "sin", "cos", "tan", "asin", "acos", "atan",
+                                 "sinh", "cosh", "tanh", "exp", "log", "log10",
+                                 "sqrt", "fabs", "abs", "floor", "ceil",
+                                 "degrees", "radians", NULL };
+
+    // functions of two arguments (math module)
+    enum Function2
+    {
+        Function2_Atan2, Function2_Pow, Function2_Fmod, Function2_Hypot
+    };
+
+    const char *functions2[] = { "atan2", "pow", "fmod", "hypot", NULL };
+
+    int functionIndex(const char **functions, const QString &name)
+    {
+        for (int i = 0; functions[i] != NULL; i++)
+            if (name == functions[i])
+                return i;
+
+        return -1;
+    }
+
+    inline double function1(int index, double x)
+    {
+        switch (index)
+        {
+        case Function1_Sin: return sin(x);
+        case Function1_Cos: return cos(x);
+        case Function1_Tan: return tan(x);
+        case Function1_Asin: return asin(x);
+        case Function1_Acos: return acos(x);
+        case Function1_Atan: return atan(x);
+        case Function1_Sinh: return sinh(x);
+        case Function1_Cosh: return cosh(x);
+        case Function1_Tanh: return tanh(x);
+        case Function1_Exp: return exp(x);
+        case Function1_Log: return log(x);
+        case Function1_Log10: return log10(x);
+        case Function1_Sqrt: return sqrt(x);
+        case Function1_Fabs: return fabs(x);
+        case Function1_Abs: return fabs(x);
+        case Function1_Floor: return floor(x);
+        case Function1_Ceil: return ceil(x);
+        case Function1_Degrees: return x * 180.0 / M_PI;
+        case Function1_Radians: return x * M_PI / 180.0;
+        default:
+            assert(0);
+            return 0.0;
+        }
+    }
+
+    inline double function2(int index, double x, double y)
+    {
+        switch (index)
+        {
+        case Function2_Atan2: return atan2(x, y);
+        case Function2_Pow: return pow(x, y);
+        case Function2_Fmod: return fmod(x, y);
+        case Function2_Hypot: return sqrt(x*x + y*y);
+        default:
+            assert(0);
+            return 0.0;
+        }
+    }
+}
+
+CompiledExpression::CompiledExpression(QList<Token> tokens, const QStringList &variables, const QMap<QString, double> &constants)
+    : m_isValid(false), m_variables(variables), m_constants(constants), m_position(0), m_stackSize(0), m_stackDepth(0)
+{
+    // lexical analyser can join sign with the number (e.g. ")-1"), operator is resolved by the parser
+    foreach (Token token, tokens)
+    {
+        QString text = token.toString();
+        if ((token.type() == ParserTokenType_NUMBER) && (text.startsWith("-") || text.startsWith("+")))
+        {
+            m_tokens.append(Token(ParserTokenType_OPERATOR, text.left(1)));
+            m_tokens.append(Token(ParserTokenType_NUMBER, text.mid(1)));
+        }
+        else
+        {
+            m_tokens.append(token);
+        }
+    }
+
+    bool isInteger = false;
+    m_isValid = !m_tokens.isEmpty() && parseComparison(isInteger) && (m_position == m_tokens.count());
+
+    // tokens are not needed anymore
+    m_tokens.clear();
+    if (!m_isValid)
+        m_program.clear();
+}
+
+double CompiledExpression::evaluate(double x, double y, double time) const
+{
+    assert(m_isValid);
+
+    QVarLengthArray<double, 32> stack(m_stackSize);
+    double variables[3] = { x, y, time };
+
+    int top = -1;
+    for (int i = 0; i < m_program.size(); i++)
+    {
+        const Instruction &instruction = m_program.at(i);
+
+        switch (instruction.code)
+        {
+        case OpCode_Number:
+            stack[++top] = instruction.value;
+            break;
+        case OpCode_Variable:
+            stack[++top] = variables[instruction.index];
+            break;
+        case OpCode_Negate:
+            stack[top] = -stack[top];
+            break;
+        case OpCode_Add:
+            top--;
+            stack[top] += stack[top + 1];
+            break;
+        case OpCode_Subtract:
+            top--;
+            stack[top] -= stack[top + 1];
+            break;
+        case OpCode_Multiply:
+            top--;
+            stack[top] *= stack[top + 1];
+            break;
+        case OpCode_Divide:
+            top--;
+            stack[top] /= stack[top + 1];
+            break;
+        case OpCode_Power:
+            top--;
+            stack[top] = pow(stack[top], stack[top + 1]);
+            break;
+        case OpCode_Equal:
+            top--;
+            stack[top] = (stack[top] == stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_NotEqual:
+            top--;
+            stack[top] = (stack[top] != stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Less:
+            top--;
+            stack[top] = (stack[top] < stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_LessEqual:
+            top--;
+            stack[top] = (stack[top] <= stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Greater:
+            top--;
+            stack[top] = (stack[top] > stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_GreaterEqual:
+            top--;
+            stack[top] = (stack[top] >= stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Function1:
+            stack[top] = function1(instruction.index, stack[top]);
+            break;
+        case OpCode_Function2:
+            top--;
+            stack[top] = function2(instruction.index, stack[top], stack[top + 1]);
+            break;
+        case OpCode_Min:
+            top -= instruction.index - 1;
+            for (int j = 1; j < instruction.index; j++)
+                stack[top] = qMin(stack[top], stack[top + j]);
+            break;
+        case OpCode_Max:
+            top -= instruction.index - 1;
+            for (int j = 1; j < instruction.index; j++)
+                stack[top] = qMax(stack[top], stack[top + j]);
+            break;
+        default:
+            assert(0);
+        }
+    }
+
+    assert(top == 0);
+    return stack[0];
+}
+
+void CompiledExpression::evaluate(int count, const double *x, const double *y, const double *time, double *values) const
+{
+    assert(m_isValid);
+
+    if (count <= 0)
+        return;
+
+    // each instruction is dispatched once for all points, stack items are rows of count values
+    QVector<double> stack(m_stackSize * count);
+    const double *variables[3] = { x, y, time };
+
+    int top = -1;
+    for (int i = 0; i < m_program.size(); i++)
+    {
+        const Instruction &instruction = m_program.at(i);
+
+        double *a = NULL;
+        double *b = NULL;
+        switch (instruction.code)
+        {
+        case OpCode_Number:
+        case OpCode_Variable:
+            a = stack.data() + (++top) * count;
+            break;
+        case OpCode_Negate:
+        case OpCode_Function1:
+            a = stack.data() + top * count;
+            break;
+        case OpCode_Min:
+        case OpCode_Max:
+            top -= instruction.index - 1;
+            a = stack.data() + top * count;
+            break;
+        default:
+            top--;
+            a = stack.data() + top * count;
+            b = a + count;
+        }
+
+        switch (instruction.code)
+        {
+        case OpCode_Number:
+            for (int k = 0; k < count; k++)
+                a[k] = instruction.value;
+            break;
+        case OpCode_Variable:
+            memcpy(a, variables[instruction.index], count * sizeof(double));
+            break;
+        case OpCode_Negate:
+            for (int k = 0; k < count; k++)
+                a[k] = -a[k];
+            break;
+        case OpCode_Add:
+            for (int k = 0; k < count; k++)
+                a[k] += b[k];
+            break;
+        case OpCode_Subtract:
+            for (int k = 0; k < count; k++)
+                a[k] -= b[k];
+            break;
+        case OpCode_Multiply:
+            for (int k = 0; k < count; k++)
+                a[k] *= b[k];
+            break;
+        case OpCode_Divide:
+            for (int k = 0; k < count; k++)
+                a[k] /= b[k];
+            break;
+        case OpCode_Power:
+            for (int k = 0; k < count; k++)
+                a[k] = pow(a[k], b[k]);
+            break;
+        case OpCode_Equal:
+            for (int k = 0; k < count; k++)
+                a[k] = (a[k] == b[k]) ? 1.0 : 0.0;
+            break;
+        case OpCode_NotEqual:
+            for (int k = 0; k < count; k++)
+                a[k] = (a[k] != b[k]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Less:
+            for (int k = 0; k < count; k++)
+                a[k] = (a[k] < b[k]) ? 1.0 : 0.0;
+            break;
+        case OpCode_LessEqual:
+            for (int k = 0; k < count; k++)
+                a[k] = (a[k] <= b[k]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Greater:
+            for (int k = 0; k < count; k++)
+                a[k] = (a[k] > b[k]) ? 1.0 : 0.0;
+            break;
+        case OpCode_GreaterEqual:
+            for (int k = 0; k < count; k++)
+                a[k] = (a[k] >= b[k]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Function1:
+            for (int k = 0; k < count; k++)
+                a[k] = function1(instruction.index, a[k]);
+            break;
+        case OpCode_Function2:
+            for (int k = 0; k < count; k++)
+                a[k] = function2(instruction.index, a[k], b[k]);
+            break;
+        case OpCode_Min:
+            for (int j = 1; j < instruction.index; j++)
+                for (int k = 0; k < count; k++)
+                    a[k] = qMin(a[k], a[j * count + k]);
+            break;
+        case OpCode_Max:
+            for (int j = 1; j < instruction.index; j++)
+                for (int k = 0; k < count; k++)
+                    a[k] = qMax(a[k], a[j * count + k]);
+            break;
+        default:
+            assert(0);
+        }
+    }
+
+    assert(top == 0);
+    memcpy(values, stack.constData(), count * sizeof(double));
+}
+
+bool CompiledExpression::isOperator(const QString &op)
+{
+    return ((m_position < m_tokens.count()) &&
+            (m_tokens[m_position].type() == ParserTokenType_OPERATOR) &&
+            (m_tokens[m_position].toString() == op));
+}
+
+void CompiledExpression::append(const Instruction &instruction, int stackChange)
+{
+    m_program.append(instruction);
+
+    m_stackDepth += stackChange;
+    m_stackSize = qMax(m_stackSize, m_stackDepth);
+}
+
+bool CompiledExpression::parseComparison(bool &isInteger)
+{
+    if (!parseSum(isInteger))
+        return false;
+
+    static const char *operators[] = { "==", "!=", "<", "<=", ">", ">=", NULL };
+    static const OpCode codes[] = { OpCode_Equal, OpCode_NotEqual, OpCode_Less, OpCode_LessEqual, OpCode_Greater, OpCode_GreaterEqual };
+
+    for (int i = 0; operators[i] != NULL; i++)
+    {
+        if (isOperator(operators[i]))
+        {
+            m_position++;
+
+            bool isRightInteger = false;
+            if (!parseSum(isRightInteger))
+                return false;
+
+            append(Instruction(codes[i]), -1);
+
+            // result is bool
+            isInteger = true;
+
+            // chained comparisons are not supported
+            for (int j = 0; operators[j] != NULL; j++)
+                if (isOperator(operators[j]))
+                    return false;
+
+            return true;
+        }
+    }
+
+    return true;
+}
+
+bool CompiledExpression::parseSum(bool &isInteger)
+{
+    if (!parseProduct(isInteger))
+        return false;
+
+    while (isOperator("+") || isOperator("-"))
+    {
+        OpCode code = isOperator("+") ? OpCode_Add : OpCode_Subtract;
+        m_position++;
+
+        bool isRightInteger = false;
+        if (!parseProduct(isRightInteger))
+            return false;
+
+        append(Instruction(code), -1);
+        isInteger = isInteger && isRightInteger;
+    }
+
+    return true;
+}
+
+bool CompiledExpression::parseProduct(bool &isInteger)
+{
+    if (!parseUnary(isInteger))
+        return false;
+
+    while (isOperator("*") || isOperator("/"))
+    {
+        OpCode code = isOperator("*") ? OpCode_Multiply : OpCode_Divide;
+        m_position++;
+
+        bool isRightInteger = false;
+        if (!parseUnary(isRightInteger))
+            return false;
+
+        // integer division (Python 2) is left to Python
+        if ((code == OpCode_Divide) && isInteger && isRightInteger)
+            return false;
+
+        append(Instruction(code), -1);
+        isInteger = (code == OpCode_Multiply) && isInteger && isRightInteger;
+    }
+
+    return true;
+}
+
+bool CompiledExpression::parseUnary(bool &isInteger)
+{
+    if (isOperator("-") || isOperator("+"))
+    {
+        bool negate = isOperator("-");
+        m_position++;
+
+        if (!parseUnary(isInteger))
+            return false;
+
+        if (negate)
+            append(Instruction(OpCode_Negate), 0);
+
+        return true;
+    }
+
+    return parsePower(isInteger);
+}
+
+bool CompiledExpression::parsePower(bool &isInteger)
+{
+    if (!parsePrimary(isInteger))
+        return false;
+
+    // right associative, binds more tightly than unary operator on its left
+    if (isOperator("**"))
+    {
+        m_position++;
+
+        bool isRightInteger = false;
+        if (!parseUnary(isRightInteger))
+            return false;
+
+        append(Instruction(OpCode_Power), -1);
+        isInteger = isInteger && isRightInteger;
+    }
+
+    return true;
+}
+
+bool CompiledExpression::parsePrimary(bool &isInteger)
+{
+    if (m_position >= m_tokens.count())
+        return false;
+
+    Token token = m_tokens[m_position];
+    QString text = token.toString();
+
+    if (token.type() == ParserTokenType_NUMBER)
+    {
+        bool ok = false;
+        double value = text.toDouble(&ok);
+        if (!ok)
+            return false;
+
+        m_position++;
+        append(Instruction(OpCode_Number, value), 1);
+        isInteger = !(text.contains(".") || text.contains("e") || text.contains("E"));
+
+        return true;
+    }
+    else if (token.type() == ParserTokenType_VARIABLE)
+    {
+        int index = m_variables.indexOf(text);
+        if (index != -1)
+            append(Instruction(OpCode_Variable, 0.0, index), 1);
+        else if (m_constants.contains(text))
+            append(Instruction(OpCode_Number, m_constants[text]), 1);
+        else
+            // user variable (Python)
+            return false;
+
+        m_position++;
+        isInteger = false;
+
+        return true;
+    }
+    else if (token.type() == ParserTokenType_FUNCTION)
+    {
+        m_position++;
+        if (!isOperator("("))
+            return false;
+        m_position++;
+
+        // arguments
+        int count = 0;
+        bool isArgumentsInteger = true;
+        while (true)
+        {
+            bool isArgumentInteger = false;
+            if (!parseComparison(isArgumentInteger))
+                return false;
+
+            isArgumentsInteger = isArgumentsInteger && isArgumentInteger;
+            count++;
+
+            if (!isOperator(","))
+                break;
+            m_position++;
+        }
+
+        if (!isOperator(")"))
+            return false;
+        m_position++;
+
+        int index = functionIndex(functions1, text);
+        if ((index != -1) && (count == 1))
+        {
+            append(Instruction(OpCode_Function1, 0.0, index), 0);
+            isInteger = (index == Function1_Abs) && isArgumentsInteger;
+
+            return true;
+        }
+
+        index = functionIndex(functions2, text);
+        if ((index != -1) && (count == 2))
+        {
+            append(Instruction(OpCode_Function2, 0.0, index), -1);
+            isInteger = false;
+
+            return true;
+        }
+
+        if (((text == "min") || (text == "max")) && (count >= 2))
+        {
+            append(Instruction((text == "min") ? OpCode_Min : OpCode_Max, 0.0, count), - (count - 1));
+            isInteger = isArgumentsInteger;
+
+            return true;
+        }
+
+        // unknown function or number of arguments (Python)
+        return false;
+    }
+    else if ((token.type() == ParserTokenType_OPERATOR) && (text == "("))
+    {
+        m_position++;
+
+        if (!parseComparison(isInteger))
+            return false;
+
+        if (!isOperator(")"))
+            return false;
+        m_position++;
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,102 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include "lex.h"
+
+// Expression compiled from tokens of the lexical analyser to the bytecode of a simple stack machine.
+// Supported grammar is a subset of Python expressions: numbers, variables (coordinates and time),
+// constants (pi and e unless redefined by the user), operators + - * / ** (unary + -), single comparisons, parentheses
+// and functions of the math module (and abs, min, max).
+// Result is the same as in Python, expressions outside of the grammar (or integer division)
+// are not valid and have to be evaluated by Python.
+// Evaluation is reentrant and does not need Python interpreter.
+class AGROS_LIBRARY_API CompiledExpression
+{
+public:
+    // variables - names of the first coordinate, the second coordinate and the time (e.g. "x", "y", "time")
+    // constants - names compiled as numbers (other names have to be evaluated by Python)
+    CompiledExpression(QList<Token> tokens, const QStringList &variables, const QMap<QString, double> &constants = QMap<QString, double>());
+
+    inline bool isValid() const { return m_isValid; }
+
+    // result is not finite if expression cannot be evaluated (e.g. math domain error)
+    double evaluate(double x, double y, double time) const;
+    // batch evaluation (one program run for all points)
+    void evaluate(int count, const double *x, const double *y, const double *time, double *values) const;
+
+private:
+    enum OpCode
+    {
+        OpCode_Number,
+        OpCode_Variable,
+        OpCode_Negate,
+        OpCode_Add,
+        OpCode_Subtract,
+        OpCode_Multiply,
+        OpCode_Divide,
+        OpCode_Power,
+        OpCode_Equal,
+        OpCode_NotEqual,
+        OpCode_Less,
+        OpCode_LessEqual,
+        OpCode_Greater,
+        OpCode_GreaterEqual,
+        OpCode_Function1,
+        OpCode_Function2,
+        OpCode_Min,
+        OpCode_Max
+    };
+
+    struct Instruction
+    {
+        Instruction(OpCode code = OpCode_Number, double value = 0.0, int index = 0) : code(code), value(value), index(index) {}
+
+        OpCode code;
+        double value;
+        // variable, function or number of arguments
+        int index;
+    };
+
+    bool m_isValid;
+
+    QList<Token> m_tokens;
+    QStringList m_variables;
+    QMap<QString, double> m_constants;
+    int m_position;
+
+    QVector<Instruction> m_program;
+    int m_stackSize;
+    int m_stackDepth;
+
+    // recursive descent parser (emits bytecode), returns false if grammar is not supported
+    bool parseComparison(bool &isInteger);
+    bool parseSum(bool &isInteger);
+    bool parseProduct(bool &isInteger);
+    bool parseUnary(bool &isInteger);
+    bool parsePower(bool &isInteger);
+    bool parsePrimary(bool &isInteger);
+
+    bool isOperator(const QString &op);
+    void append(const Instruction &instruction, int stackChange);
+};
+
+#endif // EXPRESSION_H
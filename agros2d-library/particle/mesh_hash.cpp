@@ -75,7 +75,7 @@ void MeshHashElement::insert(Hermes::Hermes2D::Element *element)
 
 }
 
-Hermes::Hermes2D::Element* MeshHashElement::getElement(double x, double y)
+Hermes::Hermes2D::Element* MeshHashElement::getElement(double x, double y) const
 {
     if(m_active)
     {
@@ -133,7 +133,7 @@ void MeshHash::elementBoundingBox(Hermes::Hermes2D::Element *element, Point &p1,
 
 
 
-MeshHash::MeshHash(const Hermes::Hermes2D::MeshSharedPtr mesh)
+MeshHash::MeshHash(const Hermes::Hermes2D::MeshSharedPtr mesh) : m_mesh(mesh), m_lastElement(NULL)
 {
     // find bounding box of the whole mesh
     Point mesh_p1, mesh_p2;
@@ -232,8 +232,15 @@ MeshHash::~MeshHash()
 
 }
 
-Hermes::Hermes2D::Element* MeshHash::getElement(double x, double y)
+Hermes::Hermes2D::Element* MeshHash::getElement(double x, double y, Hermes::Hermes2D::Element* hint) const
 {
+    if(hint)
+    {
+        double x_ref, y_ref;
+        if(Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(hint, x, y, &x_ref, &y_ref))
+            return hint;
+    }
+
     int i = 0;
     while((i < GRID_SIZE) && (intervals_x[i+1] < x))
         i++;
@@ -248,3 +255,12 @@ Hermes::Hermes2D::Element* MeshHash::getElement(double x, double y)
     else
         return m_grid[i][j]->getElement(x,y);
 }
+
+Hermes::Hermes2D::Element* MeshHash::getElementCoherent(double x, double y)
+{
+    Hermes::Hermes2D::Element* element = getElement(x, y, m_lastElement);
+    if(element)
+        m_lastElement = element;
+
+    return element;
+}
@@ -3,6 +3,7 @@
 
 #include "util.h"
 #include "util/global.h"
+#include "hermes2d.h"
 
 namespace Hermes
 {
@@ -21,7 +22,7 @@ public:
     bool belongs(Hermes::Hermes2D::Element* element);
     void insert(Hermes::Hermes2D::Element* element);
 
-    Hermes::Hermes2D::Element* getElement(double x, double y);
+    Hermes::Hermes2D::Element* getElement(double x, double y) const;
 
 private:
     Point m_p1, m_p2;
@@ -36,6 +37,7 @@ private:
 
 #define GRID_SIZE  30
 
+// point location on the mesh, cached for each solution in SolutionStore
 class MeshHash
 {
 public:
@@ -46,13 +48,22 @@ public:
     // if we knew more about the shape of curvilinear element, this increase could be smaller
     static void elementBoundingBox(Hermes::Hermes2D::Element* element, Point& p1, Point& p2);
 
-    Hermes::Hermes2D::Element* getElement(double x, double y);
+    inline Hermes::Hermes2D::MeshSharedPtr mesh() const { return m_mesh; }
+
+    // reentrant, hint (e.g. element of the previous point) is tested first
+    Hermes::Hermes2D::Element* getElement(double x, double y, Hermes::Hermes2D::Element* hint = NULL) const;
+    // coherent walks (lines, trajectories), the last found element is tested first (not reentrant)
+    Hermes::Hermes2D::Element* getElementCoherent(double x, double y);
 
 private:
+    Hermes::Hermes2D::MeshSharedPtr m_mesh;
+
     MeshHashElement* m_grid[GRID_SIZE][GRID_SIZE];
 
     double intervals_x[GRID_SIZE + 1];
     double intervals_y[GRID_SIZE + 1];
+
+    Hermes::Hermes2D::Element* m_lastElement;
 };
 
 
@@ -18,6 +18,8 @@
 // Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
 
 #include "particle_tracing.h"
+#include "util/edge_hash.h"
+#include "mesh_hash.h"
 
 #include "util.h"
 #include "util/xml.h"
@@ -40,12 +42,105 @@
 #include "hermes2d/solutionstore.h"
 #include "hermes2d/problem_config.h"
 
-ParticleTracing::ParticleTracing(QObject *parent)
-    : QObject(parent)
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// reproducible random number from [0, 1) for the given particle and component
+// (counter based generator, does not depend on the order of tracing or the number of threads)
+static double particleRandom(int seed, int particle, int component)
+{
+    // splitmix64
+    quint64 z = (((quint64) (quint32) seed << 32) + (quint64) (4 * particle + component + 1)) * Q_UINT64_C(0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    z = z ^ (z >> 31);
+
+    return (z >> 11) / 9007199254740992.0;
+}
+
+// fields, solutions, materials, edges and settings read once before tracing
+// (shared by all tracing threads, read only during tracing)
+class ParticleTracingSnapshot
+{
+public:
+    struct Field
+    {
+        FieldInfo *fieldInfo;
+        int timeStep;
+        MultiArray<double> multiArray;
+        QSharedPointer<MeshHash> meshHash;
+        // hermes element marker -> material
+        QMap<int, SceneMaterial *> materials;
+    };
+
+    struct Edge
+    {
+        Point start;
+        Point end;
+        Point center;
+        double radius;
+        double angle;
+        // particle stops on the edge (no reflection)
+        bool impact;
+    };
+
+    ParticleTracingSnapshot();
+
+    QList<Field> fields;
+    QList<Edge> edges;
+    // spatial index of edges (built once per trace)
+    QSharedPointer<EdgeHash> edgeHash;
+
+    CoordinateType coordinateType;
+    Hermes::ButcherTableType butcherTableType;
+
+    double mass;
+    bool relativisticCorrection;
+    double constant;
+    Point3 forceCustom;
+    double dragDensity;
+    double dragCoefficient;
+    double dragReferenceArea;
+    double coefficientOfRestitution;
+
+    RectPoint bound;
+    double minStep;
+    double relErrorMin;
+    double relErrorMax;
+    int maximumNumberOfSteps;
+};
+
+ParticleTracingSnapshot::ParticleTracingSnapshot()
 {
+    ProblemSetting *setting = Agros2D::problem()->setting();
+
+    coordinateType = Agros2D::problem()->config()->coordinateType();
+    butcherTableType = (Hermes::ButcherTableType) setting->value(ProblemSetting::View_ParticleButcherTableType).toInt();
+
+    mass = setting->value(ProblemSetting::View_ParticleMass).toDouble();
+    relativisticCorrection = setting->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool();
+    constant = setting->value(ProblemSetting::View_ParticleConstant).toDouble();
+    forceCustom = Point3(setting->value(ProblemSetting::View_ParticleCustomForceX).toDouble(),
+                         setting->value(ProblemSetting::View_ParticleCustomForceY).toDouble(),
+                         setting->value(ProblemSetting::View_ParticleCustomForceZ).toDouble());
+    dragDensity = setting->value(ProblemSetting::View_ParticleDragDensity).toDouble();
+    dragCoefficient = setting->value(ProblemSetting::View_ParticleDragCoefficient).toDouble();
+    dragReferenceArea = setting->value(ProblemSetting::View_ParticleDragReferenceArea).toDouble();
+    coefficientOfRestitution = setting->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
+
+    bound = Agros2D::scene()->boundingBox();
+    minStep = (setting->value(ProblemSetting::View_ParticleMinimumStep).toDouble() > 0.0)
+            ? setting->value(ProblemSetting::View_ParticleMinimumStep).toDouble() :
+              min(bound.width(), bound.height()) / 80.0;
+    relErrorMin = (setting->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() > 0.0)
+            ? setting->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() / 100 : 1e-6;
+    relErrorMax = 1e-3;
+    maximumNumberOfSteps = setting->value(ProblemSetting::View_ParticleMaximumNumberOfSteps).toInt();
+
     foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
     {
-        if(!fieldInfo->plugin()->hasForce(fieldInfo))
+        if (!fieldInfo->plugin()->hasForce(fieldInfo))
             continue;
 
         // use solution on nearest time step, last adaptivity step possible and if exists, reference solution
@@ -53,74 +148,175 @@ ParticleTracing::ParticleTracing(QObject *parent)
         int adaptivityStep = Agros2D::solutionStore()->lastAdaptiveStep(fieldInfo, SolutionMode_Normal, timeStep);
         SolutionMode solutionMode = SolutionMode_Finer;
 
-        FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionMode);
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> sln = Agros2D::solutionStore()->multiArray(fsid).solutions().at(0);
+        Field field;
+        field.fieldInfo = fieldInfo;
+        field.timeStep = timeStep;
+        field.multiArray = Agros2D::solutionStore()->multiArray(FieldSolutionID(fieldInfo, timeStep, adaptivityStep, solutionMode));
+        field.meshHash = Agros2D::solutionStore()->meshHash(FieldSolutionID(fieldInfo, timeStep, adaptivityStep, solutionMode));
+
+        for (int labelIndex = 0; labelIndex < Agros2D::scene()->labels->count(); labelIndex++)
+        {
+            SceneMaterial *material = Agros2D::scene()->labels->at(labelIndex)->marker(fieldInfo);
+
+            Hermes::Hermes2D::Mesh::MarkersConversion::IntValid marker = fieldInfo->initialMesh()->get_element_markers_conversion().get_internal_marker(QString::number(labelIndex).toStdString());
+            if (marker.valid)
+                field.materials[marker.marker] = material;
+        }
 
-        m_solutionIDs[fieldInfo] = FieldSolutionID(fieldInfo, timeStep, adaptivityStep, solutionMode);
-        m_meshes[fieldInfo] = sln->get_mesh();
+        // update time functions
+        if (fieldInfo->analysisType() == AnalysisType_Transient)
+        {
+            QList<double> timeLevels = Agros2D::solutionStore()->timeLevels(fieldInfo);
+            Module::updateTimeFunctions(timeLevels[timeStep]);
+        }
+
+        fields.append(field);
     }
-}
 
-ParticleTracing::~ParticleTracing()
-{
+    foreach (SceneEdge *sceneEdge, Agros2D::scene()->edges->items())
+    {
+        Edge edge;
+        edge.start = sceneEdge->nodeStart()->point();
+        edge.end = sceneEdge->nodeEnd()->point();
+        edge.center = sceneEdge->center();
+        edge.radius = sceneEdge->radius();
+        edge.angle = sceneEdge->angle();
+
+        edge.impact = false;
+        foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+        {
+            if ((coefficientOfRestitution < EPS_ZERO) || // no reflection
+                    (sceneEdge->marker(fieldInfo) == Agros2D::scene()->boundaries->getNone(fieldInfo)
+                     && !setting->value(ProblemSetting::View_ParticleReflectOnDifferentMaterial).toBool()) || // inner edge
+                    (sceneEdge->marker(fieldInfo) != Agros2D::scene()->boundaries->getNone(fieldInfo)
+                     && !setting->value(ProblemSetting::View_ParticleReflectOnBoundary).toBool())) // boundary
+                edge.impact = true;
+        }
+
+        edges.append(edge);
+    }
+
+    QList<RectPoint> boxes;
+    foreach (Edge edge, edges)
+        boxes.append(EdgeHash::edgeBoundingBox(edge.start, edge.end, edge.center, edge.radius, edge.angle));
+    edgeHash = QSharedPointer<EdgeHash>(new EdgeHash(boxes));
 }
 
-void ParticleTracing::clear()
+// traces particles in one thread (solutions and materials are copied for each thread)
+class ParticleTracingSampler
 {
-    // clear lists
-    m_positionsList.clear();
-    m_velocitiesList.clear();
-    m_timesList.clear();
+public:
+    ParticleTracingSampler(const ParticleTracingSnapshot *snapshot, bool isThreadPrivate);
+    ~ParticleTracingSampler();
 
-    m_velocityMin =  numeric_limits<double>::max();
-    m_velocityMax = -numeric_limits<double>::max();
-}
+    void computeTrajectoryParticle(const Point3 &initialPosition, const Point3 &initialVelocity,
+                                   QList<Point3> &positionsList, QList<Point3> &velocitiesList, QList<double> &timesList);
+
+private:
+    const ParticleTracingSnapshot *m_snapshot;
+
+    QList<MultiArray<double> > m_multiArrays;
+    QVector<Hermes::Hermes2D::Element *> m_activeElement;
+
+    // hermes element marker -> material (private copies, values and data tables are not thread safe)
+    QList<QMap<int, SceneMaterial *> > m_materials;
+    QList<SceneMaterial *> m_materialCopies;
+
+    Point3 force(const Point3 &position, const Point3 &velocity);
 
-Point3 ParticleTracing::force(Point3 position,
-                              Point3 velocity)
+    bool newtonEquations(double step,
+                         const Point3 &position,
+                         const Point3 &velocity,
+                         Point3 *newposition,
+                         Point3 *newvelocity);
+};
+
+ParticleTracingSampler::ParticleTracingSampler(const ParticleTracingSnapshot *snapshot, bool isThreadPrivate)
+    : m_snapshot(snapshot), m_activeElement(snapshot->fields.count(), NULL)
 {
-    Point3 totalFieldForce;
-    foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+    foreach (ParticleTracingSnapshot::Field field, m_snapshot->fields)
     {
-        if(!fieldInfo->plugin()->hasForce(fieldInfo))
-            continue;
+        if (isThreadPrivate)
+        {
+            // copies are created in the calling thread (values are detached from the scene)
+            QMap<SceneMaterial *, SceneMaterial *> copies;
+            QMap<int, SceneMaterial *> materials;
+            foreach (int marker, field.materials.keys())
+            {
+                SceneMaterial *material = field.materials.value(marker);
+                if (material->isNone())
+                {
+                    materials[marker] = material;
+                    continue;
+                }
 
-        Point3 fieldForce;
+                if (!copies.contains(material))
+                {
+                    SceneMaterial *copy = new SceneMaterial(field.fieldInfo, material->name(), material->values());
+                    foreach (QString id, copy->values().keys())
+                        copy->value(id);
 
-        bool elementIsValid = false;
-        Hermes::Hermes2D::Element *activeElement = NULL;
+                    copies[material] = copy;
+                    m_materialCopies.append(copy);
+                }
 
-        // active element for current field
-        if (m_activeElement.contains(fieldInfo))
-            activeElement = m_activeElement[fieldInfo];
+                materials[marker] = copies[material];
+            }
 
-        if (activeElement)
+            m_materials.append(materials);
+        }
+        else
         {
-            double x_reference;
-            double y_reference;
-            elementIsValid = Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(activeElement,
-                                                                                          position.x, position.y, &x_reference, &y_reference);
+            m_materials.append(field.materials);
         }
 
-        if (!elementIsValid)
+        if (isThreadPrivate)
+        {
+            MultiArray<double> multiArray;
+            for (int comp = 0; comp < field.multiArray.size(); comp++)
+                multiArray.append(field.multiArray.spaces().at(comp),
+                                  Hermes::Hermes2D::MeshFunctionSharedPtr<double>(field.multiArray.solutions().at(comp)->clone()));
+
+            m_multiArrays.append(multiArray);
+        }
+        else
         {
-            m_activeElement[fieldInfo] = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(true, m_meshes[fieldInfo],
-                                                                                                   position.x, position.y);
+            m_multiArrays.append(field.multiArray);
         }
+    }
+}
+
+ParticleTracingSampler::~ParticleTracingSampler()
+{
+    qDeleteAll(m_materialCopies);
+}
+
+Point3 ParticleTracingSampler::force(const Point3 &position, const Point3 &velocity)
+{
+    Point3 totalFieldForce;
+    for (int i = 0; i < m_snapshot->fields.count(); i++)
+    {
+        const ParticleTracingSnapshot::Field &field = m_snapshot->fields.at(i);
+
+        Point3 fieldForce;
+
+        // active element for current field
+        Hermes::Hermes2D::Element *activeElement = m_activeElement[i];
+
+        // previous element is tested first
+        m_activeElement[i] = field.meshHash->getElement(position.x, position.y, activeElement);
 
         if (activeElement)
         {
             // find material
-            SceneLabel *label = Agros2D::scene()->labels->at(atoi(fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(activeElement->marker).marker.c_str()));
-            SceneMaterial* material = label->marker(fieldInfo);
+            SceneMaterial *material = m_materials[i].value(activeElement->marker);
 
-            assert(!material->isNone());
+            assert(material && !material->isNone());
 
             try
             {
-                fieldForce = fieldInfo->plugin()->force(fieldInfo, m_solutionIDs[fieldInfo].timeStep, m_solutionIDs[fieldInfo].adaptivityStep, m_solutionIDs[fieldInfo].solutionMode,
-                                                        activeElement, material, position, velocity)
-                        * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleConstant).toDouble();
+                fieldForce = field.fieldInfo->plugin()->force(field.fieldInfo, field.timeStep, m_multiArrays[i],
+                                                              activeElement, material, position, velocity) * m_snapshot->constant;
             }
             catch (AgrosException e)
             {
@@ -130,48 +326,44 @@ Point3 ParticleTracing::force(Point3 position,
         }
         totalFieldForce = totalFieldForce + fieldForce;
     }
-    // custom force
-    Point3 forceCustom = Point3(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceX).toDouble(),
-                                Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceY).toDouble(),
-                                Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceZ).toDouble());
 
     // Drag force
-    Point3 velocityReal = (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
+    Point3 velocityReal = (m_snapshot->coordinateType == CoordinateType_Planar) ?
                 velocity : Point3(velocity.x, velocity.y, position.x * velocity.z);
     Point3 forceDrag;
     if (velocityReal.magnitude() > 0.0)
         forceDrag = velocityReal.normalizePoint() *
-                - 0.5 * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragDensity).toDouble()
+                - 0.5 * m_snapshot->dragDensity
                 * velocityReal.magnitude() * velocityReal.magnitude()
-                * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragCoefficient).toDouble()
-                * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragReferenceArea).toDouble();
+                * m_snapshot->dragCoefficient
+                * m_snapshot->dragReferenceArea;
 
     // Total force
-    Point3 totalForce = totalFieldForce + forceDrag + forceCustom;
+    Point3 totalForce = totalFieldForce + forceDrag + m_snapshot->forceCustom;
 
     return totalForce;
 }
 
-bool ParticleTracing::newtonEquations(double step,
-                                      Point3 position,
-                                      Point3 velocity,
-                                      Point3 *newposition,
-                                      Point3 *newvelocity)
+bool ParticleTracingSampler::newtonEquations(double step,
+                                             const Point3 &position,
+                                             const Point3 &velocity,
+                                             Point3 *newposition,
+                                             Point3 *newvelocity)
 {
     // relativistic correction
-    double mass = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMass).toDouble();
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool())
+    double mass = m_snapshot->mass;
+    if (m_snapshot->relativisticCorrection)
     {
         if (velocity.magnitude() < SPEEDOFLIGHT)
             mass = mass / (sqrt(1.0 - (velocity.magnitude() * velocity.magnitude()) / (SPEEDOFLIGHT * SPEEDOFLIGHT)));
         else
-            throw AgrosException(tr("Velocity is greater then speed of light."));
+            throw AgrosException(QObject::tr("Velocity is greater then speed of light."));
     }
 
     // Total acceleration
     Point3 totalAccel = force(position, velocity) / mass;
 
-    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
+    if (m_snapshot->coordinateType == CoordinateType_Planar)
     {
         // position
         *newposition = velocity * step;
@@ -193,40 +385,34 @@ bool ParticleTracing::newtonEquations(double step,
     return true;
 }
 
-void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, const Point3 initialVelocity)
+void ParticleTracingSampler::computeTrajectoryParticle(const Point3 &initialPosition, const Point3 &initialVelocity,
+                                                       QList<Point3> &positionsList, QList<Point3> &velocitiesList, QList<double> &timesList)
 {
-    Hermes::ButcherTable butcher((Hermes::ButcherTableType) Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleButcherTableType).toInt());
+    Hermes::ButcherTable butcher(m_snapshot->butcherTableType);
     QVector<Point3> kp(butcher.get_size());
     QVector<Point3> kv(butcher.get_size());
 
-    clear();
-
-    QTime timePart;
-    timePart.start();
+    // the trajectory does not depend on previously traced particles
+    m_activeElement.fill(NULL);
 
     // initial position and velocity
     Point3 position = initialPosition;
     Point3 velocity = initialVelocity;
 
     // position and velocity cache
-    m_positionsList.append(position);
-    m_velocitiesList.append(velocity);
-    m_timesList.append(0);
-
-    RectPoint bound = Agros2D::scene()->boundingBox();
+    positionsList.append(position);
+    velocitiesList.append(velocity);
+    timesList.append(0);
 
-    double minStep = (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMinimumStep).toDouble() > 0.0)
-            ? Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMinimumStep).toDouble() :
-              min(bound.width(), bound.height()) / 80.0;
-    double relErrorMin = (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() > 0.0)
-            ? Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() / 100 : 1e-6;
-    double relErrorMax = 1e-3;
+    double minStep = m_snapshot->minStep;
+    double relErrorMin = m_snapshot->relErrorMin;
+    double relErrorMax = m_snapshot->relErrorMax;
     double dt = velocity.magnitude() > 0
-            ? qMax(bound.width(), bound.height()) / velocity.magnitude() / 10 : 1e-11;
+            ? qMax(m_snapshot->bound.width(), m_snapshot->bound.height()) / velocity.magnitude() / 10 : 1e-11;
 
     bool stopComputation = false;
     int maxStepsGlobal = 0;
-    while (!stopComputation && (maxStepsGlobal < Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumNumberOfSteps).toInt() - 1))
+    while (!stopComputation && (maxStepsGlobal < m_snapshot->maximumNumberOfSteps - 1))
     {
         maxStepsGlobal++;
 
@@ -276,9 +462,6 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
             double currentStepLength = (position - newPositionH).magnitude();
             double currentStepVelocity = (velocity - newVelocityH).magnitude();
 
-            // qDebug() << np5.toString();
-            // qDebug() << "abs. error: " << absError << ", rel. error: " << relError << ", time step: " << dt << "current step: " << currentStep;
-
             // zero step
             if (currentStepLength < EPS_ZERO && currentStepVelocity < EPS_ZERO)
             {
@@ -291,7 +474,6 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
             {
                 // decrease step
                 dt /= 3.0;
-                // qDebug() << "decreased" << dt;
                 continue;
             }
             // relative tolerance
@@ -299,52 +481,40 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
             {
                 // increase step
                 dt *= 1.1;
-                // qDebug() << "increased" << dt;
             }
             break;
         }
 
-        // check crossing
-        QMap<SceneEdge *, Point> intersections;
-        foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+        // check crossing (only edges close to the step) and find the closest intersection
+        Point intersect;
+        const ParticleTracingSnapshot::Edge *crossingEdge = NULL;
+        double distance = numeric_limits<double>::max();
+        foreach (int index, m_snapshot->edgeHash->candidates(Point(position.x, position.y), Point(newPositionH.x, newPositionH.y)))
         {
+            const ParticleTracingSnapshot::Edge &edge = m_snapshot->edges.at(index);
+
             QList<Point> incts = intersection(Point(position.x, position.y), Point(newPositionH.x, newPositionH.y),
                                               Point(), 0.0, 0.0,
-                                              edge->nodeStart()->point(), edge->nodeEnd()->point(),
-                                              edge->center(), edge->radius(), edge->angle());
+                                              edge.start, edge.end,
+                                              edge.center, edge.radius, edge.angle);
 
+            // the last intersection with the edge is used
             if (incts.length() > 0)
-                foreach (Point p, incts)
-                    intersections.insert(edge, p);
-        }
-
-        // find the closest intersection
-        Point intersect;
-        SceneEdge *crossingEdge = NULL;
-        double distance = numeric_limits<double>::max();
-        for (QMap<SceneEdge *, Point>::const_iterator it = intersections.begin(); it != intersections.end(); ++it)
-            if ((it.value() - Point(position.x, position.y)).magnitude() < distance)
             {
-                distance = (it.value() - Point(position.x, position.y)).magnitude();
+                Point p = incts.last();
+                if ((p - Point(position.x, position.y)).magnitude() < distance)
+                {
+                    distance = (p - Point(position.x, position.y)).magnitude();
 
-                crossingEdge = it.key();
-                intersect = it.value();
+                    crossingEdge = &edge;
+                    intersect = p;
+                }
             }
+        }
 
         if (crossingEdge && distance > EPS_ZERO)
         {
-            bool impact = false;
-            foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
-            {
-                if ((Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble() < EPS_ZERO) || // no reflection
-                        (crossingEdge->marker(fieldInfo) == Agros2D::scene()->boundaries->getNone(fieldInfo)
-                         && !Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleReflectOnDifferentMaterial).toBool()) || // inner edge
-                        (crossingEdge->marker(fieldInfo) != Agros2D::scene()->boundaries->getNone(fieldInfo)
-                         && !Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleReflectOnBoundary).toBool())) // boundary
-                    impact = true;
-            }
-
-            if(impact)
+            if (crossingEdge->impact)
             {
                 newPositionH.x = intersect.x;
                 newPositionH.y = intersect.y;
@@ -358,11 +528,11 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
 
                 // tangent vector
                 Point tangent;
-                if (crossingEdge->angle() > 0)
-                    tangent = (Point( (intersect.y - crossingEdge->center().y),
-                                      -(intersect.x - crossingEdge->center().x))).normalizePoint();
+                if (crossingEdge->angle > 0)
+                    tangent = (Point( (intersect.y - crossingEdge->center.y),
+                                      -(intersect.x - crossingEdge->center.x))).normalizePoint();
                 else
-                    tangent = (crossingEdge->nodeStart()->point() - crossingEdge->nodeEnd()->point()).normalizePoint();
+                    tangent = (crossingEdge->start - crossingEdge->end).normalizePoint();
 
                 Point idealReflectedPosition(intersect.x + (((tangent.x * tangent.x) - (tangent.y * tangent.y)) * vectin.x + 2.0*tangent.x*tangent.y * vectin.y),
                                              intersect.y + (2.0*tangent.x*tangent.y * vectin.x + ((tangent.y * tangent.y) - (tangent.x * tangent.x)) * vectin.y));
@@ -371,8 +541,6 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
                         / (Point(newPositionH.x, newPositionH.y) - Point(position.x, position.y)).magnitude();
 
                 // output point
-                // newPosition.x = intersect.x + (((tangent.x * tangent.x) - (tangent.y * tangent.y)) * vectin.x + 2.0*tangent.x*tangent.y * vectin.y);
-                // newPosition.y = intersect.y + (2.0*tangent.x*tangent.y * vectin.x + ((tangent.y * tangent.y) - (tangent.x * tangent.x)) * vectin.y);
                 newPositionH.x = intersect.x;
                 newPositionH.y = intersect.y;
 
@@ -381,13 +549,11 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
 
                 // velocity in the direction of output vector
                 Point3 oldv = newVelocityH;
-                newVelocityH.x = vectout.x * oldv.magnitude() * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
-                newVelocityH.y = vectout.y * oldv.magnitude() * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
+                newVelocityH.x = vectout.x * oldv.magnitude() * m_snapshot->coefficientOfRestitution;
+                newVelocityH.y = vectout.y * oldv.magnitude() * m_snapshot->coefficientOfRestitution;
 
                 // set new timestep
                 dt = dt * ratio;
-
-                // qDebug() << "newVelocity: " << newVelocity.toString() << ratio << dt;
             }
         }
 
@@ -396,26 +562,160 @@ void ParticleTracing::computeTrajectoryParticle(const Point3 initialPosition, co
         position = newPositionH;
 
         // add to the lists
-        m_timesList.append(m_timesList.last() + dt);
-        m_positionsList.append(position);
+        timesList.append(timesList.last() + dt);
+        positionsList.append(position);
 
-        if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-            m_velocitiesList.append(velocity);
+        if (m_snapshot->coordinateType == CoordinateType_Planar)
+            velocitiesList.append(velocity);
         else
-            m_velocitiesList.append(Point3(velocity.x, velocity.y, position.x * velocity.z)); // v_phi = omega * r
+            velocitiesList.append(Point3(velocity.x, velocity.y, position.x * velocity.z)); // v_phi = omega * r
 
         if (stopComputation)
             break;
     }
+}
+
+ParticleTracing::ParticleTracing(QObject *parent)
+    : QObject(parent)
+{
+    clear();
+}
 
-    // velocity min and max value
-    for (int i = 0; i < m_velocitiesList.length(); i++)
+ParticleTracing::~ParticleTracing()
+{
+}
+
+void ParticleTracing::clear()
+{
+    // clear lists
+    m_positionsList.clear();
+    m_velocitiesList.clear();
+    m_timesList.clear();
+
+    m_velocityMin =  numeric_limits<double>::max();
+    m_velocityMax = -numeric_limits<double>::max();
+}
+
+Point3 ParticleTracing::initialPosition(int particle, int seed)
+{
+    Point3 initialPosition;
+    initialPosition.x = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleStartX).toDouble();
+    initialPosition.y = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleStartY).toDouble();
+    initialPosition.z = 0.0;
+
+    // random point
+    if (particle > 0)
     {
-        double velocity = m_velocitiesList[i].magnitude();
+        double radius = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleStartingRadius).toDouble();
+        bool isPlanar = (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar);
+
+        Point3 dp(particleRandom(seed, particle, 0) * radius,
+                  particleRandom(seed, particle, 1) * radius,
+                  isPlanar ? 0.0 : particleRandom(seed, particle, 2) * 2.0*M_PI);
 
-        if (velocity < m_velocityMin) m_velocityMin = velocity;
-        if (velocity > m_velocityMax) m_velocityMax = velocity;
+        initialPosition = Point3(- radius / 2, - radius / 2, isPlanar ? 0.0 : -1.0*M_PI) + initialPosition + dp;
     }
 
-     //qDebug() << "total particle: " << timePart.elapsed();
+    return initialPosition;
+}
+
+Point3 ParticleTracing::initialVelocity()
+{
+    Point3 initialVelocity;
+    initialVelocity.x = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleStartVelocityX).toDouble();
+    initialVelocity.y = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleStartVelocityY).toDouble();
+    initialVelocity.z = 0.0;
+
+    return initialVelocity;
+}
+
+void ParticleTracing::computeTrajectoryParticle(const Point3 &initialPosition, const Point3 &initialVelocity)
+{
+    computeTrajectoryParticles(QList<Point3>() << initialPosition, QList<Point3>() << initialVelocity);
+}
+
+void ParticleTracing::computeTrajectoryParticles(int numberOfParticles, int seed)
+{
+    QList<Point3> initialPositions;
+    QList<Point3> initialVelocities;
+    for (int k = 0; k < numberOfParticles; k++)
+    {
+        initialPositions.append(initialPosition(k, seed));
+        initialVelocities.append(initialVelocity());
+    }
+
+    computeTrajectoryParticles(initialPositions, initialVelocities);
+}
+
+void ParticleTracing::computeTrajectoryParticles(const QList<Point3> &initialPositions, const QList<Point3> &initialVelocities)
+{
+    assert(initialPositions.count() == initialVelocities.count());
+
+    clear();
+
+    int numberOfParticles = initialPositions.count();
+    if (numberOfParticles == 0)
+        return;
+
+    ParticleTracingSnapshot snapshot;
+
+    // one sampler per thread (solutions are not shared between threads)
+    int numberOfThreads = qBound(1, Agros2D::configComputer()->numberOfThreads, numberOfParticles);
+    QList<ParticleTracingSampler *> samplers;
+    for (int i = 0; i < numberOfThreads; i++)
+        samplers.append(new ParticleTracingSampler(&snapshot, numberOfThreads > 1));
+
+    QVector<QList<Point3> > positions(numberOfParticles);
+    QVector<QList<Point3> > velocities(numberOfParticles);
+    QVector<QList<double> > times(numberOfParticles);
+    QVector<QString> errors(numberOfParticles);
+
+    QList<Point3> *positionsData = positions.data();
+    QList<Point3> *velocitiesData = velocities.data();
+    QList<double> *timesData = times.data();
+    QString *errorsData = errors.data();
+
+#pragma omp parallel for num_threads(numberOfThreads) schedule(dynamic)
+    for (int k = 0; k < numberOfParticles; k++)
+    {
+#ifdef _OPENMP
+        ParticleTracingSampler *sampler = samplers.at(omp_get_thread_num());
+#else
+        ParticleTracingSampler *sampler = samplers.at(0);
+#endif
+
+        try
+        {
+            sampler->computeTrajectoryParticle(initialPositions.at(k), initialVelocities.at(k),
+                                               positionsData[k], velocitiesData[k], timesData[k]);
+        }
+        catch (AgrosException& e)
+        {
+            errorsData[k] = e.what();
+        }
+        catch (...)
+        {
+            errorsData[k] = tr("Catched unknown exception in particle tracing");
+        }
+    }
+
+    qDeleteAll(samplers);
+
+    for (int k = 0; k < numberOfParticles; k++)
+        if (!errors.at(k).isEmpty())
+            throw AgrosException(errors.at(k));
+
+    for (int k = 0; k < numberOfParticles; k++)
+    {
+        m_positionsList.append(positions.at(k));
+        m_velocitiesList.append(velocities.at(k));
+        m_timesList.append(times.at(k));
+
+        // velocity min and max value
+        foreach (Point3 velocity, velocities.at(k))
+        {
+            if (velocity.magnitude() < m_velocityMin) m_velocityMin = velocity.magnitude();
+            if (velocity.magnitude() > m_velocityMax) m_velocityMax = velocity.magnitude();
+        }
+    }
 }
@@ -28,9 +28,6 @@
 
 #include "hermes2d/solutiontypes.h"
 
-class FieldInfo;
-class SceneMaterial;
-
 class ParticleTracing : public QObject
 {
     Q_OBJECT
@@ -41,39 +38,31 @@ public:
 
     void clear();
 
-    void computeTrajectoryParticle(const Point3 initialPosition, const Point3 initialVelocity);
+    // particles are traced in parallel (solutions, materials and settings are read once before tracing)
+    void computeTrajectoryParticles(const QList<Point3> &initialPositions, const QList<Point3> &initialVelocities);
+    // the first particle starts at the initial position, the others are spread over the starting radius
+    void computeTrajectoryParticles(int numberOfParticles, int seed = 0);
+    void computeTrajectoryParticle(const Point3 &initialPosition, const Point3 &initialVelocity);
+
+    // starting point of the particle (random offset depends only on the seed and the particle index)
+    static Point3 initialPosition(int particle, int seed = 0);
+    static Point3 initialVelocity();
 
-    inline QList<Point3> positions() const { return m_positionsList; }
-    inline QList<Point3> velocities() const { return m_velocitiesList; }
-    inline QList<double> times() const { return m_timesList; }
+    inline int numberOfParticles() const { return m_positionsList.count(); }
+    inline QList<QList<Point3> > positions() const { return m_positionsList; }
+    inline QList<QList<Point3> > velocities() const { return m_velocitiesList; }
+    inline QList<QList<double> > times() const { return m_timesList; }
 
     inline double velocityMin() const { return m_velocityMin; }
     inline double velocityMax() const { return m_velocityMax; }
 
 private:
-    QList<Point3> m_positionsList;
-    QList<Point3> m_velocitiesList;
-    QList<double> m_timesList;
+    QList<QList<Point3> > m_positionsList;
+    QList<QList<Point3> > m_velocitiesList;
+    QList<QList<double> > m_timesList;
 
     double m_velocityMin;
     double m_velocityMax;
-
-    QMap<FieldInfo *, FieldSolutionID> m_solutionIDs;
-    QMap<FieldInfo *, Hermes::Hermes2D::MeshSharedPtr> m_meshes;
-    QMap<FieldInfo *, Hermes::Hermes2D::Element *> m_activeElement;
-
-    Point3 force(Point3 position, Point3 velocity);
-
-    bool newtonEquations(double step,
-                         Point3 position,
-                         Point3 velocity,
-                         Point3 *newposition,
-                         Point3 *newvelocity);
-
-    int num_lookups;
-    int num_fails;
 };
 
-
-
 #endif /* PARTICLETRACING_H */
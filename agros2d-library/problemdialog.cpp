@@ -1113,7 +1113,9 @@ void ProblemWidget::createControls()
     cmbTransientMethod = new QComboBox();
     txtTransientOrder = new QSpinBox();
     txtTransientOrder->setMinimum(1);
-    txtTransientOrder->setMaximum(3);
+    txtTransientOrder->setMaximum(5);
+    chkTransientVariableOrder = new QCheckBox(tr("Variable order (up to the selected order)"));
+    cmbTransientErrorEstimate = new QComboBox();
     txtTransientTimeTotal = new LineEditDouble(1.0);
     txtTransientTimeTotal->setBottom(0.0);
     lblTransientTimeTotal = new QLabel("Total time");
@@ -1133,14 +1135,17 @@ void ProblemWidget::createControls()
     layoutTransientAnalysis->addWidget(cmbTransientMethod, 0, 1);
     layoutTransientAnalysis->addWidget(new QLabel(tr("Order:")), 1, 0);
     layoutTransientAnalysis->addWidget(txtTransientOrder, 1, 1);
-    layoutTransientAnalysis->addWidget(new QLabel(tr("Tolerance:")), 2, 0);
-    layoutTransientAnalysis->addWidget(txtTransientTolerance, 2, 1);
-    layoutTransientAnalysis->addWidget(lblTransientTimeTotal, 3, 0);
-    layoutTransientAnalysis->addWidget(txtTransientTimeTotal, 3, 1);
-    layoutTransientAnalysis->addWidget(lblTransientSteps, 4, 0);
-    layoutTransientAnalysis->addWidget(txtTransientSteps, 4, 1);
-    layoutTransientAnalysis->addWidget(new QLabel(tr("Constant time step:")), 5, 0);
-    layoutTransientAnalysis->addWidget(lblTransientTimeStep, 5, 1);
+    layoutTransientAnalysis->addWidget(chkTransientVariableOrder, 2, 1);
+    layoutTransientAnalysis->addWidget(new QLabel(tr("Error estimate:")), 3, 0);
+    layoutTransientAnalysis->addWidget(cmbTransientErrorEstimate, 3, 1);
+    layoutTransientAnalysis->addWidget(new QLabel(tr("Tolerance:")), 4, 0);
+    layoutTransientAnalysis->addWidget(txtTransientTolerance, 4, 1);
+    layoutTransientAnalysis->addWidget(lblTransientTimeTotal, 5, 0);
+    layoutTransientAnalysis->addWidget(txtTransientTimeTotal, 5, 1);
+    layoutTransientAnalysis->addWidget(lblTransientSteps, 6, 0);
+    layoutTransientAnalysis->addWidget(txtTransientSteps, 6, 1);
+    layoutTransientAnalysis->addWidget(new QLabel(tr("Constant time step:")), 7, 0);
+    layoutTransientAnalysis->addWidget(lblTransientTimeStep, 7, 1);
 
     grpTransientAnalysis = new QGroupBox(tr("Transient analysis"));
     grpTransientAnalysis->setLayout(layoutTransientAnalysis);
@@ -1200,6 +1205,9 @@ void ProblemWidget::fillComboBox()
     cmbTransientMethod->addItem(timeStepMethodString(TimeStepMethod_Fixed), TimeStepMethod_Fixed);
     cmbTransientMethod->addItem(timeStepMethodString(TimeStepMethod_BDFTolerance), TimeStepMethod_BDFTolerance);
     cmbTransientMethod->addItem(timeStepMethodString(TimeStepMethod_BDFNumSteps), TimeStepMethod_BDFNumSteps);
+
+    cmbTransientErrorEstimate->addItem(timeErrorEstimateString(TimeErrorEstimate_Embedded), TimeErrorEstimate_Embedded);
+    cmbTransientErrorEstimate->addItem(timeErrorEstimateString(TimeErrorEstimate_DoubleSolve), TimeErrorEstimate_DoubleSolve);
 }
 
 void ProblemWidget::updateControls()
@@ -1212,6 +1220,8 @@ void ProblemWidget::updateControls()
 
     cmbTransientMethod->disconnect();
     txtTransientOrder->disconnect();
+    chkTransientVariableOrder->disconnect();
+    cmbTransientErrorEstimate->disconnect();
     txtTransientTimeTotal->disconnect();
     txtTransientTolerance->disconnect();
     txtTransientSteps->disconnect();
@@ -1237,9 +1247,13 @@ void ProblemWidget::updateControls()
     txtTransientTolerance->setValue(Agros2D::problem()->config()->value(ProblemConfig::TimeMethodTolerance).toDouble());
     // txtTransientTimeTotal->setEnabled(Agros2D::problem()->isTransient());
     txtTransientOrder->setValue(Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
+    chkTransientVariableOrder->setChecked(Agros2D::problem()->config()->value(ProblemConfig::TimeOrderVariable).toBool());
     cmbTransientMethod->setCurrentIndex(cmbTransientMethod->findData((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()));
     if (cmbTransientMethod->currentIndex() == -1)
         cmbTransientMethod->setCurrentIndex(0);
+    cmbTransientErrorEstimate->setCurrentIndex(cmbTransientErrorEstimate->findData((TimeErrorEstimate) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimate).toInt()));
+    if (cmbTransientErrorEstimate->currentIndex() == -1)
+        cmbTransientErrorEstimate->setCurrentIndex(0);
 
     lblTransientTimeTotal->setText(QString("Total time (%1)").arg(Agros2D::problem()->timeUnit()));
 
@@ -1262,12 +1276,15 @@ void ProblemWidget::updateControls()
     connect(txtTransientSteps, SIGNAL(valueChanged(int)), this, SLOT(changedWithClear()));
     connect(txtTransientTimeTotal, SIGNAL(textChanged(QString)), this, SLOT(changedWithClear()));
     connect(txtTransientOrder, SIGNAL(valueChanged(int)), this, SLOT(changedWithClear()));
+    connect(chkTransientVariableOrder, SIGNAL(stateChanged(int)), this, SLOT(changedWithClear()));
+    connect(cmbTransientErrorEstimate, SIGNAL(currentIndexChanged(int)), this, SLOT(changedWithClear()));
     connect(txtTransientTolerance, SIGNAL(textChanged(QString)), this, SLOT(changedWithClear()));
 
     connect(cmbTransientMethod, SIGNAL(currentIndexChanged(int)), this, SLOT(transientChanged()));
     connect(txtTransientSteps, SIGNAL(valueChanged(int)), this, SLOT(transientChanged()));
     connect(txtTransientTimeTotal, SIGNAL(textChanged(QString)), this, SLOT(transientChanged()));
     connect(txtTransientOrder, SIGNAL(valueChanged(int)), this, SLOT(transientChanged()));
+    connect(chkTransientVariableOrder, SIGNAL(stateChanged(int)), this, SLOT(transientChanged()));
 }
 
 void ProblemWidget::changedWithClear()
@@ -1281,6 +1298,8 @@ void ProblemWidget::changedWithClear()
     Agros2D::problem()->config()->setValue(ProblemConfig::Frequency, txtFrequency->value());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethod, (TimeStepMethod) cmbTransientMethod->itemData(cmbTransientMethod->currentIndex()).toInt());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeOrder, txtTransientOrder->value());
+    Agros2D::problem()->config()->setValue(ProblemConfig::TimeOrderVariable, chkTransientVariableOrder->isChecked());
+    Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethodErrorEstimate, (TimeErrorEstimate) cmbTransientErrorEstimate->itemData(cmbTransientErrorEstimate->currentIndex()).toInt());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethodTolerance, txtTransientTolerance->value());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeConstantTimeSteps, txtTransientSteps->value());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeTotal, txtTransientTimeTotal->value());
@@ -1298,6 +1317,12 @@ void ProblemWidget::transientChanged()
 {
     lblTransientTimeStep->setText(QString("%1 %2").arg(txtTransientTimeTotal->value() / txtTransientSteps->value()).arg(Agros2D::problem()->timeUnit()));
 
+    // order is selected by the time adaptivity
+    chkTransientVariableOrder->setEnabled(Agros2D::problem()->config()->isTransientAdaptive());
+    // variable order always uses the embedded estimate
+    cmbTransientErrorEstimate->setEnabled(Agros2D::problem()->config()->isTransientAdaptive()
+                                          && !Agros2D::problem()->config()->value(ProblemConfig::TimeOrderVariable).toBool());
+
     if (((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()) == TimeStepMethod_BDFTolerance)
     {
         txtTransientTolerance->setEnabled(true);
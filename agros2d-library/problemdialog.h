@@ -246,6 +246,8 @@ private:
     LineEditDouble *txtTransientTolerance;
     QLabel *lblTransientTimeTotal;
     QSpinBox *txtTransientOrder;
+    QCheckBox *chkTransientVariableOrder;
+    QComboBox *cmbTransientErrorEstimate;
     QComboBox *cmbTransientMethod;
     QLabel *lblTransientTimeStep;
 
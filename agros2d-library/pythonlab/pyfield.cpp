@@ -535,6 +535,66 @@ void PyField::localValues(double x, double y, int timeStep, int adaptivityStep,
     results = values;
 }
 
+void PyField::localValuesBatch(const vector<double> &x, const vector<double> &y, int timeStep, int adaptivityStep,
+                               const std::string &solutionType, map<std::string, vector<double> > &results) const
+{
+    if (x.size() != y.size())
+        throw invalid_argument(QObject::tr("Coordinates must have the same size.").toStdString());
+
+    map<std::string, vector<double> > values;
+
+    if (Agros2D::problem()->isSolved())
+    {
+        QVector<Point> points(x.size());
+        for (int i = 0; i < points.size(); i++)
+            points[i] = Point(x[i], y[i]);
+
+        SolutionMode solutionMode = getSolutionMode(QString::fromStdString(solutionType));
+
+        // set time and adaptivity step if -1 (default parameter - last steps), check steps
+        timeStep = getTimeStep(timeStep, solutionMode);
+        adaptivityStep = getAdaptivityStep(adaptivityStep, timeStep, solutionMode);
+
+        QMap<QString, PointValueColumns> pointValues;
+        m_fieldInfo->plugin()->localValues(m_fieldInfo, timeStep, adaptivityStep, solutionMode, points, pointValues);
+
+        std::string labelX = Agros2D::problem()->config()->labelX().toLower().toStdString();
+        std::string labelY = Agros2D::problem()->config()->labelY().toLower().toStdString();
+
+        QMapIterator<QString, PointValueColumns> it(pointValues);
+        while (it.hasNext())
+        {
+            it.next();
+
+            Module::LocalVariable variable = m_fieldInfo->localVariable(it.key());
+            std::string shortname = variable.shortname().toStdString();
+
+            const PointValueColumns &columns = it.value();
+            if (variable.isScalar())
+            {
+                values[shortname].assign(columns.scalar.constBegin(), columns.scalar.constEnd());
+            }
+            else
+            {
+                vector<double> &magnitude = values[shortname];
+                vector<double> &vectorX = values[shortname + labelX];
+                vector<double> &vectorY = values[shortname + labelY];
+                vectorX.assign(columns.vectorX.constBegin(), columns.vectorX.constEnd());
+                vectorY.assign(columns.vectorY.constBegin(), columns.vectorY.constEnd());
+                magnitude.resize(vectorX.size());
+                for (int i = 0; i < vectorX.size(); i++)
+                    magnitude[i] = Point(vectorX[i], vectorY[i]).magnitude();
+            }
+        }
+    }
+    else
+    {
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+    }
+
+    results.swap(values);
+}
+
 void PyField::surfaceIntegrals(const vector<int> &edges, int timeStep, int adaptivityStep,
                                const std::string &solutionType, map<std::string, double> &results) const
 {
@@ -136,6 +136,8 @@ class PyField
         // local values, integrals
         void localValues(double x, double y, int timeStep, int adaptivityStep,
                          const std::string &solutionType, map<std::string, double> &results) const;
+        void localValuesBatch(const vector<double> &x, const vector<double> &y, int timeStep, int adaptivityStep,
+                              const std::string &solutionType, map<std::string, vector<double> > &results) const;
         void surfaceIntegrals(const vector<int> &edges, int timeStep, int adaptivityStep,
                               const std::string &solutionType, map<std::string, double> &results) const;
         void volumeIntegrals(const vector<int> &labels, int timeStep, int adaptivityStep,
@@ -29,6 +29,19 @@ void PyGeometry::activate()
         currentPythonEngineAgros()->sceneViewPreprocessor()->actSceneModePreprocessor->trigger();
 }
 
+void PyGeometry::beginBatch()
+{
+    Agros2D::scene()->beginBatch(QObject::tr("Python script"));
+}
+
+void PyGeometry::endBatch()
+{
+    if (!Agros2D::scene()->isBatch())
+        throw logic_error(QObject::tr("Batch of geometry changes is not started.").toStdString());
+
+    Agros2D::scene()->endBatch();
+}
+
 int PyGeometry::addNode(double x, double y)
 {
     if (!silentMode())
@@ -37,14 +50,14 @@ int PyGeometry::addNode(double x, double y)
     if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Axisymmetric && x < 0.0)
         throw out_of_range(QObject::tr("Radial component must be greater then or equal to zero.").toStdString());
 
-    foreach (SceneNode *node, Agros2D::scene()->nodes->items())
+    foreach (SceneNode *node, Agros2D::scene()->nodes->getAll(Point(x, y)))
     {
         if (node->point().x == x && node->point().y == y)
             throw logic_error(QObject::tr("Node already exist.").toStdString());
     }
 
     SceneNode *node = Agros2D::scene()->addNode(new SceneNode(Point(x, y)));
-    return Agros2D::scene()->nodes->items().indexOf(node);
+    return Agros2D::scene()->nodes->items().lastIndexOf(node);
 }
 
 int PyGeometry::addEdge(double x1, double y1, double x2, double y2, double angle, int segments, int isCurvilinear,
@@ -59,11 +72,15 @@ int PyGeometry::addEdge(double x1, double y1, double x2, double y2, double angle
     testAngle(angle);
     testSegments(segments);
 
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+    foreach (SceneNode *nodeStart, Agros2D::scene()->nodes->getAll(Point(x1, y1)))
     {
-        if (edge->nodeStart()->point().x == x1 && edge->nodeEnd()->point().x == x2 &&
-                edge->nodeStart()->point().y == y1 && edge->nodeEnd()->point().y == y2)
-            throw logic_error(QObject::tr("Edge already exist.").toStdString());
+        foreach (SceneNode *nodeEnd, Agros2D::scene()->nodes->getAll(Point(x2, y2)))
+        {
+            SceneEdge *edge = Agros2D::scene()->edges->get(nodeStart, nodeEnd);
+            if (edge && edge->nodeStart()->point().x == x1 && edge->nodeEnd()->point().x == x2 &&
+                    edge->nodeStart()->point().y == y1 && edge->nodeEnd()->point().y == y2)
+                throw logic_error(QObject::tr("Edge already exist.").toStdString());
+        }
     }
 
     SceneNode *nodeStart = new SceneNode(Point(x1, y1));
@@ -86,7 +103,7 @@ int PyGeometry::addEdge(double x1, double y1, double x2, double y2, double angle
 
     Agros2D::scene()->addEdge(edge);
 
-    return Agros2D::scene()->edges->items().indexOf(edge);
+    return Agros2D::scene()->edges->items().lastIndexOf(edge);
 }
 
 int PyGeometry::addEdgeByNodes(int nodeStartIndex, int nodeEndIndex, double angle, int segments, int isCurvilinear,
@@ -109,12 +126,8 @@ int PyGeometry::addEdgeByNodes(int nodeStartIndex, int nodeEndIndex, double angl
     testAngle(angle);
     testSegments(segments);
 
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-    {
-        if (Agros2D::scene()->nodes->items().indexOf(edge->nodeStart()) == nodeStartIndex &&
-                Agros2D::scene()->nodes->items().indexOf(edge->nodeEnd()) == nodeEndIndex)
-            throw logic_error(QObject::tr("Edge already exist.").toStdString());
-    }
+    if (Agros2D::scene()->edges->get(Agros2D::scene()->nodes->at(nodeStartIndex), Agros2D::scene()->nodes->at(nodeEndIndex)))
+        throw logic_error(QObject::tr("Edge already exist.").toStdString());
 
     SceneEdge *edge = new SceneEdge(Agros2D::scene()->nodes->at(nodeStartIndex), Agros2D::scene()->nodes->at(nodeEndIndex),
                                     angle, segments, isCurvilinear);
@@ -132,7 +145,7 @@ int PyGeometry::addEdgeByNodes(int nodeStartIndex, int nodeEndIndex, double angl
 
     Agros2D::scene()->addEdge(edge);
 
-    return Agros2D::scene()->edges->items().indexOf(edge);
+    return Agros2D::scene()->edges->items().lastIndexOf(edge);
 }
 
 void PyGeometry::modifyEdge(int index, double angle, int segments, int isCurvilinear, const map<std::string, int> &refinements, const map<std::string, std::string> &boundaries)
@@ -228,11 +241,9 @@ int PyGeometry::addLabel(double x, double y, double area, const map<std::string,
     if (area < 0.0)
         throw out_of_range(QObject::tr("Area must be positive.").toStdString());
 
-    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
-    {
-        if (label->point().x == x && label->point().y == y)
-            throw logic_error(QObject::tr("Label already exist.").toStdString());
-    }
+    SceneLabel *existing = Agros2D::scene()->labels->get(Point(x, y));
+    if (existing && existing->point().x == x && existing->point().y == y)
+        throw logic_error(QObject::tr("Label already exist.").toStdString());
 
     SceneLabel *label = new SceneLabel(Point(x, y), area);
 
@@ -250,7 +261,7 @@ int PyGeometry::addLabel(double x, double y, double area, const map<std::string,
 
     Agros2D::scene()->addLabel(label);
 
-    return Agros2D::scene()->labels->items().indexOf(label);
+    return Agros2D::scene()->labels->items().lastIndexOf(label);
 }
 
 void PyGeometry::modifyLabel(int index, double area, const map<std::string, int> &refinements,
@@ -43,6 +43,10 @@ class PyGeometry
         int addLabel(double x, double y, double area, const map<std::string, int> &refinements,
                      const map<std::string, int> &orders, const map<std::string, std::string> &materials);
 
+        // batch operations
+        void beginBatch();
+        void endBatch();
+
         inline int nodesCount() const { return Agros2D::scene()->nodes->count(); }
         inline int edgesCount() const { return Agros2D::scene()->edges->count(); }
         inline int labelsCount() const { return Agros2D::scene()->labels->count(); }
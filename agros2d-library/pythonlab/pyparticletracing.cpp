@@ -39,44 +39,85 @@ void PyParticleTracing::solve()
     initialVelocity.z = 0.0;
 
     ParticleTracing particleTracing;
-    particleTracing.computeTrajectoryParticle(initialPosition, initialVelocity);
+    try
+    {
+        particleTracing.computeTrajectoryParticle(initialPosition, initialVelocity);
+    }
+    catch (AgrosException& e)
+    {
+        throw logic_error(e.what().toStdString());
+    }
 
     m_positions = particleTracing.positions();
     m_velocities = particleTracing.velocities();
     m_times = particleTracing.times();
 }
 
+void PyParticleTracing::solveParticles(int seed)
+{
+    if (!Agros2D::problem()->isSolved())
+        throw invalid_argument(QObject::tr("Problem is not solved.").toStdString());
+
+    ParticleTracing particleTracing;
+    try
+    {
+        particleTracing.computeTrajectoryParticles(getNumberOfParticles(), seed);
+    }
+    catch (AgrosException& e)
+    {
+        throw logic_error(e.what().toStdString());
+    }
+
+    m_positions = particleTracing.positions();
+    m_velocities = particleTracing.velocities();
+    m_times = particleTracing.times();
+}
+
+void PyParticleTracing::checkParticle(int particle) const
+{
+    if (!m_positions.isEmpty() && (particle < 0 || particle >= m_positions.length()))
+        throw out_of_range(QObject::tr("Particle index must be between 0 and %1.").arg(m_positions.length() - 1).toStdString());
+}
+
 void PyParticleTracing::positions(vector<double> &x,
                                   vector<double> &y,
-                                  vector<double> &z) const
+                                  vector<double> &z,
+                                  int particle) const
 {
-    for (int i = 0; i < length(); i++)
+    checkParticle(particle);
+
+    for (int i = 0; i < length(particle); i++)
     {
-        x.push_back(m_positions[i].x);
-        y.push_back(m_positions[i].y);
-        z.push_back(m_positions[i].z);
+        x.push_back(m_positions[particle][i].x);
+        y.push_back(m_positions[particle][i].y);
+        z.push_back(m_positions[particle][i].z);
     }
 }
 
 void PyParticleTracing::velocities(vector<double> &x,
                                    vector<double> &y,
-                                   vector<double> &z) const
+                                   vector<double> &z,
+                                   int particle) const
 {
-    for (int i = 0; i < length(); i++)
+    checkParticle(particle);
+
+    for (int i = 0; i < length(particle); i++)
     {
-        x.push_back(m_velocities[i].x);
-        y.push_back(m_velocities[i].y);
-        z.push_back(m_velocities[i].z);
+        x.push_back(m_velocities[particle][i].x);
+        y.push_back(m_velocities[particle][i].y);
+        z.push_back(m_velocities[particle][i].z);
     }
 }
 
-void PyParticleTracing::times(vector<double> &time) const
+void PyParticleTracing::times(vector<double> &time, int particle) const
 {
     if (m_times.isEmpty())
         throw logic_error(QObject::tr("Trajectories of particles are not solved.").toStdString());
 
-    for (int i = 0; i < length(); i++)
-        time.push_back(m_times[i]);
+    checkParticle(particle);
+
+    for (int i = 0; i < length(particle); i++)
+        time.push_back(m_times[particle][i]);
 }
 
 void PyParticleTracing::getInitialPosition(vector<double> &position) const
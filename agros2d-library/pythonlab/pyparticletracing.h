@@ -121,18 +121,23 @@ public:
     inline int getNumShowParticlesAxi() const { return Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleNumShowParticlesAxi).toInt(); }
     void setNumShowParticlesAxi(int particles);
 
-    // solve
+    // solve (one particle from the initial position)
     void solve();
-    void positions(vector<double> &x, vector<double> &y, vector<double> &z) const;
-    void velocities(vector<double> &x, vector<double> &y, vector<double> &z) const;
-    void times(vector<double> &time) const;
-    inline int length() const { return m_positions.length(); }
+    // solve (number of particles in parallel, starting points given by the seed)
+    void solveParticles(int seed);
+    void positions(vector<double> &x, vector<double> &y, vector<double> &z, int particle = 0) const;
+    void velocities(vector<double> &x, vector<double> &y, vector<double> &z, int particle = 0) const;
+    void times(vector<double> &time, int particle = 0) const;
+    inline int length(int particle = 0) const { return (particle >= 0 && particle < m_positions.length()) ? m_positions[particle].length() : 0; }
+    inline int particles() const { return m_positions.length(); }
 
 private:
     // position and velocity
-    QList<Point3> m_positions;
-    QList<Point3> m_velocities;
-    QList<double> m_times;
+    QList<QList<Point3> > m_positions;
+    QList<QList<Point3> > m_velocities;
+    QList<QList<double> > m_times;
+
+    void checkParticle(int particle) const;
 };
 
 #endif // PYTHONLABPARTICLETRACING_H
@@ -82,12 +82,20 @@ void PyProblem::setTimeStepMethod(const std::string &timeStepMethod)
         throw invalid_argument(QObject::tr("Invalid argument. Valid keys: %1").arg(stringListToString(timeStepMethodStringKeys())).toStdString());
 }
 
+void PyProblem::setTimeMethodErrorEstimate(const std::string &timeErrorEstimate)
+{
+    if (timeErrorEstimateStringKeys().contains(QString::fromStdString(timeErrorEstimate)))
+        Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethodErrorEstimate, (TimeErrorEstimate) timeErrorEstimateFromStringKey(QString::fromStdString(timeErrorEstimate)));
+    else
+        throw invalid_argument(QObject::tr("Invalid argument. Valid keys: %1").arg(stringListToString(timeErrorEstimateStringKeys())).toStdString());
+}
+
 void PyProblem::setTimeMethodOrder(int timeMethodOrder)
 {
-    if (timeMethodOrder >= 1 && timeMethodOrder <= 3)
+    if (timeMethodOrder >= 1 && timeMethodOrder <= 5)
         Agros2D::problem()->config()->setValue(ProblemConfig::TimeOrder, timeMethodOrder);
     else
-        throw out_of_range(QObject::tr("Number of time method order must be greater then 1.").toStdString());
+        throw out_of_range(QObject::tr("Order of time method must be in the range from 1 to 5.").toStdString());
 }
 
 void PyProblem::setTimeMethodTolerance(double timeMethodTolerance)
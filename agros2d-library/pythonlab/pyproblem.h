@@ -55,10 +55,18 @@ class PyProblem
         inline int getTimeMethodOrder() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt(); }
         void setTimeMethodOrder(int timeMethodOrder);
 
+        // variable order of time method
+        inline bool getTimeMethodVariableOrder() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeOrderVariable).toBool(); }
+        inline void setTimeMethodVariableOrder(bool variableOrder) { Agros2D::problem()->config()->setValue(ProblemConfig::TimeOrderVariable, variableOrder); }
+
         // time method tolerance
         inline double getTimeMethodTolerance() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeMethodTolerance).toDouble(); }
         void setTimeMethodTolerance(double timeMethodTolerance);
 
+        // time method error estimate
+        inline std::string getTimeMethodErrorEstimate() const { return timeErrorEstimateToStringKey((TimeErrorEstimate) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimate).toInt()).toStdString(); }
+        void setTimeMethodErrorEstimate(const std::string &timeErrorEstimate);
+
         // time total
         inline double getTimeTotal() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeTotal).toDouble(); }
         void setTimeTotal(double timeTotal);
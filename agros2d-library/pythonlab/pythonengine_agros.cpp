@@ -35,6 +35,7 @@
 #endif
 
 #include "util/memory_monitor.h"
+#include "hermes2d/solutionstore.h"
 
 // current python engine agros
 AGROS_LIBRARY_API PythonEngineAgros *currentPythonEngineAgros()
@@ -281,6 +282,15 @@ QString createPythonFromModel(StartupScript_Type startupScript)
             str += QString("problem.time_steps = %5\n").
                     arg(Agros2D::problem()->config()->value(ProblemConfig::TimeConstantTimeSteps).toInt());
         }
+
+        if (((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()) != TimeStepMethod_Fixed)
+        {
+            str += QString("problem.time_method_error_estimate = \"%1\"\n").
+                    arg(timeErrorEstimateToStringKey((TimeErrorEstimate) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimate).toInt()));
+
+            if (Agros2D::problem()->config()->value(ProblemConfig::TimeOrderVariable).toBool())
+                str += QString("problem.time_method_variable_order = True\n");
+        }
     }
 
     // fields
@@ -747,6 +757,22 @@ void memoryUsage(std::vector<int> &time, std::vector<int> &usage)
     usage = Agros2D::memoryMonitor()->memoryUsage().toVector().toStdVector();
 }
 
+void cacheStatistics(std::map<std::string, double> &statistics)
+{
+    SolutionStore *store = Agros2D::solutionStore();
+
+    statistics["hits"] = store->cacheHits();
+    statistics["misses"] = store->cacheMisses();
+    statistics["evictions"] = store->cacheEvictions();
+    statistics["count"] = store->cacheCount();
+    statistics["memory"] = store->cacheMemory() / 1024.0 / 1024.0;
+}
+
+void cacheStatisticsReset()
+{
+    Agros2D::solutionStore()->resetCacheStatistics();
+}
+
 // ************************************************************************************
 
 void PyOptions::setNumberOfThreads(int threads)
@@ -759,8 +785,8 @@ void PyOptions::setNumberOfThreads(int threads)
 
 void PyOptions::setCacheSize(int size)
 {
-    if (size < 2 || size > 50)
-        throw out_of_range(QObject::tr("Cache size is out of range (2 - 50).").toStdString());
+    if (size < CACHE_SIZE_MIN || size > CACHE_SIZE_MAX)
+        throw out_of_range(QObject::tr("Cache size is out of range (%1 - %2 MB).").arg(CACHE_SIZE_MIN).arg(CACHE_SIZE_MAX).toStdString());
 
     Agros2D::configComputer()->cacheSize = size;
 }
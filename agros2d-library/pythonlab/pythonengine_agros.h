@@ -133,6 +133,10 @@ inline std::string getScriptFromModel() { return createPythonFromModel(StartupSc
 int appTime();
 void memoryUsage(std::vector<int> &time, std::vector<int> &usage);
 
+// solution cache
+void cacheStatistics(std::map<std::string, double> &statistics);
+void cacheStatisticsReset();
+
 struct PyOptions
 {
     // number of threads
@@ -147,6 +151,10 @@ struct PyOptions
     inline bool getSolverCache() const { return Agros2D::configComputer()->useSolverCache; }
     inline void setSolverCache(bool cache) { Agros2D::configComputer()->useSolverCache = cache; }
 
+    // Triangle linked as a library
+    inline bool getMeshTriangleLibrary() const { return Agros2D::configComputer()->meshTriangleLibrary; }
+    inline void setMeshTriangleLibrary(bool library) { Agros2D::configComputer()->meshTriangleLibrary = library; }
+
     // save matrix and rhs
     inline bool getSaveMatrixRHS() const { return Agros2D::configComputer()->saveMatrixRHS; }
     inline void setSaveMatrixRHS(bool save) { Agros2D::configComputer()->saveMatrixRHS = save; }
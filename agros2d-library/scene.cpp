@@ -24,6 +24,7 @@
 #include "util/global.h"
 #include "util/loops.h"
 #include "util/dxf_filter.h"
+#include "util/edge_hash.h"
 
 #include "util.h"
 #include "value.h"
@@ -159,8 +160,10 @@ Scene::Scene() : m_loopsInfo(NULL)
     labels = new SceneLabelContainer();
 
     m_loopsInfo = new LoopsInfo(this);
+    edges->setLoopsInfo(m_loopsInfo);
 
     m_stopInvalidating = false;
+    m_batchLevel = 0;
     clear();
 }
 
@@ -254,7 +257,8 @@ void Scene::createActions()
 SceneNode *Scene::addNode(SceneNode *node)
 {
     // clear solution
-    Agros2D::problem()->clearSolution();
+    if (!isBatch())
+        Agros2D::problem()->clearSolution();
 
     // check if node doesn't exists
     if (SceneNode* existing = nodes->get(node))
@@ -264,6 +268,12 @@ SceneNode *Scene::addNode(SceneNode *node)
     }
 
     nodes->add(node);
+    if (isBatch())
+    {
+        m_batchNodes.append(node);
+        return node;
+    }
+
     if (!currentPythonEngine()->isScriptRunning() && !m_stopInvalidating)
         emit invalidated();
 
@@ -280,7 +290,8 @@ SceneNode *Scene::getNode(const Point &point)
 SceneEdge *Scene::addEdge(SceneEdge *edge)
 {
     // clear solution
-    Agros2D::problem()->clearSolution();
+    if (!isBatch())
+        Agros2D::problem()->clearSolution();
 
     // check if edge doesn't exists
     if (SceneEdge* existing = edges->get(edge)){
@@ -289,6 +300,12 @@ SceneEdge *Scene::addEdge(SceneEdge *edge)
     }
 
     edges->add(edge);
+    if (isBatch())
+    {
+        m_batchEdges.append(edge);
+        return edge;
+    }
+
     if (!currentPythonEngine()->isScriptRunning() && !m_stopInvalidating)
         emit invalidated();
 
@@ -311,7 +328,8 @@ SceneEdge *Scene::getEdge(const Point &pointStart, const Point &pointEnd)
 SceneLabel *Scene::addLabel(SceneLabel *label)
 {
     // clear solution
-    Agros2D::problem()->clearSolution();
+    if (!isBatch())
+        Agros2D::problem()->clearSolution();
 
     // check if label doesn't exists
     if(SceneLabel* existing = labels->get(label)){
@@ -320,12 +338,137 @@ SceneLabel *Scene::addLabel(SceneLabel *label)
     }
 
     labels->add(label);
+    if (isBatch())
+    {
+        m_batchLabels.append(label);
+        return label;
+    }
+
     if (!currentPythonEngine()->isScriptRunning() && !m_stopInvalidating)
         emit invalidated();
 
     return label;
 }
 
+void Scene::beginBatch(const QString &name)
+{
+    // nested batches are merged to the outer one
+    if (m_batchLevel++ > 0)
+        return;
+
+    m_batchName = name;
+    clearBatch();
+}
+
+void Scene::endBatch()
+{
+    assert(m_batchLevel > 0);
+    if (--m_batchLevel > 0)
+        return;
+
+    // objects could be removed in the batch
+    QSet<SceneNode *> currentNodes = nodes->items().toSet();
+    QSet<SceneEdge *> currentEdges = edges->items().toSet();
+    QSet<SceneLabel *> currentLabels = labels->items().toSet();
+
+    // connection of nodes
+    foreach (SceneNode *node, m_batchNodes)
+        if (currentNodes.contains(node))
+            checkNodeConnect(node);
+    currentNodes = nodes->items().toSet();
+    currentEdges = edges->items().toSet();
+
+    QList<Point> nodePoints;
+    foreach (SceneNode *node, m_batchNodes)
+        if (currentNodes.contains(node))
+            nodePoints.append(node->point());
+
+    QList<Point> edgePointStarts;
+    QList<Point> edgePointEnds;
+    QList<double> edgeAngles;
+    QList<int> edgeSegments;
+    QList<bool> edgeIsCurvilinear;
+    QList<QMap<QString, QString> > edgeMarkers;
+    foreach (SceneEdge *edge, m_batchEdges)
+    {
+        if (currentEdges.contains(edge))
+        {
+            edgePointStarts.append(edge->nodeStart()->point());
+            edgePointEnds.append(edge->nodeEnd()->point());
+            edgeAngles.append(edge->angle());
+            edgeSegments.append(edge->segments());
+            edgeIsCurvilinear.append(edge->isCurvilinear());
+            edgeMarkers.append(edge->markersKeys());
+        }
+    }
+
+    QList<Point> labelPoints;
+    QList<QMap<QString, QString> > labelMarkers;
+    QList<double> labelAreas;
+    foreach (SceneLabel *label, m_batchLabels)
+    {
+        if (currentLabels.contains(label))
+        {
+            labelPoints.append(label->point());
+            labelMarkers.append(label->markersKeys());
+            labelAreas.append(label->area());
+        }
+    }
+
+    clearBatch();
+
+    if (nodePoints.isEmpty() && edgePointStarts.isEmpty() && labelPoints.isEmpty())
+        return;
+
+    // clear solution
+    Agros2D::problem()->clearSolution();
+
+    // one undo command for the whole batch (children are undone in reverse order)
+    SceneCommandBatch *command = new SceneCommandBatch(m_batchName);
+    if (!nodePoints.isEmpty())
+        new SceneNodeCommandAddMulti(nodePoints, command);
+    if (!edgePointStarts.isEmpty())
+        new SceneEdgeCommandAddMulti(edgePointStarts, edgePointEnds, edgeAngles, edgeSegments, edgeIsCurvilinear, edgeMarkers, command);
+    if (!labelPoints.isEmpty())
+        new SceneLabelCommandAddMulti(labelPoints, labelMarkers, labelAreas, command);
+    m_undoStack->push(command);
+
+    if (!currentPythonEngine()->isScriptRunning() && !m_stopInvalidating)
+        emit invalidated();
+}
+
+void Scene::clearBatch()
+{
+    m_batchNodes.clear();
+    m_batchEdges.clear();
+    m_batchLabels.clear();
+}
+
+void SceneCommandBatch::undo()
+{
+    Agros2D::scene()->blockSignals(true);
+    QUndoCommand::undo();
+    Agros2D::scene()->blockSignals(false);
+
+    Agros2D::scene()->invalidate();
+}
+
+void SceneCommandBatch::redo()
+{
+    // batch is done before the command is pushed to the undo stack
+    if (m_isDone)
+    {
+        m_isDone = false;
+        return;
+    }
+
+    Agros2D::scene()->blockSignals(true);
+    QUndoCommand::redo();
+    Agros2D::scene()->blockSignals(false);
+
+    Agros2D::scene()->invalidate();
+}
+
 SceneLabel *Scene::getLabel(const Point &point)
 {
     return labels->get(point);
@@ -463,9 +606,10 @@ void Scene::clear()
     materials->add(new SceneMaterialNone());
 
     // lying nodes
-    m_lyingEdgeNodes.clear();
-    m_numberOfConnectedNodeEdges.clear();
-    m_crossings.clear();
+    clearGeometryCheck();
+
+    // objects of the current batch were deleted
+    clearBatch();
 
     stopInvalidating(false);
     blockSignals(false);
@@ -857,9 +1001,7 @@ void Scene::doInvalidated()
 
     if (currentPythonEngineAgros() && !currentPythonEngineAgros()->isScriptRunning())
     {
-        findLyingEdgeNodes();
-        findNumberOfConnectedNodeEdges();
-        findCrossings();
+        checkGeometry();
     }
 }
 
@@ -2267,7 +2409,8 @@ void Scene::readSolutionFromFile(const QString &fileName)
         JlCompress::extractDir(solutionFile, cacheProblemDir());
 
         // read mesh file
-        if (QFile::exists(QString("%1/initial.msh").arg(cacheProblemDir())))
+        if (QFile::exists(QString("%1/initial.mesh").arg(cacheProblemDir())) ||
+                QFile::exists(QString("%1/initial.msh").arg(cacheProblemDir())))
         {
             try
             {
@@ -2304,6 +2447,10 @@ void Scene::writeSolutionToFile(const QString &fileName)
 {
     Agros2D::log()->printMessage(tr("Problem"), tr("Saving solution to disk"));
 
+    // all solution files have to be on the disk
+    Agros2D::solutionStore()->flush();
+    Agros2D::problem()->writeInitialMeshesToFile();
+
     QFileInfo fileInfo(fileName);
     QString solutionFN = QString("%1/%2.sol").arg(fileInfo.absolutePath()).arg(fileInfo.baseName());
     if (QFile(solutionFN).open(QIODevice::WriteOnly))
@@ -2315,7 +2462,7 @@ void Scene::writeSolutionToFile(const QString &fileName)
 void Scene::checkNodeConnect(SceneNode *node)
 {
     bool isConnected = false;
-    foreach (SceneNode *nodeCheck, this->nodes->items())
+    foreach (SceneNode *nodeCheck, this->nodes->getAll(node->point()))
     {
         if ((nodeCheck->distance(node->point()) < EPS_ZERO) && (nodeCheck != node))
         {
@@ -2402,17 +2549,178 @@ void Scene::checkGeometryResult()
     }
 }
 
-void Scene::findLyingEdgeNodes()
+bool Scene::CheckedEdge::isEqual(const SceneEdge *edge) const
+{
+    return ((nodeStart == edge->nodeStart()) && (nodeEnd == edge->nodeEnd()) &&
+            (start.x == edge->nodeStart()->point().x) && (start.y == edge->nodeStart()->point().y) &&
+            (end.x == edge->nodeEnd()->point().x) && (end.y == edge->nodeEnd()->point().y) &&
+            (angle == edge->angle()));
+}
+
+void Scene::clearGeometryCheck()
 {
     m_lyingEdgeNodes.clear();
+    m_lyingNodeEdges.clear();
+    m_numberOfConnectedNodeEdges.clear();
+    m_crossings.clear();
 
-    foreach (SceneEdge *edge, edges->items())
+    m_checkedEdges.clear();
+    m_checkedNodes.clear();
+    m_crossingEdges.clear();
+}
+
+void Scene::checkGeometry()
+{
+    QList<SceneEdge *> edgeList = edges->items();
+    QList<SceneNode *> nodeList = nodes->items();
+
+    // changed and new edges and nodes
+    QList<SceneEdge *> changedEdges;
+    QSet<SceneEdge *> actualEdges;
+    foreach (SceneEdge *edge, edgeList)
+    {
+        actualEdges.insert(edge);
+
+        QHash<SceneEdge *, CheckedEdge>::const_iterator it = m_checkedEdges.constFind(edge);
+        if (it == m_checkedEdges.constEnd() || !it.value().isEqual(edge))
+            changedEdges.append(edge);
+    }
+
+    QList<SceneNode *> changedNodes;
+    QSet<SceneNode *> actualNodes;
+    foreach (SceneNode *node, nodeList)
+    {
+        actualNodes.insert(node);
+
+        QHash<SceneNode *, Point>::const_iterator it = m_checkedNodes.constFind(node);
+        if (it == m_checkedNodes.constEnd() || it.value().x != node->point().x || it.value().y != node->point().y)
+            changedNodes.append(node);
+    }
+
+    // removed edges and nodes
+    QList<SceneEdge *> removedEdges;
+    foreach (SceneEdge *edge, m_checkedEdges.keys())
+        if (!actualEdges.contains(edge))
+            removedEdges.append(edge);
+
+    QList<SceneNode *> removedNodes;
+    foreach (SceneNode *node, m_checkedNodes.keys())
+        if (!actualNodes.contains(node))
+            removedNodes.append(node);
+
+    // large changes (new geometry, transformation of everything) are checked from scratch
+    if (changedEdges.count() + changedNodes.count() > (edgeList.count() + nodeList.count()) / 4)
+    {
+        clearGeometryCheck();
+        changedEdges = edgeList;
+        changedNodes = nodeList;
+        removedEdges.clear();
+        removedNodes.clear();
+    }
+
+    // forget results of changed and removed edges and nodes
+    foreach (SceneEdge *edge, removedEdges + changedEdges)
+    {
+        foreach (SceneEdge *edgeCheck, m_crossingEdges.value(edge))
+            m_crossingEdges[edgeCheck].remove(edge);
+        m_crossingEdges.remove(edge);
+
+        foreach (SceneNode *node, m_lyingEdgeNodes.values(edge))
+            m_lyingNodeEdges.remove(node, edge);
+        m_lyingEdgeNodes.remove(edge);
+
+        m_checkedEdges.remove(edge);
+    }
+
+    foreach (SceneNode *node, removedNodes + changedNodes)
+    {
+        foreach (SceneEdge *edge, m_lyingNodeEdges.values(node))
+            m_lyingEdgeNodes.remove(edge, node);
+        m_lyingNodeEdges.remove(node);
+
+        m_checkedNodes.remove(node);
+    }
+
+    // broad phase (uniform grid over bounding boxes of edges)
+    QList<RectPoint> boxes;
+    QHash<SceneEdge *, int> edgeIndex;
+    for (int i = 0; i < edgeList.count(); i++)
+    {
+        SceneEdge *edge = edgeList.at(i);
+
+        edgeIndex.insert(edge, i);
+        boxes.append(EdgeHash::edgeBoundingBox(edge->nodeStart()->point(), edge->nodeEnd()->point(),
+                                               edge->center(), edge->radius(), edge->angle()));
+    }
+    EdgeHash edgeHash(boxes);
+
+    findNumberOfConnectedNodeEdges();
+    findLyingEdgeNodes(changedEdges, changedNodes, edgeHash, edgeIndex);
+    findCrossings(changedEdges, edgeHash, edgeIndex);
+
+    // remember checked geometry
+    foreach (SceneEdge *edge, changedEdges)
+    {
+        CheckedEdge checked;
+        checked.nodeStart = edge->nodeStart();
+        checked.nodeEnd = edge->nodeEnd();
+        checked.start = edge->nodeStart()->point();
+        checked.end = edge->nodeEnd()->point();
+        checked.angle = edge->angle();
+
+        m_checkedEdges.insert(edge, checked);
+    }
+
+    foreach (SceneNode *node, changedNodes)
+        m_checkedNodes.insert(node, node->point());
+}
+
+void Scene::findLyingEdgeNodes(const QList<SceneEdge *> &changedEdges, const QList<SceneNode *> &changedNodes,
+                               const EdgeHash &edgeHash, const QHash<SceneEdge *, int> &edgeIndex)
+{
+    QList<SceneEdge *> edgeList = edges->items();
+    QList<SceneNode *> nodeList = nodes->items();
+
+    // isLyingOnNode() accepts nodes closer than sqrt(EPS_ZERO)
+    Point tolerance(sqrt(EPS_ZERO), sqrt(EPS_ZERO));
+
+    // changed edges against all nodes
+    if (!changedEdges.isEmpty())
+    {
+        QList<RectPoint> nodeBoxes;
+        foreach (SceneNode *node, nodeList)
+            nodeBoxes.append(RectPoint(node->point(), node->point()));
+        EdgeHash nodeHash(nodeBoxes);
+
+        foreach (SceneEdge *edge, changedEdges)
+        {
+            RectPoint box = edgeHash.box(edgeIndex.value(edge));
+            box.start = box.start - tolerance;
+            box.end = box.end + tolerance;
+
+            foreach (int index, nodeHash.candidates(box))
+            {
+                SceneNode *node = nodeList.at(index);
+                if (edge->isLyingOnNode(node))
+                {
+                    m_lyingEdgeNodes.insert(edge, node);
+                    m_lyingNodeEdges.insert(node, edge);
+                }
+            }
+        }
+    }
+
+    // changed nodes against unchanged edges
+    QSet<SceneEdge *> changed = changedEdges.toSet();
+    foreach (SceneNode *node, changedNodes)
     {
-        foreach (SceneNode *node, nodes->items())
+        foreach (int index, edgeHash.candidates(RectPoint(node->point() - tolerance, node->point() + tolerance)))
         {
-            if (edge->isLyingOnNode(node))
+            SceneEdge *edge = edgeList.at(index);
+            if (!changed.contains(edge) && edge->isLyingOnNode(node))
             {
                 m_lyingEdgeNodes.insert(edge, node);
+                m_lyingNodeEdges.insert(node, edge);
             }
         }
     }
@@ -2423,28 +2731,39 @@ void Scene::findNumberOfConnectedNodeEdges()
     m_numberOfConnectedNodeEdges.clear();
 
     foreach (SceneNode *node, nodes->items())
+        m_numberOfConnectedNodeEdges.insert(node, 0);
+
+    foreach (SceneEdge *edge, edges->items())
     {
-        int connections = 0;
-        foreach (SceneEdge *edge, edges->items())
-        {
-            if (edge->nodeStart() == node || edge->nodeEnd() == node)
-                connections++;
-        }
-        m_numberOfConnectedNodeEdges.insert(node, connections);
+        m_numberOfConnectedNodeEdges[edge->nodeStart()]++;
+        if (edge->nodeEnd() != edge->nodeStart())
+            m_numberOfConnectedNodeEdges[edge->nodeEnd()]++;
     }
 }
 
-void Scene::findCrossings()
+void Scene::findCrossings(const QList<SceneEdge *> &changedEdges,
+                          const EdgeHash &edgeHash, const QHash<SceneEdge *, int> &edgeIndex)
 {
-    m_crossings.clear();
+    QList<SceneEdge *> edgeList = edges->items();
+    QSet<SceneEdge *> changed = changedEdges.toSet();
 
-    for (int i = 0; i < edges->count(); i++)
+    foreach (SceneEdge *changedEdge, changedEdges)
     {
-        SceneEdge *edge = edges->at(i);
+        int index = edgeIndex.value(changedEdge);
 
-        for (int j = i + 1; j < edges->count(); j++)
+        // only edges with overlapping bounding boxes can cross
+        foreach (int candidate, edgeHash.candidates(edgeHash.box(index)))
         {
-            SceneEdge *edgeCheck = edges->at(j);
+            if (candidate == index)
+                continue;
+
+            // pair of two changed edges is checked only once
+            if ((candidate < index) && changed.contains(edgeList.at(candidate)))
+                continue;
+
+            // the same order of edges as in the check of all pairs
+            SceneEdge *edge = edgeList.at(qMin(index, candidate));
+            SceneEdge *edgeCheck = edgeList.at(qMax(index, candidate));
 
             QList<Point> intersects;
 
@@ -2463,11 +2782,14 @@ void Scene::findCrossings()
 
             if (intersects.count() > 0)
             {
-                if (!m_crossings.contains(edgeCheck))
-                    m_crossings.append(edgeCheck);
-                if (!m_crossings.contains((edge)))
-                    m_crossings.append(edge);
+                m_crossingEdges[edge].insert(edgeCheck);
+                m_crossingEdges[edgeCheck].insert(edge);
             }
         }
     }
+
+    m_crossings.clear();
+    foreach (SceneEdge *edge, edgeList)
+        if (!m_crossingEdges.value(edge).isEmpty())
+            m_crossings.append(edge);
 }
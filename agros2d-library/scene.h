@@ -37,6 +37,7 @@ class SceneBoundary;
 class SceneMaterial;
 struct SceneViewSettings;
 class LoopsInfo;
+class EdgeHash;
 
 class SceneNodeContainer;
 class SceneEdgeContainer;
@@ -75,6 +76,19 @@ private:
     QString field;
 };
 
+// undo command of the whole batch of geometry changes (changes are already done when the command is pushed)
+class SceneCommandBatch : public QUndoCommand
+{
+public:
+    SceneCommandBatch(const QString &text, QUndoCommand *parent = 0) : QUndoCommand(text, parent), m_isDone(true) {}
+
+    void undo();
+    void redo();
+
+private:
+    bool m_isDone;
+};
+
 class AGROS_LIBRARY_API Scene : public QObject
 {
     Q_OBJECT
@@ -165,9 +179,10 @@ public:
     void transformScale(const Point &point, double scaleFactor, bool copy, bool withMarkers);
 
     LoopsInfo *loopsInfo() const { return m_loopsInfo; }
-    QMultiMap<SceneEdge *, SceneNode *> lyingEdgeNodes() const { return m_lyingEdgeNodes; }
-    QMap<SceneNode *, int> numberOfConnectedNodeEdges() const { return m_numberOfConnectedNodeEdges; }
-    QList<SceneEdge *> crossings() const { return m_crossings; }
+    inline const QMultiMap<SceneEdge *, SceneNode *> &lyingEdgeNodes() const { return m_lyingEdgeNodes; }
+    inline const QMultiMap<SceneNode *, SceneEdge *> &lyingNodeEdges() const { return m_lyingNodeEdges; }
+    inline const QMap<SceneNode *, int> &numberOfConnectedNodeEdges() const { return m_numberOfConnectedNodeEdges; }
+    inline const QList<SceneEdge *> &crossings() const { return m_crossings; }
 
     inline void invalidate() { emit invalidated(); }
 
@@ -196,6 +211,12 @@ public:
 
     void stopInvalidating(bool sI) { m_stopInvalidating = sI;}
 
+    // batch of geometry changes (scripts, DXF import), clearing of the solution, checks of node connections
+    // and invalidation are postponed to endBatch(), objects added in the batch are undone by one command
+    void beginBatch(const QString &name);
+    void endBatch();
+    inline bool isBatch() const { return m_batchLevel > 0; }
+
 private:
     QUndoStack *m_undoStack;
 
@@ -206,9 +227,26 @@ private:
 
     LoopsInfo *m_loopsInfo;
     QMultiMap<SceneEdge *, SceneNode *> m_lyingEdgeNodes;
+    QMultiMap<SceneNode *, SceneEdge *> m_lyingNodeEdges;
     QMap<SceneNode *, int> m_numberOfConnectedNodeEdges;
     QList<SceneEdge *> m_crossings;
 
+    // geometry at the last check (only changed edges and nodes are checked again)
+    struct CheckedEdge
+    {
+        SceneNode *nodeStart;
+        SceneNode *nodeEnd;
+        Point start;
+        Point end;
+        double angle;
+
+        bool isEqual(const SceneEdge *edge) const;
+    };
+    QHash<SceneEdge *, CheckedEdge> m_checkedEdges;
+    QHash<SceneNode *, Point> m_checkedNodes;
+    // crossing edges of each edge
+    QHash<SceneEdge *, QSet<SceneEdge *> > m_crossingEdges;
+
     void createActions();
 
     Point calculateNewPoint(SceneTransformMode mode, Point originalPoint, Point transformationPoint, double angle, double scaleFactor);
@@ -221,12 +259,26 @@ private:
     void transform(QString name, SceneTransformMode mode, const Point &point, double angle, double scaleFactor, bool copy, bool withMarkers);
 
     // find lying nodes on edges, number of connected edges and crossings
-    void findLyingEdgeNodes();
+    void findLyingEdgeNodes(const QList<SceneEdge *> &changedEdges, const QList<SceneNode *> &changedNodes,
+                            const EdgeHash &edgeHash, const QHash<SceneEdge *, int> &edgeIndex);
     void findNumberOfConnectedNodeEdges();
-    void findCrossings();
+    void findCrossings(const QList<SceneEdge *> &changedEdges,
+                       const EdgeHash &edgeHash, const QHash<SceneEdge *, int> &edgeIndex);
+    // checks only edges and nodes changed since the last check
+    void checkGeometry();
+    void clearGeometryCheck();
 
     bool m_stopInvalidating;
 
+    // objects added in the current batch
+    int m_batchLevel;
+    QString m_batchName;
+    QList<SceneNode *> m_batchNodes;
+    QList<SceneEdge *> m_batchEdges;
+    QList<SceneLabel *> m_batchLabels;
+
+    void clearBatch();
+
 private slots:
     void doInvalidated();
 };
@@ -207,6 +207,93 @@ template class SceneBasicContainer<SceneNode>;
 template class SceneBasicContainer<SceneEdge>;
 template class SceneBasicContainer<SceneLabel>;
 
+template <typename BasicType>
+qint64 ScenePointIndex<BasicType>::snap(double value)
+{
+    // coordinates are equal within absolute (POINT_ABS_ZERO) or relative (POINT_REL_ZERO) tolerance,
+    // logarithmic scale (|value| > 1) turns the relative tolerance into the absolute one,
+    // so equal coordinates always lie in the same or in the neighbouring cells
+    if (!std::isfinite(value))
+        return 0;
+
+    double scaled = (fabs(value) <= 1.0) ? value : ((value > 0.0) ? 1.0 : -1.0) * (1.0 + log(fabs(value)));
+    return (qint64) floor(scaled / (2.0 * POINT_REL_ZERO));
+}
+
+template <typename BasicType>
+typename ScenePointIndex<BasicType>::Cell ScenePointIndex<BasicType>::cell(const Point &point)
+{
+    return Cell(snap(point.x), snap(point.y));
+}
+
+template <typename BasicType>
+void ScenePointIndex<BasicType>::insert(BasicType *item)
+{
+    if (m_cells.contains(item))
+        return;
+
+    Cell itemCell = cell(item->point());
+    m_items[itemCell].append(item);
+    m_cells.insert(item, itemCell);
+}
+
+template <typename BasicType>
+bool ScenePointIndex<BasicType>::remove(BasicType *item)
+{
+    typename QHash<BasicType *, Cell>::iterator it = m_cells.find(item);
+    if (it == m_cells.end())
+        return false;
+
+    typename QHash<Cell, QList<BasicType *> >::iterator itItems = m_items.find(it.value());
+    itItems.value().removeOne(item);
+    if (itItems.value().isEmpty())
+        m_items.erase(itItems);
+
+    m_cells.erase(it);
+
+    return true;
+}
+
+template <typename BasicType>
+void ScenePointIndex<BasicType>::update(BasicType *item)
+{
+    if (remove(item))
+        insert(item);
+}
+
+template <typename BasicType>
+void ScenePointIndex<BasicType>::clear()
+{
+    m_items.clear();
+    m_cells.clear();
+}
+
+template <typename BasicType>
+QList<BasicType *> ScenePointIndex<BasicType>::find(const Point &point) const
+{
+    QList<BasicType *> items;
+
+    Cell pointCell = cell(point);
+    for (int i = -1; i <= 1; i++)
+    {
+        for (int j = -1; j <= 1; j++)
+        {
+            typename QHash<Cell, QList<BasicType *> >::const_iterator it = m_items.constFind(Cell(pointCell.first + i, pointCell.second + j));
+            if (it == m_items.constEnd())
+                continue;
+
+            foreach (BasicType *item, it.value())
+                if (item->point() == point)
+                    items.append(item);
+        }
+    }
+
+    return items;
+}
+
+template class ScenePointIndex<SceneNode>;
+template class ScenePointIndex<SceneLabel>;
+
 template <typename MarkerType, typename MarkedSceneBasicType>
 MarkedSceneBasicContainer<MarkerType, MarkedSceneBasicType> MarkedSceneBasicContainer<MarkerType, MarkedSceneBasicType>::selected()
 {
@@ -78,7 +78,7 @@ public:
     inline int length() { return m_data.length(); }
     inline int count() {return length(); }
     inline int isEmpty() { return m_data.isEmpty(); }
-    void clear();
+    virtual void clear();
 
     /// selects or unselects all items
     void setSelected(bool value = true);
@@ -92,6 +92,32 @@ protected:
     QString containerName;
 };
 
+/// spatial hash of nodes or labels, lookup uses the tolerance of Point::operator==
+template <typename BasicType>
+class ScenePointIndex
+{
+public:
+    void insert(BasicType *item);
+    bool remove(BasicType *item);
+    /// moves item to the cell of its current point (if indexed)
+    void update(BasicType *item);
+    void clear();
+
+    inline int count() const { return m_cells.count(); }
+
+    /// returns all items with given coordinates
+    QList<BasicType *> find(const Point &point) const;
+
+private:
+    typedef QPair<qint64, qint64> Cell;
+
+    QHash<Cell, QList<BasicType *> > m_items;
+    QHash<BasicType *, Cell> m_cells;
+
+    static qint64 snap(double value);
+    static Cell cell(const Point &point);
+};
+
 Q_DECLARE_METATYPE(SceneBasic *)
 
 // *************************************************************************************************************************************
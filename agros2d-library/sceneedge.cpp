@@ -28,6 +28,7 @@
 #include "scenenode.h"
 #include "scenemarker.h"
 #include "scenemarkerdialog.h"
+#include "util/loops.h"
 
 #include "hermes2d/problem.h"
 #include "hermes2d/problem_config.h"
@@ -46,6 +47,22 @@ SceneEdge::SceneEdge(SceneNode *nodeStart, SceneNode *nodeEnd, double angle, int
     computeCenterAndRadius();
 }
 
+void SceneEdge::setNodeStart(SceneNode *nodeStart)
+{
+    m_nodeStart = nodeStart;
+    Agros2D::scene()->edges->updateNodes(this);
+
+    computeCenterAndRadius();
+}
+
+void SceneEdge::setNodeEnd(SceneNode *nodeEnd)
+{
+    m_nodeEnd = nodeEnd;
+    Agros2D::scene()->edges->updateNodes(this);
+
+    computeCenterAndRadius();
+}
+
 void SceneEdge::swapDirection()
 {
     SceneNode *tmp = m_nodeStart;
@@ -281,24 +298,160 @@ void SceneEdge::addMarkersFromStrings(QMap<QString, QString> markers)
 
 void SceneEdgeContainer::removeConnectedToNode(SceneNode *node)
 {
+    foreach (SceneEdge *edge, connectedEdges(node))
+    {
+        Agros2D::scene()->undoStack()->push(new SceneEdgeCommandRemove(edge->nodeStart()->point(),
+                                                                       edge->nodeEnd()->point(),
+                                                                       edge->markersKeys(),
+                                                                       edge->angle(),
+                                                                       edge->segments(),
+                                                                       edge->isCurvilinear()));
+    }
+
+}
+
+SceneEdgeContainer::NodePair SceneEdgeContainer::nodePair(SceneNode *nodeStart, SceneNode *nodeEnd)
+{
+    if ((quintptr) nodeStart < (quintptr) nodeEnd)
+        return NodePair(nodeStart, nodeEnd);
+    else
+        return NodePair(nodeEnd, nodeStart);
+}
+
+void SceneEdgeContainer::insertToIndex(SceneEdge *edge)
+{
+    if (m_edgeNodes.contains(edge))
+        return;
+
+    NodePair nodes(edge->nodeStart(), edge->nodeEnd());
+
+    m_nodePairIndex[nodePair(nodes.first, nodes.second)].append(edge);
+    m_nodeIndex[nodes.first].append(edge);
+    if (nodes.second != nodes.first)
+        m_nodeIndex[nodes.second].append(edge);
+
+    m_edgeNodes.insert(edge, nodes);
+
+    // planar graph of loops
+    if (m_loopsInfo)
+        m_loopsInfo->insertEdge(edge);
+}
+
+bool SceneEdgeContainer::removeFromIndex(SceneEdge *edge)
+{
+    QHash<SceneEdge *, NodePair>::iterator it = m_edgeNodes.find(edge);
+    if (it == m_edgeNodes.end())
+        return false;
+
+    NodePair nodes = it.value();
+
+    QHash<NodePair, QList<SceneEdge *> >::iterator itPair = m_nodePairIndex.find(nodePair(nodes.first, nodes.second));
+    itPair.value().removeOne(edge);
+    if (itPair.value().isEmpty())
+        m_nodePairIndex.erase(itPair);
+
+    foreach (SceneNode *node, QList<SceneNode *>() << nodes.first << nodes.second)
+    {
+        QHash<SceneNode *, QList<SceneEdge *> >::iterator itNode = m_nodeIndex.find(node);
+        if (itNode == m_nodeIndex.end())
+            continue;
+
+        itNode.value().removeOne(edge);
+        if (itNode.value().isEmpty())
+            m_nodeIndex.erase(itNode);
+    }
+
+    m_edgeNodes.erase(it);
+
+    // planar graph of loops
+    if (m_loopsInfo)
+        m_loopsInfo->removeEdge(edge, nodes.first, nodes.second);
+
+    return true;
+}
+
+QList<SceneEdge *> SceneEdgeContainer::candidates(SceneNode *nodeStart, SceneNode *nodeEnd) const
+{
+    if (isIndexed())
+        return m_nodePairIndex.value(nodePair(nodeStart, nodeEnd));
+    else
+        return m_data;
+}
+
+QList<SceneEdge *> SceneEdgeContainer::candidates(const Point &pointStart, const Point &pointEnd) const
+{
+    if (!isIndexed())
+        return m_data;
+
+    // end nodes are found in the spatial index of the scene nodes
+    QList<SceneEdge *> edges;
+    foreach (SceneNode *nodeStart, Agros2D::scene()->nodes->getAll(pointStart))
+        foreach (SceneNode *nodeEnd, Agros2D::scene()->nodes->getAll(pointEnd))
+            edges.append(m_nodePairIndex.value(nodePair(nodeStart, nodeEnd)));
+
+    return edges;
+}
+
+bool SceneEdgeContainer::add(SceneEdge *item)
+{
+    insertToIndex(item);
+
+    return MarkedSceneBasicContainer<SceneBoundary, SceneEdge>::add(item);
+}
+
+bool SceneEdgeContainer::remove(SceneEdge *item)
+{
+    removeFromIndex(item);
+
+    return MarkedSceneBasicContainer<SceneBoundary, SceneEdge>::remove(item);
+}
+
+void SceneEdgeContainer::clear()
+{
+    m_nodePairIndex.clear();
+    m_nodeIndex.clear();
+    m_edgeNodes.clear();
+
+    // planar graph of loops
+    if (m_loopsInfo)
+        m_loopsInfo->clearEdges();
+
+    MarkedSceneBasicContainer<SceneBoundary, SceneEdge>::clear();
+}
+
+void SceneEdgeContainer::updateNodes(SceneEdge *edge)
+{
+    if (removeFromIndex(edge))
+        insertToIndex(edge);
+}
+
+QList<SceneEdge *> SceneEdgeContainer::connectedEdges(SceneNode *node) const
+{
+    if (isIndexed())
+        return m_nodeIndex.value(node);
+
+    QList<SceneEdge *> edges;
     foreach (SceneEdge *edge, m_data)
+        if (edge->nodeStart() == node || edge->nodeEnd() == node)
+            edges.append(edge);
+
+    return edges;
+}
+
+SceneEdge* SceneEdgeContainer::get(SceneNode *nodeStart, SceneNode *nodeEnd) const
+{
+    foreach (SceneEdge *edgeCheck, candidates(nodeStart, nodeEnd))
     {
-        if ((edge->nodeStart() == node) || (edge->nodeEnd() == node))
-        {
-            Agros2D::scene()->undoStack()->push(new SceneEdgeCommandRemove(edge->nodeStart()->point(),
-                                                                           edge->nodeEnd()->point(),
-                                                                           edge->markersKeys(),
-                                                                           edge->angle(),
-                                                                           edge->segments(),
-                                                                           edge->isCurvilinear()));
-        }
+        if ((edgeCheck->nodeStart() == nodeStart) && (edgeCheck->nodeEnd() == nodeEnd))
+            return edgeCheck;
     }
 
+    return NULL;
 }
 
 SceneEdge* SceneEdgeContainer::get(SceneEdge* edge) const
 {
-    foreach (SceneEdge *edgeCheck, m_data)
+    foreach (SceneEdge *edgeCheck, candidates(edge->nodeStart(), edge->nodeEnd()))
     {
         if (((((edgeCheck->nodeStart() == edge->nodeStart()) && (edgeCheck->nodeEnd() == edge->nodeEnd())) &&
               (fabs(edgeCheck->angle() - edge->angle()) < EPS_ZERO)) ||
@@ -314,7 +467,7 @@ SceneEdge* SceneEdgeContainer::get(SceneEdge* edge) const
 
 SceneEdge* SceneEdgeContainer::get(const Point &pointStart, const Point &pointEnd, double angle, int segments, bool isCurvilinear) const
 {
-    foreach (SceneEdge *edgeCheck, m_data)
+    foreach (SceneEdge *edgeCheck, candidates(pointStart, pointEnd))
     {
         if (((edgeCheck->nodeStart()->point() == pointStart) && (edgeCheck->nodeEnd()->point() == pointEnd))
                 && ((edgeCheck->angle() - angle) < EPS_ZERO) && (edgeCheck->segments() == segments) && (edgeCheck->isCurvilinear() == isCurvilinear))
@@ -326,7 +479,7 @@ SceneEdge* SceneEdgeContainer::get(const Point &pointStart, const Point &pointEn
 
 SceneEdge* SceneEdgeContainer::get(const Point &pointStart, const Point &pointEnd) const
 {
-    foreach (SceneEdge *edgeCheck, m_data)
+    foreach (SceneEdge *edgeCheck, candidates(pointStart, pointEnd))
     {
         if (((edgeCheck->nodeStart()->point() == pointStart) && (edgeCheck->nodeEnd()->point() == pointEnd)))
             return edgeCheck;
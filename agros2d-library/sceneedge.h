@@ -24,6 +24,7 @@
 #include "scenebasic.h"
 #include "scenemarkerdialog.h"
 
+class LoopsInfo;
 class SceneEdgeCommandAdd;
 class SceneEdgeCommandRemove;
 
@@ -33,9 +34,9 @@ public:
     SceneEdge(SceneNode *nodeStart, SceneNode *nodeEnd, double angle, int segments = 3, bool isCurvilinear = true);
 
     inline SceneNode *nodeStart() const { return m_nodeStart; }
-    inline void setNodeStart(SceneNode *nodeStart) { m_nodeStart = nodeStart; computeCenterAndRadius(); }
+    void setNodeStart(SceneNode *nodeStart);
     inline SceneNode *nodeEnd() const { return m_nodeEnd; }
-    inline void setNodeEnd(SceneNode *nodeEnd) { m_nodeEnd = nodeEnd; computeCenterAndRadius(); }
+    void setNodeEnd(SceneNode *nodeEnd);
     inline double angle() const { return m_angle; }
     inline void setAngle(double angle) { m_angle = angle; computeCenterAndRadius(); }
     void swapDirection();
@@ -93,6 +94,11 @@ Q_DECLARE_METATYPE(SceneEdge *)
 class SceneEdgeContainer : public MarkedSceneBasicContainer<SceneBoundary, SceneEdge>
 {
 public:
+    SceneEdgeContainer() : m_loopsInfo(NULL) {}
+
+    /// planar graph of loops updated with the edges
+    inline void setLoopsInfo(LoopsInfo *loopsInfo) { m_loopsInfo = loopsInfo; }
+
     void removeConnectedToNode(SceneNode* node);
 
     /// if container contains the same edge, returns it. Otherwise returns NULL
@@ -104,9 +110,40 @@ public:
     /// returns corresponding edge or NULL
     SceneEdge* get(const Point &pointStart, const Point &pointEnd) const;
 
+    /// returns edge from nodeStart to nodeEnd or NULL
+    SceneEdge* get(SceneNode *nodeStart, SceneNode *nodeEnd) const;
+
+    /// returns edges connected to node
+    QList<SceneEdge *> connectedEdges(SceneNode *node) const;
+
+    virtual bool add(SceneEdge *item);
+    virtual bool remove(SceneEdge *item);
+    virtual void clear();
+
+    /// updates index of the edge with changed nodes
+    void updateNodes(SceneEdge *edge);
+
     /// returns bounding box, assumes container not empty
     RectPoint boundingBox() const;
     static RectPoint boundingBox(QList<SceneEdge *> edges);
+
+private:
+    typedef QPair<SceneNode *, SceneNode *> NodePair;
+
+    // edges indexed by (unordered) pair of end nodes and by each end node
+    QHash<NodePair, QList<SceneEdge *> > m_nodePairIndex;
+    QHash<SceneNode *, QList<SceneEdge *> > m_nodeIndex;
+    QHash<SceneEdge *, NodePair> m_edgeNodes;
+
+    LoopsInfo *m_loopsInfo;
+
+    static NodePair nodePair(SceneNode *nodeStart, SceneNode *nodeEnd);
+    void insertToIndex(SceneEdge *edge);
+    bool removeFromIndex(SceneEdge *edge);
+    QList<SceneEdge *> candidates(SceneNode *nodeStart, SceneNode *nodeEnd) const;
+    QList<SceneEdge *> candidates(const Point &pointStart, const Point &pointEnd) const;
+
+    inline bool isIndexed() const { return m_edgeNodes.count() == m_data.count(); }
 };
 
 // *************************************************************************************************************************************
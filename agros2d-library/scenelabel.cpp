@@ -44,6 +44,12 @@ SceneLabel::SceneLabel(const Point &point, double area)
     }
 }
 
+void SceneLabel::setPoint(const Point &point)
+{
+    m_point = point;
+    Agros2D::scene()->labels->updatePoint(this);
+}
+
 double SceneLabel::distance(const Point &point) const
 {
     return (this->point() - point).magnitude();
@@ -145,19 +151,17 @@ void SceneLabel::addMarkersFromStrings(QMap<QString, QString> markers)
 
 SceneLabel* SceneLabelContainer::get(SceneLabel *label) const
 {
-    foreach (SceneLabel *labelCheck, m_data)
-    {
-        if (labelCheck->point() == label->point())
-        {
-            return labelCheck;
-        }
-    }
-
-    return NULL;
+    return get(label->point());
 }
 
 SceneLabel* SceneLabelContainer::get(const Point& point) const
 {
+    if (isIndexed())
+    {
+        QList<SceneLabel *> labels = m_index.find(point);
+        return labels.isEmpty() ? NULL : labels.first();
+    }
+
     foreach (SceneLabel *labelCheck, m_data)
     {
         if (labelCheck->point() == point)
@@ -167,6 +171,32 @@ SceneLabel* SceneLabelContainer::get(const Point& point) const
     return NULL;
 }
 
+bool SceneLabelContainer::add(SceneLabel *item)
+{
+    m_index.insert(item);
+
+    return MarkedSceneBasicContainer<SceneMaterial, SceneLabel>::add(item);
+}
+
+bool SceneLabelContainer::remove(SceneLabel *item)
+{
+    m_index.remove(item);
+
+    return MarkedSceneBasicContainer<SceneMaterial, SceneLabel>::remove(item);
+}
+
+void SceneLabelContainer::clear()
+{
+    m_index.clear();
+
+    MarkedSceneBasicContainer<SceneMaterial, SceneLabel>::clear();
+}
+
+void SceneLabelContainer::updatePoint(SceneLabel *label)
+{
+    m_index.update(label);
+}
+
 RectPoint SceneLabelContainer::boundingBox() const
 {
     Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
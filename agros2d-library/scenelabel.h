@@ -35,7 +35,7 @@ public:
 
     inline virtual SceneMaterial* marker(FieldInfo *fieldInfo) { return MarkedSceneBasic<SceneMaterial>::marker(fieldInfo); }
     inline Point point() const { return m_point; }
-    inline void setPoint(const Point &point) { m_point = point; }
+    void setPoint(const Point &point);
     inline double area() const { return m_area; }
     inline void setArea(double area) { m_area = area; }
 
@@ -69,8 +69,21 @@ public:
     /// returns label with given coordinates or NULL
     SceneLabel* get(const Point& point) const;
 
+    virtual bool add(SceneLabel *item);
+    virtual bool remove(SceneLabel *item);
+    virtual void clear();
+
+    /// updates index of the moved label
+    void updatePoint(SceneLabel *label);
+
     /// returns bounding box, assumes container not empty
     RectPoint boundingBox() const;
+
+private:
+    ScenePointIndex<SceneLabel> m_index;
+
+    // filtered containers (selected(), highlighted(), haveMarker()) are not indexed
+    inline bool isIndexed() const { return m_index.count() == m_data.count(); }
 };
 
 
@@ -27,6 +27,7 @@
 #include "sceneedge.h"
 #include "scenemarker.h"
 #include "scenemarkerdialog.h"
+#include "util/loops.h"
 #include "hermes2d/problem.h"
 #include "hermes2d/problem_config.h"
 
@@ -37,6 +38,8 @@ SceneNode::SceneNode(const Point &point) : SceneBasic(), m_point(point)
 void SceneNode::setPoint(const Point &point)
 {
     m_point = point;
+    Agros2D::scene()->nodes->updatePoint(this);
+    Agros2D::scene()->loopsInfo()->updateNode(this);
 
     // refresh cache
     foreach (SceneEdge *edge, connectedEdges())
@@ -82,26 +85,46 @@ SceneNode *SceneNode::findClosestNode(const Point &point)
 
 SceneNode* SceneNodeContainer::get(SceneNode *node) const
 {
+    return get(node->point());
+}
+
+SceneNode* SceneNodeContainer::get(const Point &point) const
+{
+    if (isIndexed())
+    {
+        QList<SceneNode *> nodes = m_index.find(point);
+        return nodes.isEmpty() ? NULL : nodes.first();
+    }
+
     foreach (SceneNode *nodeCheck, m_data)
     {
-        if (nodeCheck->point() == node->point())
-        {
+        if (nodeCheck->point() == point)
             return nodeCheck;
-        }
     }
 
     return NULL;
 }
 
-SceneNode* SceneNodeContainer::get(const Point &point) const
+QList<SceneNode *> SceneNodeContainer::getAll(const Point &point) const
 {
+    if (isIndexed())
+        return m_index.find(point);
+
+    QList<SceneNode *> nodes;
     foreach (SceneNode *nodeCheck, m_data)
     {
         if (nodeCheck->point() == point)
-            return nodeCheck;
+            nodes.append(nodeCheck);
     }
 
-    return NULL;
+    return nodes;
+}
+
+bool SceneNodeContainer::add(SceneNode *item)
+{
+    m_index.insert(item);
+
+    return SceneBasicContainer<SceneNode>::add(item);
 }
 
 bool SceneNodeContainer::remove(SceneNode *item)
@@ -109,9 +132,23 @@ bool SceneNodeContainer::remove(SceneNode *item)
     // remove all edges connected to this node
     Agros2D::scene()->edges->removeConnectedToNode(item);
 
+    m_index.remove(item);
+
     return SceneBasicContainer<SceneNode>::remove(item);
 }
 
+void SceneNodeContainer::clear()
+{
+    m_index.clear();
+
+    SceneBasicContainer<SceneNode>::clear();
+}
+
+void SceneNodeContainer::updatePoint(SceneNode *node)
+{
+    m_index.update(node);
+}
+
 RectPoint SceneNodeContainer::boundingBox() const
 {
     Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
@@ -469,33 +506,17 @@ void SceneNodeCommandRemoveMulti::redo()
 
 bool SceneNode::isConnected() const
 {
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-        if (edge->nodeStart() == this || edge->nodeEnd() == this)
-            return true;
-
-    return false;
+    return !connectedEdges().isEmpty();
 }
 
 bool SceneNode::isEndNode() const
 {
-    int connections = 0;
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-        if (edge->nodeStart() == this || edge->nodeEnd() == this)
-            connections++;
-
-    return (connections == 1);
+    return (connectedEdges().count() == 1);
 }
 
 QList<SceneEdge *> SceneNode::connectedEdges() const
 {
-    QList<SceneEdge *> edges;
-    edges.reserve(Agros2D::scene()->edges->count());
-
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-        if (edge->nodeStart() == this || edge->nodeEnd() == this)
-            edges.append(edge);
-
-    return edges;
+    return Agros2D::scene()->edges->connectedEdges(const_cast<SceneNode *>(this));
 }
 
 int SceneNode::numberOfConnectedEdges() const
@@ -510,7 +531,7 @@ bool SceneNode::hasLyingEdges() const
 
 QList<SceneEdge *> SceneNode::lyingEdges() const
 {
-    return Agros2D::scene()->lyingEdgeNodes().keys(const_cast<SceneNode *>(this));
+    return Agros2D::scene()->lyingNodeEdges().values(const_cast<SceneNode *>(this));
 }
 
 bool SceneNode::isOutsideArea() const
@@ -65,10 +65,17 @@ public:
 
     /// returns node with given coordinates or NULL
     SceneNode* get(const Point& point) const;
+    /// returns all nodes with given coordinates
+    QList<SceneNode *> getAll(const Point& point) const;
 
     SceneNode* findClosest(const Point& point) const;
 
+    virtual bool add(SceneNode *item);
     virtual bool remove(SceneNode *item);
+    virtual void clear();
+
+    /// updates index of the moved node
+    void updatePoint(SceneNode *node);
 
     /// returns bounding box, assumes container not empty
     RectPoint boundingBox() const;
@@ -76,6 +83,12 @@ public:
     //TODO should be in SceneBasicContainer, but I would have to cast the result....
     SceneNodeContainer selected();
     SceneNodeContainer highlighted();
+
+private:
+    ScenePointIndex<SceneNode> m_index;
+
+    // filtered containers (selected(), highlighted()) are not indexed
+    inline bool isIndexed() const { return m_index.count() == m_data.count(); }
 };
 
 
@@ -44,9 +44,24 @@
 #include "hermes2d/solutiontypes.h"
 #include "hermes2d/solutionstore.h"
 
+// estimated memory footprint of vertices, triangles and edges of the view (in bytes)
+template <typename View>
+static qint64 viewMemory(View *view)
+{
+    if (!view)
+        return 0;
+
+    return (qint64) view->get_num_vertices() * sizeof(*view->get_vertices())
+            + (qint64) view->get_num_triangles() * (sizeof(*view->get_triangles()) + sizeof(int))
+            + (qint64) view->get_num_edges() * (sizeof(*view->get_edges()) + sizeof(int));
+}
+
 PostHermes::PostHermes() :
-    m_activeViewField(NULL), m_activeTimeStep(NOT_FOUND_SO_FAR), m_activeAdaptivityStep(NOT_FOUND_SO_FAR), m_activeSolutionMode(SolutionMode_Undefined), m_isProcessed(false)
+    m_activeViewField(NULL), m_activeTimeStep(NOT_FOUND_SO_FAR), m_activeAdaptivityStep(NOT_FOUND_SO_FAR), m_activeSolutionMode(SolutionMode_Undefined),
+    m_activeViewMode(PostViewMode_All), m_isProcessed(false), m_isViewModeRefreshPending(false), m_cacheMemory(0), m_cacheHits(0), m_cacheMisses(0)
 {
+    resetViews();
+
     connect(Agros2D::scene(), SIGNAL(cleared()), this, SLOT(clear()));
     connect(Agros2D::problem(), SIGNAL(clearedSolution()), this, SLOT(clearView()));
     connect(Agros2D::problem(), SIGNAL(fieldsChanged()), this, SLOT(clear()));
@@ -60,270 +75,374 @@ PostHermes::~PostHermes()
     clear();
 }
 
-void PostHermes::processInitialMesh()
+bool PostHermes::isViewRequired(PostHermesTask task) const
 {
-    if (Agros2D::problem()->isMeshed() && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowInitialMeshView).toBool()))
+    switch (m_activeViewMode)
     {
-        Agros2D::log()->printMessage(tr("Mesh View"), tr("Initial mesh with %1 elements").arg(m_activeViewField->initialMesh()->get_num_active_elements()));
+    case PostViewMode_All:
+        return true;
+    case PostViewMode_Mesh:
+        return (task == PostHermesTask_InitialMesh || task == PostHermesTask_SolutionMesh || task == PostHermesTask_Order);
+    case PostViewMode_Post2D:
+        return (task == PostHermesTask_Contour || task == PostHermesTask_Scalar || task == PostHermesTask_Vector);
+    case PostViewMode_Post3D:
+        return (task == PostHermesTask_InitialMesh || task == PostHermesTask_Scalar);
+    default:
+        return false;
+    }
+}
 
-        // init linearizer for initial mesh
-        try
+bool PostHermes::cachedView(const PostHermesTaskID &id, CachedView &view)
+{
+    QMap<PostHermesTaskID, CachedView>::const_iterator it = m_cache.constFind(id);
+    if (it == m_cache.constEnd())
+    {
+        m_cacheMisses++;
+        return false;
+    }
+
+    m_cacheHits++;
+    view = it.value();
+
+    // most recently used
+    m_cacheIDOrder.removeOne(id);
+    m_cacheIDOrder.append(id);
+
+    return true;
+}
+
+void PostHermes::insertCachedView(const PostHermesTaskID &id, const CachedView &view)
+{
+    CachedView cachedView = view;
+    cachedView.memory = viewMemory(view.linearizer.data()) + viewMemory(view.orderizer.data()) + viewMemory(view.vectorizer.data());
+
+    // views share the memory limit with the solution cache
+    qint64 memoryLimit = (qint64) Agros2D::configComputer()->cacheSize * 1024 * 1024;
+
+    // remove least recently used views, keep at least the inserted one (views in use are released by the view itself)
+    while (!m_cacheIDOrder.isEmpty() && (m_cacheMemory + cachedView.memory > memoryLimit))
+        m_cacheMemory -= m_cache.take(m_cacheIDOrder.takeFirst()).memory;
+
+    if (m_cache.contains(id))
+    {
+        m_cacheMemory -= m_cache.value(id).memory;
+        m_cacheIDOrder.removeOne(id);
+    }
+
+    m_cache.insert(id, cachedView);
+    m_cacheIDOrder.append(id);
+    m_cacheMemory += cachedView.memory;
+}
+
+void PostHermes::clearCache()
+{
+    m_cache.clear();
+    m_cacheIDOrder.clear();
+    m_cacheMemory = 0;
+}
+
+template <typename View>
+void PostHermes::setDisplacement(View *view, bool deform)
+{
+    if (deform)
+    {
+        Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
+                                                                                                                                                               activeMultiSolutionArray().solutions().at(1)));
+
+        if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
         {
-            m_linInitialMeshView.free();
-            m_linInitialMeshView.process_solution(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(m_activeViewField->initialMesh())));
+            RectPoint rect = Agros2D::scene()->boundingBox();
+            double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+
+            view->set_displacement(activeMultiSolutionArray().solutions().at(0),
+                                   activeMultiSolutionArray().solutions().at(1),
+                                   dmult);
         }
-        catch (Hermes::Exceptions::Exception& e)
+        delete filter;
+    }
+    else
+    {
+        view->set_displacement(NULL, NULL);
+    }
+}
+
+void PostHermes::processInitialMesh()
+{
+    if (Agros2D::problem()->isMeshed() && (m_activeViewField) && isViewRequired(PostHermesTask_InitialMesh)
+            && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowInitialMeshView).toBool()))
+    {
+        // initial mesh does not depend on the solution
+        PostHermesTaskID id(PostHermesTask_InitialMesh, FieldSolutionID(m_activeViewField, 0, 0, SolutionMode_Undefined));
+
+        CachedView view;
+        if (!cachedView(id, view))
         {
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer processing failed: %1").arg(e.what()));
+            Agros2D::log()->printMessage(tr("Mesh View"), tr("Initial mesh with %1 elements").arg(m_activeViewField->initialMesh()->get_num_active_elements()));
+
+            // init linearizer for initial mesh
+            try
+            {
+                view.linearizer = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+                view.linearizer->process_solution(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(m_activeViewField->initialMesh())));
+
+                insertCachedView(id, view);
+            }
+            catch (Hermes::Exceptions::Exception& e)
+            {
+                Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer processing failed: %1").arg(e.what()));
+                return;
+            }
         }
+
+        m_linInitialMeshView = view.linearizer;
     }
 }
 
 void PostHermes::processSolutionMesh()
 {
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowSolutionMeshView).toBool()))
+    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && isViewRequired(PostHermesTask_SolutionMesh)
+            && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowSolutionMeshView).toBool()))
     {
         int comp = Agros2D::problem()->setting()->value(ProblemSetting::View_OrderComponent).toInt() - 1;
 
-        Agros2D::log()->printMessage(tr("Mesh View"), tr("Solution mesh with %1 elements").arg(activeMultiSolutionArray().solutions().at(comp)->get_mesh()->get_num_active_elements()));
+        PostHermesTaskID id(PostHermesTask_SolutionMesh, FieldSolutionID(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode),
+                            "", comp);
+
+        CachedView view;
+        if (!cachedView(id, view))
+        {
+            Agros2D::log()->printMessage(tr("Mesh View"), tr("Solution mesh with %1 elements").arg(activeMultiSolutionArray().solutions().at(comp)->get_mesh()->get_num_active_elements()));
+
+            // init linearizer for solution mesh
+            const Hermes::Hermes2D::MeshSharedPtr mesh = activeMultiSolutionArray().solutions().at(comp)->get_mesh();
+
+            view.linearizer = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+            view.linearizer->process_solution(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(mesh)));
 
-        // init linearizer for solution mesh
-        const Hermes::Hermes2D::MeshSharedPtr mesh = activeMultiSolutionArray().solutions().at(comp)->get_mesh();
+            insertCachedView(id, view);
+        }
 
-        m_linSolutionMeshView.free();
-        m_linSolutionMeshView.process_solution(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new Hermes::Hermes2D::ZeroSolution<double>(mesh)));
+        m_linSolutionMeshView = view.linearizer;
     }
 }
 
 void PostHermes::processOrder()
 {
     // init linearizer for order view
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowOrderView).toBool()))
+    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && isViewRequired(PostHermesTask_Order)
+            && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowOrderView).toBool()))
     {
-        Agros2D::log()->printMessage(tr("Mesh View"), tr("Polynomial order"));
-
         int comp = Agros2D::problem()->setting()->value(ProblemSetting::View_OrderComponent).toInt() - 1;
 
-        m_orderView.free();
-        m_orderView.process_space(activeMultiSolutionArray().spaces().at(comp));
+        PostHermesTaskID id(PostHermesTask_Order, FieldSolutionID(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode),
+                            "", comp);
+
+        CachedView view;
+        if (!cachedView(id, view))
+        {
+            Agros2D::log()->printMessage(tr("Mesh View"), tr("Polynomial order"));
+
+            view.orderizer = QSharedPointer<Hermes::Hermes2D::Views::Orderizer>(new Hermes::Hermes2D::Views::Orderizer());
+            view.orderizer->process_space(activeMultiSolutionArray().spaces().at(comp));
+
+            insertCachedView(id, view);
+        }
+
+        m_orderView = view.orderizer;
     }
 }
 
 void PostHermes::processRangeContour()
 {
-    if (Agros2D::problem()->isSolved() && m_activeViewField && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowContourView).toBool()))
+    if (Agros2D::problem()->isSolved() && m_activeViewField && isViewRequired(PostHermesTask_Contour)
+            && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowContourView).toBool()))
     {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewScalarVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
-
-        Agros2D::log()->printMessage(tr("Post View"), tr("Contour view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()));
-
         QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString();
         Module::LocalVariable variable = m_activeViewField->localVariable(variableName);
+        PhysicFieldVariableComp comp = variable.isScalar() ? PhysicFieldVariableComp_Scalar : PhysicFieldVariableComp_Magnitude;
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnContourView;
-        if (variable.isScalar())
-            slnContourView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()),
-                                              PhysicFieldVariableComp_Scalar);
-        else
-            slnContourView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()),
-                                              PhysicFieldVariableComp_Magnitude);
+        int quality = Agros2D::problem()->setting()->value(ProblemSetting::View_LinearizerQuality).toInt();
+        bool deform = m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformContour).toBool();
 
-        m_linContourView.free();
+        PostHermesTaskID id(PostHermesTask_Contour, FieldSolutionID(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode),
+                            variableName, comp, quality, deform);
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformContour).toBool())
+        CachedView view;
+        if (!cachedView(id, view))
         {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                 activeMultiSolutionArray().solutions().at(1)));
+            Agros2D::log()->printMessage(tr("Post View"), tr("Contour view (%1)").arg(variableName));
 
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+            Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnContourView = viewScalarFilter(variable, comp);
 
-                m_linContourView.set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                  activeMultiSolutionArray().solutions().at(1),
-                                                  dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_linContourView.set_displacement(NULL, NULL);
+            view.linearizer = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+
+            // deformed shape
+            setDisplacement(view.linearizer.data(), deform);
+
+            // process solution
+            view.linearizer->process_solution(slnContourView,
+                                              Hermes::Hermes2D::H2D_FN_VAL_0,
+                                              paletteQualityToDouble((PaletteQuality) quality));
+
+            insertCachedView(id, view);
         }
 
-        // process solution
-        m_linContourView.process_solution(slnContourView,
-                                          Hermes::Hermes2D::H2D_FN_VAL_0,
-                                          paletteQualityToDouble((PaletteQuality) Agros2D::problem()->setting()->value(ProblemSetting::View_LinearizerQuality).toInt()));
+        m_linContourView = view.linearizer;
     }
 }
 
 void PostHermes::processRangeScalar()
 {
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField)
-            && ((Agros2D::problem()->setting()->value(ProblemSetting::View_ShowScalarView).toBool())
-                || (((SceneViewPost3DMode) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DMode).toInt()) == SceneViewPost3DMode_ScalarView3D)))
+    if (!(Agros2D::problem()->isSolved() && m_activeViewField && isViewRequired(PostHermesTask_Scalar)))
+        return;
+
+    SceneViewPost3DMode mode3D = (SceneViewPost3DMode) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DMode).toInt();
+    bool showScalarView = Agros2D::problem()->setting()->value(ProblemSetting::View_ShowScalarView).toBool();
+
+    bool isRequired = false;
+    if (m_activeViewMode == PostViewMode_Post2D)
+        isRequired = showScalarView;
+    else if (m_activeViewMode == PostViewMode_Post3D)
+        isRequired = (mode3D == SceneViewPost3DMode_ScalarView3D || mode3D == SceneViewPost3DMode_ScalarView3DSolid);
+    else
+        isRequired = (showScalarView || mode3D == SceneViewPost3DMode_ScalarView3D);
+
+    if (isRequired)
     {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewScalarVariables())
+        QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString();
+        PhysicFieldVariableComp comp = (PhysicFieldVariableComp) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariableComp).toInt();
+
+        int quality = Agros2D::problem()->setting()->value(ProblemSetting::View_LinearizerQuality).toInt();
+        bool deform = m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformScalar).toBool();
+
+        PostHermesTaskID id(PostHermesTask_Scalar, FieldSolutionID(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode),
+                            variableName, comp, quality, deform);
+
+        CachedView view;
+        if (!cachedView(id, view))
         {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
+            Agros2D::log()->printMessage(tr("Post View"), tr("Scalar view (%1)").arg(variableName));
 
-        Agros2D::log()->printMessage(tr("Post View"), tr("Scalar view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString()));
+            Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnScalarView = viewScalarFilter(m_activeViewField->localVariable(variableName), comp);
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnScalarView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString()),
-                                                                                         (PhysicFieldVariableComp) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariableComp).toInt());
+            /*
+            FieldSolutionID fsid(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode);
+            MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
 
-        /*
-        FieldSolutionID fsid(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode);
-        MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
+            Hermes::vector<std::string> markers;
+            Hermes::vector<std::string> markersInverted;
+            for (int i = 0; i < Agros2D::scene()->labels->count(); i++)
+            {
+                SceneLabel *label = Agros2D::scene()->labels->at(i);
+                if (label->isSelected())
+                {
+                    markers.push_back(QString::number(i).toStdString());
+                }
+                else
+                {
+                    markersInverted.push_back(QString::number(i).toStdString());
+                }
+            }
 
-        Hermes::vector<std::string> markers;
-        Hermes::vector<std::string> markersInverted;
-        for (int i = 0; i < Agros2D::scene()->labels->count(); i++)
-        {
-            SceneLabel *label = Agros2D::scene()->labels->at(i);
-            if (label->isSelected())
+            Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnScalarView;
+            if (markers.size() > 0)
             {
-                markers.push_back(QString::number(i).toStdString());
+                Hermes::Hermes2D::MeshSharedPtr eggShellMesh = Hermes::Hermes2D::EggShell::get_egg_shell(ma.solutions().at(0)->get_mesh(), markers, 2);
+                slnScalarView = Hermes::Hermes2D::MeshFunctionSharedPtr<double> (new Hermes::Hermes2D::ExactSolutionEggShell(eggShellMesh, 3));
             }
             else
             {
-                markersInverted.push_back(QString::number(i).toStdString());
+                return;
             }
-        }
-
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnScalarView;
-        if (markers.size() > 0)
-        {
-            Hermes::Hermes2D::MeshSharedPtr eggShellMesh = Hermes::Hermes2D::EggShell::get_egg_shell(ma.solutions().at(0)->get_mesh(), markers, 2);
-            slnScalarView = Hermes::Hermes2D::MeshFunctionSharedPtr<double> (new Hermes::Hermes2D::ExactSolutionEggShell(eggShellMesh, 3));
-        }
-        else
-        {
-            return;
-        }
-        */
+            */
 
-        m_linScalarView.free();
+            view.linearizer = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformScalar).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
+            // deformed shape
+            setDisplacement(view.linearizer.data(), deform);
 
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+            // process solution
+            view.linearizer->process_solution(slnScalarView,
+                                              Hermes::Hermes2D::H2D_FN_VAL_0,
+                                              paletteQualityToDouble((PaletteQuality) quality));
 
-                m_linScalarView.set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                 activeMultiSolutionArray().solutions().at(1),
-                                                 dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_linScalarView.set_displacement(NULL, NULL);
+            insertCachedView(id, view);
         }
 
-        // process solution
-        m_linScalarView.process_solution(slnScalarView,
-                                         Hermes::Hermes2D::H2D_FN_VAL_0,
-                                         paletteQualityToDouble((PaletteQuality) Agros2D::problem()->setting()->value(ProblemSetting::View_LinearizerQuality).toInt()));
+        m_linScalarView = view.linearizer;
 
+        // range is updated for cached views too
         if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
         {
-            Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMin, m_linScalarView.get_min_value());
-            Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMax, m_linScalarView.get_max_value());
+            Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMin, m_linScalarView->get_min_value());
+            Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMax, m_linScalarView->get_max_value());
         }
     }
 }
 
 void PostHermes::processRangeVector()
 {
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowVectorView).toBool()))
+    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && isViewRequired(PostHermesTask_Vector)
+            && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowVectorView).toBool()))
     {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewVectorVariables())
+        QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString();
+        bool deform = m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformVector).toBool();
+
+        PostHermesTaskID id(PostHermesTask_Vector, FieldSolutionID(m_activeViewField, m_activeTimeStep, m_activeAdaptivityStep, m_activeSolutionMode),
+                            variableName, 0, 0, deform);
+
+        CachedView view;
+        if (!cachedView(id, view))
         {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
+            Agros2D::log()->printMessage(tr("Post View"), tr("Vector view (%1)").arg(variableName));
 
-        Agros2D::log()->printMessage(tr("Post View"), tr("Vector view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()));
+            Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorXView = viewScalarFilter(m_activeViewField->localVariable(variableName),
+                                                                                              PhysicFieldVariableComp_X);
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorXView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()),
-                                                                                          PhysicFieldVariableComp_X);
+            Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorYView = viewScalarFilter(m_activeViewField->localVariable(variableName),
+                                                                                              PhysicFieldVariableComp_Y);
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorYView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()),
-                                                                                          PhysicFieldVariableComp_Y);
+            view.vectorizer = QSharedPointer<Hermes::Hermes2D::Views::Vectorizer>(new Hermes::Hermes2D::Views::Vectorizer());
 
-        m_vecVectorView.free();
+            // deformed shape
+            setDisplacement(view.vectorizer.data(), deform);
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformVector).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                 activeMultiSolutionArray().solutions().at(1)));
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+            // process solution
+            view.vectorizer->process_solution(slnVectorXView, slnVectorYView,
+                                              Hermes::Hermes2D::H2D_FN_VAL_0, Hermes::Hermes2D::H2D_FN_VAL_0,
+                                              Hermes::Hermes2D::Views::HERMES_EPS_LOW);
 
-                m_vecVectorView.set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                 activeMultiSolutionArray().solutions().at(1),
-                                                 dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_vecVectorView.set_displacement(NULL, NULL);
+            insertCachedView(id, view);
         }
 
-        // process solution
-        m_vecVectorView.process_solution(slnVectorXView, slnVectorYView,
-                                         Hermes::Hermes2D::H2D_FN_VAL_0, Hermes::Hermes2D::H2D_FN_VAL_0,
-                                         Hermes::Hermes2D::Views::HERMES_EPS_LOW);
+        m_vecVectorView = view.vectorizer;
     }
 }
 
-void PostHermes::clearView()
+void PostHermes::resetViews()
 {
     m_isProcessed = false;
 
-    m_linInitialMeshView.free();
-    m_linSolutionMeshView.free();
-    m_orderView.free();
+    // views are shared with the cache, empty views are used until processed
+    m_linInitialMeshView = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+    m_linSolutionMeshView = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+    m_orderView = QSharedPointer<Hermes::Hermes2D::Views::Orderizer>(new Hermes::Hermes2D::Views::Orderizer());
 
-    m_linContourView.free();
-    m_linScalarView.free();
-    m_vecVectorView.free();
+    m_linContourView = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+    m_linScalarView = QSharedPointer<Hermes::Hermes2D::Views::Linearizer>(new Hermes::Hermes2D::Views::Linearizer());
+    m_vecVectorView = QSharedPointer<Hermes::Hermes2D::Views::Vectorizer>(new Hermes::Hermes2D::Views::Vectorizer());
+}
+
+void PostHermes::clearView()
+{
+    resetViews();
+    clearCache();
 }
 
 void PostHermes::refresh()
 {
-    clearView();
+    // cached views are kept
+    resetViews();
 
     if (Agros2D::problem()->isMeshed())
         processMeshed();
@@ -347,6 +466,9 @@ void PostHermes::clear()
 
 void PostHermes::problemMeshed()
 {
+    // initial mesh could be changed
+    clearCache();
+
     if (!m_activeViewField)
     {
         setActiveViewField(Agros2D::problem()->fieldInfos().begin().value());
@@ -471,6 +593,30 @@ void PostHermes::setActiveAdaptivityStep(int as)
     m_activeAdaptivityStep = as;
 }
 
+void PostHermes::setActiveViewMode(PostViewMode mode)
+{
+    if (m_activeViewMode == mode)
+        return;
+
+    m_activeViewMode = mode;
+
+    // views of the new mode are processed after the caller (e.g. update of the controls) has finished
+    if (m_isProcessed && !m_isViewModeRefreshPending)
+    {
+        m_isViewModeRefreshPending = true;
+        QTimer::singleShot(0, this, SLOT(refreshViewMode()));
+    }
+}
+
+void PostHermes::refreshViewMode()
+{
+    m_isViewModeRefreshPending = false;
+
+    // process views of the active mode (already processed views are taken from the cache)
+    if (m_isProcessed)
+        refresh();
+}
+
 MultiArray<double> PostHermes::activeMultiSolutionArray()
 {
     FieldSolutionID fsid(activeViewField(), activeTimeStep(), activeAdaptivityStep(), activeAdaptivitySolutionType());
@@ -479,6 +625,138 @@ MultiArray<double> PostHermes::activeMultiSolutionArray()
 
 // ************************************************************************************************
 
+template <typename Type>
+static void uploadBuffer(QGLBuffer &buffer, QVector<Type> &data)
+{
+    buffer.create();
+    buffer.bind();
+    buffer.setUsagePattern(QGLBuffer::StaticDraw);
+    buffer.allocate(data.constData(), data.count() * sizeof(Type));
+    buffer.release();
+
+    // data are stored in the buffer
+    data.clear();
+    data.squeeze();
+}
+
+PostVertexBuffer::PostVertexBuffer()
+    : m_isUploaded(false), m_useBuffers(false), m_vertexCount(0), m_indexCount(0),
+      m_hasNormals(false), m_hasColors(false), m_hasTexCoords(false),
+      m_vertexBuffer(QGLBuffer::VertexBuffer),
+      m_normalBuffer(QGLBuffer::VertexBuffer),
+      m_colorBuffer(QGLBuffer::VertexBuffer),
+      m_texCoordBuffer(QGLBuffer::VertexBuffer),
+      m_indexBuffer(QGLBuffer::IndexBuffer)
+{
+}
+
+PostVertexBuffer::~PostVertexBuffer()
+{
+    clear();
+}
+
+void PostVertexBuffer::upload()
+{
+    assert(normals.isEmpty() || normals.count() == vertices.count());
+    assert(colors.isEmpty() || colors.count() == vertices.count());
+    assert(texCoords.isEmpty() || texCoords.count() == vertices.count());
+
+    m_vertexCount = vertices.count();
+    m_indexCount = indices.count();
+    m_hasNormals = !normals.isEmpty();
+    m_hasColors = !colors.isEmpty();
+    m_hasTexCoords = !texCoords.isEmpty();
+
+    // buffer cannot be created without VBO support
+    m_useBuffers = (m_vertexCount > 0) && m_vertexBuffer.create();
+
+    if (m_useBuffers)
+    {
+        uploadBuffer(m_vertexBuffer, vertices);
+        if (m_hasNormals) uploadBuffer(m_normalBuffer, normals);
+        if (m_hasColors) uploadBuffer(m_colorBuffer, colors);
+        if (m_hasTexCoords) uploadBuffer(m_texCoordBuffer, texCoords);
+        if (m_indexCount > 0) uploadBuffer(m_indexBuffer, indices);
+    }
+
+    m_isUploaded = true;
+}
+
+void PostVertexBuffer::draw(GLenum mode)
+{
+    if (!m_isUploaded || m_vertexCount == 0)
+        return;
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (m_useBuffers) m_vertexBuffer.bind();
+    glVertexPointer(3, GL_FLOAT, 0, m_useBuffers ? NULL : vertices.constData());
+
+    if (m_hasNormals)
+    {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        if (m_useBuffers) m_normalBuffer.bind();
+        glNormalPointer(GL_FLOAT, 0, m_useBuffers ? NULL : normals.constData());
+    }
+
+    if (m_hasColors)
+    {
+        glEnableClientState(GL_COLOR_ARRAY);
+        if (m_useBuffers) m_colorBuffer.bind();
+        glColorPointer(3, GL_FLOAT, 0, m_useBuffers ? NULL : colors.constData());
+    }
+
+    if (m_hasTexCoords)
+    {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        if (m_useBuffers) m_texCoordBuffer.bind();
+        glTexCoordPointer(1, GL_FLOAT, 0, m_useBuffers ? NULL : texCoords.constData());
+    }
+
+    if (m_useBuffers)
+        QGLBuffer::release(QGLBuffer::VertexBuffer);
+
+    if (m_indexCount > 0)
+    {
+        if (m_useBuffers) m_indexBuffer.bind();
+        glDrawElements(mode, m_indexCount, GL_UNSIGNED_INT, m_useBuffers ? NULL : indices.constData());
+        if (m_useBuffers) m_indexBuffer.release();
+    }
+    else
+    {
+        glDrawArrays(mode, 0, m_vertexCount);
+    }
+
+    if (m_hasTexCoords) glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    if (m_hasColors) glDisableClientState(GL_COLOR_ARRAY);
+    if (m_hasNormals) glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void PostVertexBuffer::clear()
+{
+    m_vertexBuffer.destroy();
+    m_normalBuffer.destroy();
+    m_colorBuffer.destroy();
+    m_texCoordBuffer.destroy();
+    m_indexBuffer.destroy();
+
+    vertices.clear();
+    normals.clear();
+    colors.clear();
+    texCoords.clear();
+    indices.clear();
+
+    m_isUploaded = false;
+    m_useBuffers = false;
+    m_vertexCount = 0;
+    m_indexCount = 0;
+    m_hasNormals = false;
+    m_hasColors = false;
+    m_hasTexCoords = false;
+}
+
+// ************************************************************************************************
+
 SceneViewPostInterface::SceneViewPostInterface(PostHermes *postHermes, QWidget *parent)
     : SceneViewCommon(parent),
       m_postHermes(postHermes),
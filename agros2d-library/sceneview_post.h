@@ -22,6 +22,9 @@
 
 #include "util.h"
 #include "sceneview_common.h"
+#include "hermes2d/solutiontypes.h"
+
+#include <QGLBuffer>
 
 template <typename Scalar> class SceneSolution;
 template <typename Scalar> class MultiArray;
@@ -29,6 +32,56 @@ template <typename Scalar> class MultiArray;
 class ParticleTracing;
 class FieldInfo;
 
+enum PostHermesTask
+{
+    PostHermesTask_InitialMesh = 0,
+    PostHermesTask_SolutionMesh = 1,
+    PostHermesTask_Order = 2,
+    PostHermesTask_Contour = 3,
+    PostHermesTask_Scalar = 4,
+    PostHermesTask_Vector = 5
+};
+
+// identification of the processed view (result of the task is cached)
+struct PostHermesTaskID
+{
+    PostHermesTask task;
+    FieldSolutionID solutionID;
+    QString variable;
+    int component;
+    int quality;
+    bool deform;
+
+    PostHermesTaskID(PostHermesTask task, FieldSolutionID solutionID,
+                     const QString &variable = "", int component = 0, int quality = 0, bool deform = false) :
+        task(task), solutionID(solutionID), variable(variable), component(component), quality(quality), deform(deform) {}
+};
+
+inline bool operator<(const PostHermesTaskID &id1, const PostHermesTaskID &id2)
+{
+    if (id1.task != id2.task)
+        return id1.task < id2.task;
+
+    if (id1.solutionID != id2.solutionID)
+        return id1.solutionID < id2.solutionID;
+
+    if (id1.variable != id2.variable)
+        return id1.variable < id2.variable;
+
+    if (id1.component != id2.component)
+        return id1.component < id2.component;
+
+    if (id1.quality != id2.quality)
+        return id1.quality < id2.quality;
+
+    return id1.deform < id2.deform;
+}
+
+inline bool operator==(const PostHermesTaskID &id1, const PostHermesTaskID &id2)
+{
+    return !((id1 < id2) || (id2 < id1));
+}
+
 class PostHermes : public QObject
 {
     Q_OBJECT
@@ -38,26 +91,26 @@ public:
     ~PostHermes();
 
     // mesh
-    inline bool initialMeshIsPrepared() { return !m_linInitialMeshView.is_empty(); }
-    inline Hermes::Hermes2D::Views::Linearizer &linInitialMeshView() { return m_linInitialMeshView; }
-    inline bool solutionMeshIsPrepared() { return !m_linSolutionMeshView.is_empty(); }
-    inline Hermes::Hermes2D::Views::Linearizer &linSolutionMeshView() { return m_linSolutionMeshView; }
+    inline bool initialMeshIsPrepared() { return !m_linInitialMeshView->is_empty(); }
+    inline Hermes::Hermes2D::Views::Linearizer &linInitialMeshView() { return *m_linInitialMeshView; }
+    inline bool solutionMeshIsPrepared() { return !m_linSolutionMeshView->is_empty(); }
+    inline Hermes::Hermes2D::Views::Linearizer &linSolutionMeshView() { return *m_linSolutionMeshView; }
 
     // order view
-    inline bool orderIsPrepared() { return !m_orderView.is_empty(); }
-    Hermes::Hermes2D::Views::Orderizer &ordView() { return m_orderView; }
+    inline bool orderIsPrepared() { return !m_orderView->is_empty(); }
+    Hermes::Hermes2D::Views::Orderizer &ordView() { return *m_orderView; }
 
     // contour
-    inline bool contourIsPrepared() { return !m_linContourView.is_empty(); }
-    inline Hermes::Hermes2D::Views::Linearizer &linContourView() { return m_linContourView; }
+    inline bool contourIsPrepared() { return !m_linContourView->is_empty(); }
+    inline Hermes::Hermes2D::Views::Linearizer &linContourView() { return *m_linContourView; }
 
     // scalar view
-    inline bool scalarIsPrepared() { return !m_linScalarView.is_empty(); }
-    inline Hermes::Hermes2D::Views::Linearizer &linScalarView() { return m_linScalarView; }
+    inline bool scalarIsPrepared() { return !m_linScalarView->is_empty(); }
+    inline Hermes::Hermes2D::Views::Linearizer &linScalarView() { return *m_linScalarView; }
 
     // vector view
-    inline bool vectorIsPrepared() { return !m_vecVectorView.is_empty(); }
-    inline Hermes::Hermes2D::Views::Vectorizer &vecVectorView() { return m_vecVectorView; }
+    inline bool vectorIsPrepared() { return !m_vecVectorView->is_empty(); }
+    inline Hermes::Hermes2D::Views::Vectorizer &vecVectorView() { return *m_vecVectorView; }
 
     Hermes::Hermes2D::MeshFunctionSharedPtr<double> viewScalarFilter(Module::LocalVariable physicFieldVariable,
                                                                      PhysicFieldVariableComp physicFieldVariableComp);
@@ -77,8 +130,19 @@ public:
 
     MultiArray<double> activeMultiSolutionArray();
 
+    // only views of the active scene view are processed
+    inline PostViewMode activeViewMode() const { return m_activeViewMode; }
+    void setActiveViewMode(PostViewMode mode);
+
     inline bool isProcessed() const { return m_isProcessed; }
 
+    // cache statistics
+    inline int cacheHits() const { return m_cacheHits; }
+    inline int cacheMisses() const { return m_cacheMisses; }
+    inline int cacheCount() const { return m_cache.count(); }
+    // memory occupied by cached views (in bytes)
+    inline qint64 cacheMemory() const { return m_cacheMemory; }
+
 signals:
     void processed();
 
@@ -89,35 +153,69 @@ public slots:
 
 private:
     bool m_isProcessed;
+    bool m_isViewModeRefreshPending;
 
     // initial mesh
-    Hermes::Hermes2D::Views::Linearizer m_linInitialMeshView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linInitialMeshView;
 
     // solution mesh
-    Hermes::Hermes2D::Views::Linearizer m_linSolutionMeshView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linSolutionMeshView;
 
     // order view
-    Hermes::Hermes2D::Views::Orderizer m_orderView;
+    QSharedPointer<Hermes::Hermes2D::Views::Orderizer> m_orderView;
 
     // contour
-    Hermes::Hermes2D::Views::Linearizer m_linContourView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linContourView;
 
     // scalar view
-    Hermes::Hermes2D::Views::Linearizer m_linScalarView; // linealizer for scalar view
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linScalarView; // linealizer for scalar view
 
     // vector view
-    Hermes::Hermes2D::Views::Vectorizer m_vecVectorView; // vectorizer for vector view
+    QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> m_vecVectorView; // vectorizer for vector view
 
     // view
     FieldInfo *m_activeViewField;
     int m_activeTimeStep;
     int m_activeAdaptivityStep;
     SolutionMode m_activeSolutionMode;
+    PostViewMode m_activeViewMode;
+
+    // processed views (least recently used view is first in m_cacheIDOrder)
+    struct CachedView
+    {
+        QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer;
+        QSharedPointer<Hermes::Hermes2D::Views::Orderizer> orderizer;
+        QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> vectorizer;
+
+        // estimated memory footprint (in bytes)
+        qint64 memory;
+    };
+
+    QMap<PostHermesTaskID, CachedView> m_cache;
+    QList<PostHermesTaskID> m_cacheIDOrder;
+    qint64 m_cacheMemory;
+
+    int m_cacheHits;
+    int m_cacheMisses;
+
+    bool isViewRequired(PostHermesTask task) const;
+    void resetViews();
+
+    // returns true and cached view if the task was already processed
+    bool cachedView(const PostHermesTaskID &id, CachedView &view);
+    void insertCachedView(const PostHermesTaskID &id, const CachedView &view);
+    void clearCache();
+
+    // deformed shape of the active solution
+    template <typename View>
+    void setDisplacement(View *view, bool deform);
 
 private slots:
     void processMeshed();
     void processSolved();
 
+    void refreshViewMode();
+
     void processInitialMesh();
     void processSolutionMesh();
     void processOrder();
@@ -132,6 +230,46 @@ private slots:
     void problemSolved();
 };
 
+// vertex data of the post views stored in the vertex buffer objects
+// (client side arrays are used if VBOs are not supported)
+class PostVertexBuffer
+{
+public:
+    PostVertexBuffer();
+    ~PostVertexBuffer();
+
+    // filled before upload (released after upload to VBOs)
+    QVector<QVector3D> vertices;
+    QVector<QVector3D> normals;
+    QVector<QVector3D> colors;
+    QVector<GLfloat> texCoords; // palette
+    QVector<GLuint> indices;
+
+    inline bool isUploaded() const { return m_isUploaded; }
+    void upload();
+
+    void draw(GLenum mode);
+    void clear();
+
+private:
+    Q_DISABLE_COPY(PostVertexBuffer)
+
+    bool m_isUploaded;
+    bool m_useBuffers;
+
+    int m_vertexCount;
+    int m_indexCount;
+    bool m_hasNormals;
+    bool m_hasColors;
+    bool m_hasTexCoords;
+
+    QGLBuffer m_vertexBuffer;
+    QGLBuffer m_normalBuffer;
+    QGLBuffer m_colorBuffer;
+    QGLBuffer m_texCoordBuffer;
+    QGLBuffer m_indexBuffer;
+};
+
 class SceneViewPostInterface : public SceneViewCommon
 {
     Q_OBJECT
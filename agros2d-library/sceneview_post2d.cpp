@@ -48,9 +48,6 @@
 
 SceneViewPost2D::SceneViewPost2D(PostHermes *postHermes, QWidget *parent)
     : SceneViewCommon2D(postHermes, parent),
-      m_listContours(-1),
-      m_listVectors(-1),
-      m_listScalarField(-1),
       m_selectedPoint(Point())
 {
     createActionsPost2D();
@@ -165,10 +162,10 @@ void SceneViewPost2D::mousePressEvent(QMouseEvent *event)
         if (actPostprocessorModeVolumeIntegral->isChecked())
         {
             Hermes::Hermes2D::Element *e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(false, postHermes()->activeViewField()->initialMesh(), p.x, p.y);
-            if (e)
+            int labelIndex = e ? postHermes()->activeViewField()->hermesMarkerToLabel(e->marker) : -1;
+            if (labelIndex != -1)
             {
-                SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().
-                                                                      get_user_marker(e->marker).marker.c_str()));
+                SceneLabel *label = Agros2D::scene()->labels->at(labelIndex);
 
                 label->setSelected(!label->isSelected());
                 updateGL();
@@ -308,167 +305,83 @@ void SceneViewPost2D::paintScalarField()
 
     loadProjection2d(true);
 
-    if (m_listScalarField == -1)
+    if (!m_bufferScalarField.isUploaded())
     {
         paletteCreate();
 
-        m_listScalarField = glGenLists(1);
-        glNewList(m_listScalarField, GL_COMPILE);
+        double rangeMin = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble();
+        double rangeMax = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble();
+        bool rangeAuto = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool();
+        bool rangeLog = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool();
+        double rangeBase = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt();
 
         // range
-        double irange = 1.0 / (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble());
+        double irange = 1.0 / (rangeMax - rangeMin);
         // special case: constant solution
-        if (fabs(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) < EPS_ZERO)
+        if (fabs(rangeMax - rangeMin) < EPS_ZERO)
             irange = 1.0;
 
         m_postHermes->linScalarView().lock_data();
 
         double3* linVert = m_postHermes->linScalarView().get_vertices();
         int3* linTris = m_postHermes->linScalarView().get_triangles();
-        Point point[3];
-        double value[3];
+        int numVertices = m_postHermes->linScalarView().get_num_vertices();
+        int numTriangles = m_postHermes->linScalarView().get_num_triangles();
 
-        // set texture for coloring
-        glEnable(GL_TEXTURE_1D);
-        glBindTexture(GL_TEXTURE_1D, m_textureScalar);
-        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
-
-        // set texture transformation matrix
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glTranslated(m_texShift, 0.0, 0.0);
-        glScaled(m_texScale, 0.0, 0.0);
-
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_postHermes->linScalarView().get_num_triangles(); i++)
+        // vertices with palette coordinates
+        m_bufferScalarField.vertices.reserve(numVertices);
+        m_bufferScalarField.texCoords.reserve(numVertices);
+        for (int i = 0; i < numVertices; i++)
         {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = linVert[linTris[i][j]][0];
-                point[j].y = linVert[linTris[i][j]][1];
-                value[j]   = linVert[linTris[i][j]][2];
-            }
+            m_bufferScalarField.vertices.append(QVector3D(linVert[i][0], linVert[i][1], 0.0));
 
-            if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
-            {
-                double avgValue = (value[0] + value[1] + value[2]) / 3.0;
-                if (avgValue < Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() || avgValue > Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble())
-                    continue;
-            }
-
-            for (int j = 0; j < 3; j++)
-            {
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool())
-                    glTexCoord1d(log10((double) (1 + (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt() - 1))
-                                       * (value[j] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange) / log10((double) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt()));
-                else
-                    glTexCoord1d((value[j] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange);
-                glVertex2d(point[j].x, point[j].y);
-            }
+            if (rangeLog)
+                m_bufferScalarField.texCoords.append(log10((double) (1 + (rangeBase - 1)) * (linVert[i][2] - rangeMin) * irange) / log10(rangeBase));
+            else
+                m_bufferScalarField.texCoords.append((linVert[i][2] - rangeMin) * irange);
         }
-        glEnd();
-
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glDisable(GL_TEXTURE_1D);
-
-        // switch-off texture transform
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glMatrixMode(GL_MODELVIEW);
-
-        m_postHermes->linScalarView().unlock_data();
-
-        glEndList();
-
-        glCallList(m_listScalarField);
-
-        /*
-        // range
-        double irange = PALETTEENTRIES / (Agros2D::problem()->configView()->scalarRangeMax - Agros2D::problem()->configView()->scalarRangeMin);
-        // special case: constant solution
-        if (fabs(Agros2D::problem()->configView()->scalarRangeMax - Agros2D::problem()->configView()->scalarRangeMin) < EPS_ZERO)
-            irange = PALETTEENTRIES / 2;
-
-        m_postHermes->linScalarView().lock_data();
 
-        double3* linVert = m_postHermes->linScalarView().get_vertices();
-        int3* linTris = m_postHermes->linScalarView().get_triangles();
-        Point point[3];
-        double value[3];
-
-        for (int i = 0; i < m_postHermes->linScalarView().get_num_triangles(); i++)
+        // triangles
+        m_bufferScalarField.indices.reserve(3 * numTriangles);
+        for (int i = 0; i < numTriangles; i++)
         {
-            for (int j = 0; j < 3; j++)
+            if (!rangeAuto)
             {
-                point[j].x = linVert[linTris[i][j]][0];
-                point[j].y = linVert[linTris[i][j]][1];
-                value[j]   = linVert[linTris[i][j]][2];
-            }
-
-            if (!Agros2D::problem()->configView()->scalarRangeAuto)
-            {
-                double avgValue = (value[0] + value[1] + value[2]) / 3.0;
-                if (avgValue < Agros2D::problem()->configView()->scalarRangeMin || avgValue > Agros2D::problem()->configView()->scalarRangeMax)
+                double avgValue = (linVert[linTris[i][0]][2] + linVert[linTris[i][1]][2] + linVert[linTris[i][2]][2]) / 3.0;
+                if (avgValue < rangeMin || avgValue > rangeMax)
                     continue;
             }
 
             for (int j = 0; j < 3; j++)
-            {
-                m_arrayScalarField.push_back(QVector2D(point[j].x, point[j].y));
-
-                const double* color = paletteColor2((value[j] - Agros2D::problem()->configView()->scalarRangeMin) * irange);
-
-                m_arrayScalarFieldColors.push_back(QVector3D(color[0], color[1], color[2]));
-                // qDebug() << ((value[j] - Agros2D::problem()->configView()->scalarRangeMin) * irange) << m_arrayScalarFieldColors.at(m_arrayScalarFieldColors.count() - 1);
-
-            }
+                m_bufferScalarField.indices.append(linTris[i][j]);
         }
 
         m_postHermes->linScalarView().unlock_data();
-        */
-    }
-    else
-    {
-        glCallList(m_listScalarField);
 
-        /*
-        double3* linVert = m_postHermes->linScalarView().get_vertices();
-        int3* linTris = m_postHermes->linScalarView().get_triangles();
-
-        Point point[3];
-        double value[3];
-
-        glLineWidth(1.0);
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        m_bufferScalarField.upload();
+    }
 
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_postHermes->linScalarView().get_num_triangles(); i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = linVert[linTris[i][j]][0];
-                point[j].y = linVert[linTris[i][j]][1];
-                value[j]   = linVert[linTris[i][j]][2];
+    // set texture for coloring
+    glEnable(GL_TEXTURE_1D);
+    glBindTexture(GL_TEXTURE_1D, m_textureScalar);
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
 
-                glVertex2d(point[j].x, point[j].y);
-            }
-        }
-        glEnd();
-        */
-        /*
-        glEnableClientState(GL_COLOR_ARRAY);
-        glEnableClientState(GL_VERTEX_ARRAY);
+    // set texture transformation matrix
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslated(m_texShift, 0.0, 0.0);
+    glScaled(m_texScale, 0.0, 0.0);
+    glMatrixMode(GL_MODELVIEW);
 
-        glColorPointer(3, GL_FLOAT, 0, m_arrayScalarFieldColors.constData());
-        glVertexPointer(2, GL_FLOAT, 0, m_arrayScalarField.constData());
+    m_bufferScalarField.draw(GL_TRIANGLES);
 
-        glDrawArrays(GL_TRIANGLES, 0, m_arrayScalarField.size());
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_TEXTURE_1D);
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_COLOR_ARRAY);
-        */
-    }
+    // switch-off texture transform
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void SceneViewPost2D::paintContours()
@@ -478,68 +391,55 @@ void SceneViewPost2D::paintContours()
 
     loadProjection2d(true);
 
-    if (m_listContours == -1)
+    if (!m_bufferContours.isUploaded())
     {
-        m_listContours = glGenLists(1);
-        glNewList(m_listContours, GL_COMPILE);
-
         m_postHermes->linContourView().lock_data();
 
-        double3* vecVert = m_postHermes->linContourView().get_vertices();
+        double3* vert = m_postHermes->linContourView().get_vertices();
         int3* tris = m_postHermes->linContourView().get_contour_triangles();
 
         // transform variable
         double rangeMin =  numeric_limits<double>::max();
         double rangeMax = -numeric_limits<double>::max();
 
-        double3* vert = new double3[m_postHermes->linContourView().get_num_vertices()];
         for (int i = 0; i < m_postHermes->linContourView().get_num_vertices(); i++)
         {
-            vert[i][0] = vecVert[i][0];
-            vert[i][1] = vecVert[i][1];
-            vert[i][2] = vecVert[i][2];
-
-            if (vert[i][2] > rangeMax) rangeMax = vecVert[i][2];
-            if (vert[i][2] < rangeMin) rangeMin = vecVert[i][2];
+            if (vert[i][2] > rangeMax) rangeMax = vert[i][2];
+            if (vert[i][2] < rangeMin) rangeMin = vert[i][2];
         }
 
-        // draw contours
+        // contour lines
         if ((rangeMax-rangeMin) > EPS_ZERO)
         {
             // value range
             double step = (rangeMax-rangeMin) / Agros2D::problem()->setting()->value(ProblemSetting::View_ContoursCount).toInt();
 
-            glLineWidth(Agros2D::problem()->setting()->value(ProblemSetting::View_ContoursWidth).toInt());
-            glColor3d(Agros2D::problem()->setting()->value(ProblemSetting::View_ColorContoursRed).toInt() / 255.0,
-                      Agros2D::problem()->setting()->value(ProblemSetting::View_ColorContoursGreen).toInt() / 255.0,
-                      Agros2D::problem()->setting()->value(ProblemSetting::View_ColorContoursBlue).toInt() / 255.0);
-
-            glBegin(GL_LINES);
             for (int i = 0; i < m_postHermes->linContourView().get_num_contour_triangles(); i++)
             {
                 if (finite(vert[tris[i][0]][2]) && finite(vert[tris[i][1]][2]) && finite(vert[tris[i][2]][2]))
                 {
-                    paintContoursTri(vert, &tris[i], step);
+                    paintContoursTri(vert, &tris[i], step, m_bufferContours.vertices);
                 }
             }
-            glEnd();
         }
 
-        delete vert;
-
         m_postHermes->linContourView().unlock_data();
 
-        glEndList();
-
-        glCallList(m_listContours);
-    }
-    else
-    {
-        glCallList(m_listContours);
+        m_bufferContours.upload();
     }
+
+    // draw contours
+    glLineWidth(Agros2D::problem()->setting()->value(ProblemSetting::View_ContoursWidth).toInt());
+    glColor3d(Agros2D::problem()->setting()->value(ProblemSetting::View_ColorContoursRed).toInt() / 255.0,
+              Agros2D::problem()->setting()->value(ProblemSetting::View_ColorContoursGreen).toInt() / 255.0,
+              Agros2D::problem()->setting()->value(ProblemSetting::View_ColorContoursBlue).toInt() / 255.0);
+
+    m_bufferContours.draw(GL_LINES);
+
+    glLineWidth(1.0);
 }
 
-void SceneViewPost2D::paintContoursTri(double3* vert, int3* tri, double step)
+void SceneViewPost2D::paintContoursTri(double3* vert, int3* tri, double step, QVector<QVector3D> &lines)
 {
     // sort the vertices by their value, keep track of the permutation sign
     int i, idx[3], perm = 0;
@@ -578,13 +478,13 @@ void SceneViewPost2D::paintContoursTri(double3* vert, int3* tri, double step)
 
             if (perm & 1)
             {
-                glVertex2d(x1, y1);
-                glVertex2d(x2, y2);
+                lines.append(QVector3D(x1, y1, 0.0));
+                lines.append(QVector3D(x2, y2, 0.0));
             }
             else
             {
-                glVertex2d(x2, y2);
-                glVertex2d(x1, y1);
+                lines.append(QVector3D(x2, y2, 0.0));
+                lines.append(QVector3D(x1, y1, 0.0));
             }
 
             val += step;
@@ -833,11 +733,8 @@ void SceneViewPost2D::paintVectors()
 
     loadProjection2d(true);
 
-    if (m_listVectors == -1)
+    if (!m_bufferVectors.isUploaded())
     {
-        m_listVectors = glGenLists(1);
-        glNewList(m_listVectors, GL_COMPILE);
-
         double vectorRangeMin = m_postHermes->vecVectorView().get_min_value();
         double vectorRangeMax = m_postHermes->vecVectorView().get_max_value();
 
@@ -854,38 +751,22 @@ void SceneViewPost2D::paintVectors()
         RectPoint rect = Agros2D::scene()->boundingBox();
         double gs = (rect.width() + rect.height()) / Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCount).toInt();
 
+        // settings are read once (not for every arrow)
+        bool vectorProportional = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorProportional).toBool();
+        bool vectorColor = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorColor).toBool();
+        double vectorScale = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble();
+        VectorCenter vectorCenter = (VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt();
+        VectorType vectorType = (VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt();
+        QVector3D colorVectors(Agros2D::problem()->setting()->value(ProblemSetting::View_ColorVectorsRed).toInt() / 255.0,
+                               Agros2D::problem()->setting()->value(ProblemSetting::View_ColorVectorsGreen).toInt() / 255.0,
+                               Agros2D::problem()->setting()->value(ProblemSetting::View_ColorVectorsBlue).toInt() / 255.0);
+
         // paint
         m_postHermes->vecVectorView().lock_data();
 
         double4* vecVert = m_postHermes->vecVectorView().get_vertices();
         int3* vecTris = m_postHermes->vecVectorView().get_triangles();
 
-        /*
-        Point point[3];
-        double value[3];
-
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_postHermes->vecVectorView().get_num_triangles(); i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = vecVert[vecTris[i][j]][0];
-                point[j].y = vecVert[vecTris[i][j]][1];
-                value[j]   = vecVert[vecTris[i][j]][2];
-
-                glVertex2d(point[j].x, point[j].y);
-            }
-        }
-        glEnd();
-        */
-
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-        glBegin(GL_TRIANGLES);
         for (int i = 0; i < m_postHermes->vecVectorView().get_num_triangles(); i++)
         {
             Point a(vecVert[vecTris[i][0]][0], vecVert[vecTris[i][0]][1]);
@@ -953,7 +834,7 @@ void SceneViewPost2D::paintVectors()
                         double value = sqrt(dx*dx + dy*dy);
                         double angle = atan2(dy, dx);
 
-                        if ((Agros2D::problem()->setting()->value(ProblemSetting::View_VectorProportional).toBool()) && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
+                        if (vectorProportional && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
                         {
                             if ((value / vectorRangeMax) < 1e-6)
                             {
@@ -962,40 +843,37 @@ void SceneViewPost2D::paintVectors()
                             }
                             else
                             {
-                                dx = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * cos(angle);
-                                dy = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * sin(angle);
+                                dx = ((value - vectorRangeMin) * irange) * vectorScale * gs * cos(angle);
+                                dy = ((value - vectorRangeMin) * irange) * vectorScale * gs * sin(angle);
                             }
                         }
                         else
                         {
-                            dx = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * cos(angle);
-                            dy = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * sin(angle);
+                            dx = vectorScale * gs * cos(angle);
+                            dy = vectorScale * gs * sin(angle);
                         }
 
                         double dm = sqrt(dx*dx + dy*dy);
 
                         // color
-                        if ((Agros2D::problem()->setting()->value(ProblemSetting::View_VectorColor).toBool())
-                                && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
+                        QVector3D color = colorVectors;
+                        if (vectorColor && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
                         {
-                            double color = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
-                            glColor3d(color, color, color);
-                        }
-                        else
-                        {
-                            glColor3d(Agros2D::problem()->setting()->value(ProblemSetting::View_ColorVectorsRed).toInt() / 255.0,
-                                      Agros2D::problem()->setting()->value(ProblemSetting::View_ColorVectorsGreen).toInt() / 255.0,
-                                      Agros2D::problem()->setting()->value(ProblemSetting::View_ColorVectorsBlue).toInt() / 255.0);
+                            double gray = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
+                            color = QVector3D(gray, gray, gray);
                         }
 
                         // tail
                         Point shiftCenter(0.0, 0.0);
-                        if ((VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt() == VectorCenter_Head)
+                        if (vectorCenter == VectorCenter_Head)
                             shiftCenter = Point(- 2.0*dm * cos(angle), - 2.0*dm * sin(angle)); // head
-                        if ((VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt() == VectorCenter_Center)
+                        if (vectorCenter == VectorCenter_Center)
                             shiftCenter = Point(- dm * cos(angle), - dm * sin(angle)); // center
 
-                        if ((VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt() == VectorType_Arrow)
+                        // glyph is appended to the buffer (all arrows are drawn at once)
+                        int first = m_bufferVectors.vertices.count();
+
+                        if (vectorType == VectorType_Arrow)
                         {
                             // arrow and shaft
                             // head for an arrow
@@ -1006,9 +884,9 @@ void SceneViewPost2D::paintVectors()
                             double vh3x = point.x + 2.0 * dm * cos(angle) + shiftCenter.x;
                             double vh3y = point.y + 2.0 * dm * sin(angle) + shiftCenter.y;
 
-                            glVertex2d(vh1x, vh1y);
-                            glVertex2d(vh2x, vh2y);
-                            glVertex2d(vh3x, vh3y);
+                            m_bufferVectors.vertices.append(QVector3D(vh1x, vh1y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vh2x, vh2y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vh3x, vh3y, 0.0));
 
                             // shaft for an arrow
                             double vs1x = point.x + dm/15.0 * cos(angle + M_PI/2.0) + dm * cos(angle) + shiftCenter.x;
@@ -1020,14 +898,14 @@ void SceneViewPost2D::paintVectors()
                             double vs4x = vs2x - dm * cos(angle);
                             double vs4y = vs2y - dm * sin(angle);
 
-                            glVertex2d(vs1x, vs1y);
-                            glVertex2d(vs2x, vs2y);
-                            glVertex2d(vs3x, vs3y);
-                            glVertex2d(vs4x, vs4y);
-                            glVertex2d(vs3x, vs3y);
-                            glVertex2d(vs2x, vs2y);
+                            m_bufferVectors.vertices.append(QVector3D(vs1x, vs1y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vs2x, vs2y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vs3x, vs3y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vs4x, vs4y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vs3x, vs3y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vs2x, vs2y, 0.0));
                         }
-                        else if ((VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt() == VectorType_Cone)
+                        else if (vectorType == VectorType_Cone)
                         {
                             // cone
                             double vh1x = point.x + dm/3.5 * cos(angle - M_PI/2.0) + shiftCenter.x;
@@ -1037,28 +915,29 @@ void SceneViewPost2D::paintVectors()
                             double vh3x = point.x + 2.0 * dm * cos(angle) + shiftCenter.x;
                             double vh3y = point.y + 2.0 * dm * sin(angle) + shiftCenter.y;
 
-                            glVertex2d(vh1x, vh1y);
-                            glVertex2d(vh2x, vh2y);
-                            glVertex2d(vh3x, vh3y);
+                            m_bufferVectors.vertices.append(QVector3D(vh1x, vh1y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vh2x, vh2y, 0.0));
+                            m_bufferVectors.vertices.append(QVector3D(vh3x, vh3y, 0.0));
                         }
+
+                        for (int v = first; v < m_bufferVectors.vertices.count(); v++)
+                            m_bufferVectors.colors.append(color);
                     }
                 }
             }
         }
-        glEnd();
-
-        glDisable(GL_POLYGON_OFFSET_FILL);
 
         m_postHermes->vecVectorView().unlock_data();
 
-        glEndList();
-
-        glCallList(m_listVectors);
-    }
-    else
-    {
-        glCallList(m_listVectors);
+        m_bufferVectors.upload();
     }
+
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    m_bufferVectors.draw(GL_TRIANGLES);
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
 }
 
 void SceneViewPost2D::paintPostprocessorSelectedVolume()
@@ -1152,13 +1031,9 @@ void SceneViewPost2D::paintPostprocessorSelectedPoint()
 
 void SceneViewPost2D::clearGLLists()
 {
-    if (m_listContours != -1) glDeleteLists(m_listContours, 1);
-    if (m_listVectors != -1) glDeleteLists(m_listVectors, 1);
-    if (m_listScalarField != -1) glDeleteLists(m_listScalarField, 1);
-
-    m_listContours = -1;
-    m_listVectors = -1;
-    m_listScalarField = -1;
+    m_bufferContours.clear();
+    m_bufferVectors.clear();
+    m_bufferScalarField.clear();
 }
 
 void SceneViewPost2D::refresh()
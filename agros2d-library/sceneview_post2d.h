@@ -72,7 +72,7 @@ protected:
 
     void paintScalarField(); // paint scalar field surface
     void paintContours(); // paint scalar field contours
-    void paintContoursTri(double3* vert, int3* tri, double step);
+    void paintContoursTri(double3* vert, int3* tri, double step, QVector<QVector3D> &lines);
     void paintVectors(); // paint vector field vectors
 
     void paintPostprocessorSelectedVolume(); // paint selected volume for integration
@@ -83,13 +83,10 @@ private:
     // selected point
     Point m_selectedPoint;
 
-    // gl lists
-    int m_listContours;
-    int m_listVectors;
-    int m_listScalarField;
-
-    // QVector<QVector2D> m_arrayScalarField;
-    // QVector<QVector3D> m_arrayScalarFieldColors;
+    // vertex buffers
+    PostVertexBuffer m_bufferContours;
+    PostVertexBuffer m_bufferVectors;
+    PostVertexBuffer m_bufferScalarField;
 
     void createActionsPost2D();
 
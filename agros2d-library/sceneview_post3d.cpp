@@ -167,137 +167,97 @@ void SceneViewPost3D::paintScalarField3D()
 
     loadProjection3d(true, ((SceneViewPost3DMode) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DMode).toInt()) == SceneViewPost3DMode_ScalarView3D);
 
-    if (m_listScalarField3D == -1)
-    {
-        paletteCreate();
-
-        m_listScalarField3D = glGenLists(1);
-        glNewList(m_listScalarField3D, GL_COMPILE);
+    double rangeMin = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble();
+    double rangeMax = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble();
 
-        glPushMatrix();
+    // range
+    double irange = 1.0 / (rangeMax - rangeMin);
+    // special case: constant solution
+    if (fabs(rangeMin - rangeMax) < EPS_ZERO)
+    {
+        irange = 1.0;
+    }
 
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
+    RectPoint rect = Agros2D::scene()->boundingBox();
 
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
+    double max = qMax(rect.width(), rect.height());
 
-        glPopMatrix();
+    if (!m_bufferScalarField3D.isUploaded())
+    {
+        paletteCreate();
 
-        glEnable(GL_DEPTH_TEST);
-
-        // range
-        double irange = 1.0 / (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble());
-        // special case: constant solution
-        if (fabs(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble()) < EPS_ZERO)
-        {
-            irange = 1.0;
-        }
+        bool rangeAuto = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool();
+        bool lighting = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool();
 
         m_postHermes->linScalarView().lock_data();
 
         double3* linVert = m_postHermes->linScalarView().get_vertices();
         int3* linTris = m_postHermes->linScalarView().get_triangles();
-        Point point[3];
-        double value[3];
-
-        RectPoint rect = Agros2D::scene()->boundingBox();
-
-        double max = qMax(rect.width(), rect.height());
-
-        glPushMatrix();
-        glScaled(1.0, 1.0, max / Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DHeight).toDouble() * fabs(irange));
-
-        // scalar view
-        initLighting();
-        // init normal
-        double *normal = new double[3];
+        int numTriangles = m_postHermes->linScalarView().get_num_triangles();
 
-        // set texture for coloring
-        if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool())
-            glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-        else
-            glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
-        glEnable(GL_TEXTURE_1D);
-        glBindTexture(GL_TEXTURE_1D, m_textureScalar);
-
-        // set texture transformation matrix
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glTranslated(m_texShift, 0.0, 0.0);
-        glScaled(m_texScale, 0.0, 0.0);
+        // vertices are not shared (flat shading with normal of the triangle)
+        m_bufferScalarField3D.vertices.reserve(3 * numTriangles);
+        m_bufferScalarField3D.texCoords.reserve(3 * numTriangles);
+        if (lighting)
+            m_bufferScalarField3D.normals.reserve(3 * numTriangles);
 
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_postHermes->linScalarView().get_num_triangles(); i++)
+        double normal[3];
+        for (int i = 0; i < numTriangles; i++)
         {
-            point[0].x = linVert[linTris[i][0]][0];
-            point[0].y = linVert[linTris[i][0]][1];
-            value[0]   = linVert[linTris[i][0]][2];
-            point[1].x = linVert[linTris[i][1]][0];
-            point[1].y = linVert[linTris[i][1]][1];
-            value[1]   = linVert[linTris[i][1]][2];
-            point[2].x = linVert[linTris[i][2]][0];
-            point[2].y = linVert[linTris[i][2]][1];
-            value[2]   = linVert[linTris[i][2]][2];
-
-            if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
+            double value[3];
+            for (int j = 0; j < 3; j++)
+                value[j] = linVert[linTris[i][j]][2];
+
+            if (!rangeAuto)
             {
                 double avgValue = (value[0] + value[1] + value[2]) / 3.0;
-                if (avgValue < Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() || avgValue > Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble())
+                if (avgValue < rangeMin || avgValue > rangeMax)
                     continue;
             }
 
-            double delta = 0.0;
-
-            if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool())
+            if (lighting)
             {
-                computeNormal(point[0].x, point[0].y, - delta - (value[0] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()),
-                        point[1].x, point[1].y, - delta - (value[1] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()),
-                        point[2].x, point[2].y, - delta - (value[2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()),
+                computeNormal(linVert[linTris[i][0]][0], linVert[linTris[i][0]][1], - (value[0] - rangeMin),
+                        linVert[linTris[i][1]][0], linVert[linTris[i][1]][1], - (value[1] - rangeMin),
+                        linVert[linTris[i][2]][0], linVert[linTris[i][2]][1], - (value[2] - rangeMin),
                         normal);
-
-                glNormal3d(normal[0], normal[1], normal[2]);
             }
+
             for (int j = 0; j < 3; j++)
             {
-                glTexCoord1d((value[j] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange);
-                glVertex3d(point[j].x, point[j].y, - delta - (value[j] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()));
+                m_bufferScalarField3D.vertices.append(QVector3D(linVert[linTris[i][j]][0], linVert[linTris[i][j]][1], - (value[j] - rangeMin)));
+                m_bufferScalarField3D.texCoords.append((value[j] - rangeMin) * irange);
+                if (lighting)
+                    m_bufferScalarField3D.normals.append(QVector3D(normal[0], normal[1], normal[2]));
             }
         }
-        glEnd();
 
-        // remove normal
-        delete [] normal;
-
-        glDisable(GL_TEXTURE_1D);
-        glDisable(GL_LIGHTING);
+        m_postHermes->linScalarView().unlock_data();
 
-        // draw blended mesh
-        glEnable(GL_BLEND);
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glColor4d(0.5, 0.5, 0.5, 0.3);
+        m_bufferScalarField3D.upload();
 
+        // initial mesh
         m_postHermes->linInitialMeshView().lock_data();
 
         double3* linVertMesh = m_postHermes->linInitialMeshView().get_vertices();
         int3* linTrisMesh = m_postHermes->linInitialMeshView().get_triangles();
 
+        for (int i = 0; i < m_postHermes->linInitialMeshView().get_num_vertices(); i++)
+            m_bufferScalarField3DMesh.vertices.append(QVector3D(linVertMesh[i][0], linVertMesh[i][1], 0.0));
+
         // triangles
-        glBegin(GL_TRIANGLES);
+        m_bufferScalarField3DMesh.indices.reserve(3 * m_postHermes->linInitialMeshView().get_num_triangles());
         for (int i = 0; i < m_postHermes->linInitialMeshView().get_num_triangles(); i++)
-        {
-            glVertex2d(linVertMesh[linTrisMesh[i][0]][0], linVertMesh[linTrisMesh[i][0]][1]);
-            glVertex2d(linVertMesh[linTrisMesh[i][1]][0], linVertMesh[linTrisMesh[i][1]][1]);
-            glVertex2d(linVertMesh[linTrisMesh[i][2]][0], linVertMesh[linTrisMesh[i][2]][1]);
-        }
-        glEnd();
+            for (int j = 0; j < 3; j++)
+                m_bufferScalarField3DMesh.indices.append(linTrisMesh[i][j]);
 
         m_postHermes->linInitialMeshView().unlock_data();
 
-        glDisable(GL_BLEND);
-        glDisable(GL_POLYGON_OFFSET_FILL);
+        m_bufferScalarField3DMesh.upload();
+
+        // bounding box and geometry
+        m_listScalarField3D = glGenLists(1);
+        glNewList(m_listScalarField3D, GL_COMPILE);
 
         // bounding box
         if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DBoundingBox).toBool())
@@ -363,25 +323,70 @@ void SceneViewPost3D::paintScalarField3D()
             glLineWidth(1.0);
         }
 
-        glDisable(GL_DEPTH_TEST);
+        glEndList();
+    }
 
-        // switch-off texture transform
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
 
-        glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
 
-        m_postHermes->linScalarView().unlock_data();
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
 
-        glEndList();
+    glPopMatrix();
 
-        glCallList(m_listScalarField3D);
-    }
+    glEnable(GL_DEPTH_TEST);
+
+    glPushMatrix();
+    glScaled(1.0, 1.0, max / Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DHeight).toDouble() * fabs(irange));
+
+    // scalar view
+    initLighting();
+
+    // set texture for coloring
+    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool())
+        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
     else
-    {
-        glCallList(m_listScalarField3D);
-    }
+        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
+    glEnable(GL_TEXTURE_1D);
+    glBindTexture(GL_TEXTURE_1D, m_textureScalar);
+
+    // set texture transformation matrix
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslated(m_texShift, 0.0, 0.0);
+    glScaled(m_texScale, 0.0, 0.0);
+    glMatrixMode(GL_MODELVIEW);
+
+    m_bufferScalarField3D.draw(GL_TRIANGLES);
+
+    glDisable(GL_TEXTURE_1D);
+    glDisable(GL_LIGHTING);
+
+    // draw blended mesh
+    glEnable(GL_BLEND);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glColor4d(0.5, 0.5, 0.5, 0.3);
+
+    m_bufferScalarField3DMesh.draw(GL_TRIANGLES);
+
+    glDisable(GL_BLEND);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+
+    // bounding box and geometry
+    glCallList(m_listScalarField3D);
+
+    glDisable(GL_DEPTH_TEST);
+
+    // switch-off texture transform
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+
+    glPopMatrix();
 }
 
 void SceneViewPost3D::paintScalarField3DSolid()
@@ -486,8 +491,12 @@ void SceneViewPost3D::paintScalarField3DSolid()
                     value[j]   = linVert[linTris[i][j]][2];
                 }
 
-                // find marker
-                SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().get_user_marker(linTrisMarkers[i]).marker.c_str()));
+                // find marker (elements without label are skipped)
+                int labelIndex = postHermes()->activeViewField()->hermesMarkerToLabel(linTrisMarkers[i]);
+                if (labelIndex == -1)
+                    continue;
+
+                SceneLabel *label = Agros2D::scene()->labels->at(labelIndex);
                 SceneMaterial *material = label->marker(postHermes()->activeViewField());
 
                 // hide material
@@ -548,8 +557,12 @@ void SceneViewPost3D::paintScalarField3DSolid()
                         value[j]   = linVert[linTris[i][j]][2];
                     }
 
-                    // find marker
-                    SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().get_user_marker(linTrisMarkers[i]).marker.c_str()));
+                    // find marker (elements without label are skipped)
+                    int labelIndex = postHermes()->activeViewField()->hermesMarkerToLabel(linTrisMarkers[i]);
+                    if (labelIndex == -1)
+                        continue;
+
+                    SceneLabel *label = Agros2D::scene()->labels->at(labelIndex);
                     SceneMaterial *material = label->marker(postHermes()->activeViewField());
 
                     // hide material
@@ -595,8 +608,12 @@ void SceneViewPost3D::paintScalarField3DSolid()
                     value[j]   = linVert[linTris[i][j]][2];
                 }
 
-                // find marker
-                SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().get_user_marker(linTrisMarkers[i]).marker.c_str()));
+                // find marker (elements without label are skipped)
+                int labelIndex = postHermes()->activeViewField()->hermesMarkerToLabel(linTrisMarkers[i]);
+                if (labelIndex == -1)
+                    continue;
+
+                SceneLabel *label = Agros2D::scene()->labels->at(labelIndex);
                 SceneMaterial *material = label->marker(postHermes()->activeViewField());
 
                 // hide material
@@ -643,8 +660,12 @@ void SceneViewPost3D::paintScalarField3DSolid()
                         value[j]   = linVert[linTris[i][j]][2];
                     }
 
-                    // find marker
-                    SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().get_user_marker(linTrisMarkers[i]).marker.c_str()));
+                    // find marker (elements without label are skipped)
+                    int labelIndex = postHermes()->activeViewField()->hermesMarkerToLabel(linTrisMarkers[i]);
+                    if (labelIndex == -1)
+                        continue;
+
+                    SceneLabel *label = Agros2D::scene()->labels->at(labelIndex);
                     SceneMaterial *material = label->marker(postHermes()->activeViewField());
 
                     // hide material
@@ -854,6 +875,9 @@ void SceneViewPost3D::paintScalarField3DSolid()
 
 void SceneViewPost3D::clearGLLists()
 {
+    m_bufferScalarField3D.clear();
+    m_bufferScalarField3DMesh.clear();
+
     if (m_listScalarField3D != -1) glDeleteLists(m_listScalarField3D, 1);
     if (m_listScalarField3DSolid != -1) glDeleteLists(m_listScalarField3DSolid, 1);
     if (m_listModel != -1) glDeleteLists(m_listModel, 1);
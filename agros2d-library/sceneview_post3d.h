@@ -52,8 +52,12 @@ protected:
     void paintScalarField3DSolid(); // paint scalar field 3d solid
 
 private:
+    // vertex buffers
+    PostVertexBuffer m_bufferScalarField3D;
+    PostVertexBuffer m_bufferScalarField3DMesh;
+
     // gl lists
-    int m_listScalarField3D;
+    int m_listScalarField3D; // bounding box and geometry of the scalar field 3d
     int m_listScalarField3DSolid;
     int m_listModel;
 
@@ -56,12 +56,25 @@ void Config::load()
     saveMatrixRHS = settings.value("Solution/SaveMatrixAndRHS", SAVEMATRIXANDRHS).toBool();
     dumpFormat = (Hermes::Algebra::MatrixExportFormat) settings.value("Solution/FormatMatrixAndRHS", EXPORT_FORMAT_PLAIN_ASCII).toInt();
 
-    // cache size
-    cacheSize = settings.value("Solution/CacheSize", CACHE_SIZE).toInt();
+    // cache size (MB)
+    if (!settings.contains("Solution/CacheSizeMB") && settings.contains("Solution/CacheSize"))
+    {
+        // former limit by number of solutions (default of 10 solutions corresponds to the default memory limit)
+        int numberOfSolutions = settings.value("Solution/CacheSize").toInt();
+        cacheSize = qBound(CACHE_SIZE_MIN, numberOfSolutions * CACHE_SIZE / 10, CACHE_SIZE_MAX);
+        settings.remove("Solution/CacheSize");
+    }
+    else
+    {
+        cacheSize = settings.value("Solution/CacheSizeMB", CACHE_SIZE).toInt();
+    }
 
     // solver cache
     useSolverCache = settings.value("Solution/UseSolverCache", USER_SOLVER_CACHE).toBool();
 
+    // mesh generator
+    meshTriangleLibrary = settings.value("Mesh/TriangleLibrary", MESH_TRIANGLE_LIBRARY).toBool();
+
     // number of threads
     numberOfThreads = settings.value("Parallel/NumberOfThreads", omp_get_max_threads()).toInt();
     if (numberOfThreads > omp_get_max_threads())
@@ -89,12 +102,15 @@ void Config::save()
     settings.setValue("Solution/SaveMatrixAndRHS", saveMatrixRHS);
     settings.setValue("Solution/FormatMatrixAndRHS", dumpFormat);
 
-    // cache size
-    settings.setValue("Solution/CacheSize", cacheSize);
+    // cache size (MB)
+    settings.setValue("Solution/CacheSizeMB", cacheSize);
 
     // solver cache
     settings.setValue("Solution/UseSolverCache", useSolverCache);
 
+    // mesh generator
+    settings.setValue("Mesh/TriangleLibrary", meshTriangleLibrary);
+
     // number of threads
     settings.setValue("Parallel/NumberOfThreads", numberOfThreads);
     Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, numberOfThreads);
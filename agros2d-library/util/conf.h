@@ -46,7 +46,7 @@ public:
     bool saveMatrixRHS;
     Hermes::Algebra::MatrixExportFormat dumpFormat;
 
-    // cache
+    // cache (MB)
     int cacheSize;
 
     // number of threads
@@ -55,6 +55,9 @@ public:
     // solver cache
     bool useSolverCache;
 
+    // use Triangle linked as a library instead of the executable
+    bool meshTriangleLibrary;
+
     void load();
     void save();
 };
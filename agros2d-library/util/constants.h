@@ -61,12 +61,17 @@ const int PALETTESTEPSMAX = PALETTEENTRIES;
 // command argument
 const QString COMMANDS_BUILD_PLUGIN = "./agros2d_plugin_compiler.sh %1";
 
-// cache size
-const int CACHE_SIZE = 10;
+// cache size (MB)
+const int CACHE_SIZE = 512;
+const int CACHE_SIZE_MIN = 16;
+const int CACHE_SIZE_MAX = 65536;
 
 // solver cache
 const bool USER_SOLVER_CACHE = false;
 
+// mesh generator
+const bool MESH_TRIANGLE_LIBRARY = true;
+
 const int NOT_FOUND_SO_FAR = -999;
 
 const int GLYPH_M = 77;
@@ -315,15 +315,12 @@ void readFromDXF(const QString &fileName)
     char *plocale = setlocale (LC_NUMERIC, "");
     setlocale (LC_NUMERIC, "C");
 
-    Agros2D::scene()->blockSignals(true);
-    Agros2D::scene()->stopInvalidating(true);
+    Agros2D::scene()->beginBatch(QObject::tr("Import DXF"));
 
     DxfInterfaceDXFRW filter(Agros2D::scene(), fileName);
     filter.read();
 
-    Agros2D::scene()->stopInvalidating(false);
-    Agros2D::scene()->blockSignals(false);
-    Agros2D::scene()->invalidate();
+    Agros2D::scene()->endBatch();
 
     // set system locale
     setlocale(LC_NUMERIC, plocale);
@@ -0,0 +1,139 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#include "edge_hash.h"
+
+#include <algorithm>
+
+// maximum number of cells in one direction
+static const int EDGE_HASH_MAX_SIZE = 100;
+
+EdgeHash::EdgeHash(const QList<RectPoint> &boxes) : m_boxes(boxes), m_sizeX(1), m_sizeY(1), m_cellX(1.0), m_cellY(1.0)
+{
+    if (m_boxes.isEmpty())
+    {
+        m_cells.resize(1);
+        return;
+    }
+
+    // bounding box of all edges
+    m_bound = m_boxes.first();
+    foreach (RectPoint box, m_boxes)
+    {
+        m_bound.start.x = qMin(m_bound.start.x, box.start.x);
+        m_bound.start.y = qMin(m_bound.start.y, box.start.y);
+        m_bound.end.x = qMax(m_bound.end.x, box.end.x);
+        m_bound.end.y = qMax(m_bound.end.y, box.end.y);
+    }
+
+    // approximately one edge per cell
+    int size = qBound(1, (int) ceil(sqrt((double) m_boxes.count())), EDGE_HASH_MAX_SIZE);
+    m_sizeX = size;
+    m_sizeY = size;
+    m_cellX = (m_bound.width() > 0.0) ? m_bound.width() / m_sizeX : 1.0;
+    m_cellY = (m_bound.height() > 0.0) ? m_bound.height() / m_sizeY : 1.0;
+
+    m_cells.resize(m_sizeX * m_sizeY);
+    for (int index = 0; index < m_boxes.count(); index++)
+    {
+        const RectPoint &box = m_boxes.at(index);
+
+        for (int i = cellX(box.start.x); i <= cellX(box.end.x); i++)
+            for (int j = cellY(box.start.y); j <= cellY(box.end.y); j++)
+                m_cells[i * m_sizeY + j].append(index);
+    }
+}
+
+RectPoint EdgeHash::edgeBoundingBox(const Point &start, const Point &end, const Point &center, double radius, double angle)
+{
+    RectPoint box(Point(qMin(start.x, end.x), qMin(start.y, end.y)),
+                  Point(qMax(start.x, end.x), qMax(start.y, end.y)));
+
+    if (angle > 0.0)
+    {
+        double sweep = angle / 180.0 * M_PI;
+
+        // arc goes counterclockwise either from the start or from the end node
+        double angleStart = atan2(start.y - center.y, start.x - center.x);
+        Point rotated(center.x + radius * cos(angleStart + sweep), center.y + radius * sin(angleStart + sweep));
+        if ((rotated - end).magnitude() > (rotated - start).magnitude())
+            angleStart = atan2(end.y - center.y, end.x - center.x);
+
+        // extreme points of the circle lying on the arc
+        for (int k = 0; k < 4; k++)
+        {
+            double angleExtreme = k * M_PI / 2.0;
+            double delta = fmod(angleExtreme - angleStart, 2.0 * M_PI);
+            if (delta < 0.0)
+                delta += 2.0 * M_PI;
+
+            if (delta <= sweep)
+            {
+                Point extreme(center.x + radius * cos(angleExtreme), center.y + radius * sin(angleExtreme));
+
+                box.start.x = qMin(box.start.x, extreme.x);
+                box.start.y = qMin(box.start.y, extreme.y);
+                box.end.x = qMax(box.end.x, extreme.x);
+                box.end.y = qMax(box.end.y, extreme.y);
+            }
+        }
+    }
+
+    // tolerance (intersection() accepts points slightly outside of the arc, 1e-3 degree)
+    double tolerance = qMax(qMax(box.width(), box.height()) * POINT_REL_ZERO, POINT_ABS_ZERO);
+    if (angle > 0.0)
+        tolerance = qMax(tolerance, radius * 1e-4);
+    box.start = box.start - Point(tolerance, tolerance);
+    box.end = box.end + Point(tolerance, tolerance);
+
+    return box;
+}
+
+bool EdgeHash::overlaps(const RectPoint &box1, const RectPoint &box2)
+{
+    return ((box1.start.x <= box2.end.x) && (box1.end.x >= box2.start.x) &&
+            (box1.start.y <= box2.end.y) && (box1.end.y >= box2.start.y));
+}
+
+QVector<int> EdgeHash::candidates(const Point &start, const Point &end) const
+{
+    return candidates(RectPoint(Point(qMin(start.x, end.x), qMin(start.y, end.y)),
+                                Point(qMax(start.x, end.x), qMax(start.y, end.y))));
+}
+
+QVector<int> EdgeHash::candidates(const RectPoint &box) const
+{
+    QVector<int> indices;
+
+    if (m_boxes.isEmpty() || !overlaps(box, m_bound))
+        return indices;
+
+    for (int i = cellX(box.start.x); i <= cellX(box.end.x); i++)
+        for (int j = cellY(box.start.y); j <= cellY(box.end.y); j++)
+            foreach (int index, m_cells.at(i * m_sizeY + j))
+                if (overlaps(box, m_boxes.at(index)))
+                    indices.append(index);
+
+    // edge can be stored in more cells
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    return indices;
+}
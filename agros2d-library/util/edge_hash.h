@@ -0,0 +1,61 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#ifndef EDGEHASH_H
+#define EDGEHASH_H
+
+#include "util.h"
+#include "util/point.h"
+
+// uniform grid over bounding boxes of edges (lines and arcs)
+// segment queries return only edges with bounding box overlapping the bounding box of the segment,
+// exact test is left to intersection()
+class EdgeHash
+{
+public:
+    EdgeHash(const QList<RectPoint> &boxes);
+
+    // bounding box of the line (angle == 0) or arc
+    static RectPoint edgeBoundingBox(const Point &start, const Point &end, const Point &center, double radius, double angle);
+
+    // sorted indices of the candidate edges
+    QVector<int> candidates(const Point &start, const Point &end) const;
+    QVector<int> candidates(const RectPoint &box) const;
+
+    inline const RectPoint &box(int index) const { return m_boxes.at(index); }
+
+private:
+    QList<RectPoint> m_boxes;
+
+    RectPoint m_bound;
+    int m_sizeX;
+    int m_sizeY;
+    double m_cellX;
+    double m_cellY;
+
+    QVector<QVector<int> > m_cells;
+
+    inline int cellX(double x) const { return qBound(0, (int) floor((x - m_bound.start.x) / m_cellX), m_sizeX - 1); }
+    inline int cellY(double y) const { return qBound(0, (int) floor((y - m_bound.start.y) / m_cellY), m_sizeY - 1); }
+
+    static bool overlaps(const RectPoint &box1, const RectPoint &box2);
+};
+
+#endif // EDGEHASH_H
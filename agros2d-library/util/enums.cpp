@@ -35,6 +35,7 @@ static QMap<AdaptivityType, QString> adaptivityTypeList;
 static QMap<AdaptivityStoppingCriterionType, QString> adaptivityStoppingCriterionTypeList;
 static QMap<Hermes::Hermes2D::NormType, QString> adaptivityNormTypeList;
 static QMap<TimeStepMethod, QString> timeStepMethodList;
+static QMap<TimeErrorEstimate, QString> timeErrorEstimateList;
 static QMap<SolutionMode, QString> solutionTypeList;
 static QMap<AnalysisType, QString> analysisTypeList;
 static QMap<CouplingType, QString> couplingTypeList;
@@ -99,6 +100,10 @@ QStringList timeStepMethodStringKeys() { return timeStepMethodList.values(); }
 QString timeStepMethodToStringKey(TimeStepMethod timeStepMethod) { return timeStepMethodList[timeStepMethod]; }
 TimeStepMethod timeStepMethodFromStringKey(const QString &timeStepMethod) { return timeStepMethodList.key(timeStepMethod); }
 
+QStringList timeErrorEstimateStringKeys() { return timeErrorEstimateList.values(); }
+QString timeErrorEstimateToStringKey(TimeErrorEstimate timeErrorEstimate) { return timeErrorEstimateList[timeErrorEstimate]; }
+TimeErrorEstimate timeErrorEstimateFromStringKey(const QString &timeErrorEstimate) { return timeErrorEstimateList.key(timeErrorEstimate); }
+
 QStringList solutionTypeStringKeys() { return solutionTypeList.values(); }
 QString solutionTypeToStringKey(SolutionMode solutionType) { return solutionTypeList[solutionType]; }
 SolutionMode solutionTypeFromStringKey(const QString &solutionType) { return solutionTypeList.key(solutionType); }
@@ -211,6 +216,9 @@ void initLists()
     //    timeStepMethodList.insert(TimeStepMethod_FixedBDF2B, "fixed_bdf2b");
     //    timeStepMethodList.insert(TimeStepMethod_FixedCombine, "fixed_combine");
 
+    timeErrorEstimateList.insert(TimeErrorEstimate_Embedded, "embedded");
+    timeErrorEstimateList.insert(TimeErrorEstimate_DoubleSolve, "double_solve");
+
     // PHYSICFIELDVARIABLECOMP
     physicFieldVariableCompList.insert(PhysicFieldVariableComp_Scalar, "scalar");
     physicFieldVariableCompList.insert(PhysicFieldVariableComp_Magnitude, "magnitude");
@@ -510,6 +518,20 @@ QString timeStepMethodString(TimeStepMethod timeStepMethod)
     }
 }
 
+QString timeErrorEstimateString(TimeErrorEstimate timeErrorEstimate)
+{
+    switch (timeErrorEstimate)
+    {
+    case TimeErrorEstimate_Embedded:
+        return QObject::tr("Embedded (predictor)");
+    case TimeErrorEstimate_DoubleSolve:
+        return QObject::tr("Lower order solution");
+    default:
+        std::cerr << "Time error estimate '" + QString::number(timeErrorEstimate).toStdString() + "' is not implemented. timeErrorEstimateString(TimeErrorEstimate timeErrorEstimate)" << endl;
+        throw;
+    }
+}
+
 QString weakFormString(WeakFormKind weakForm)
 {
     switch (weakForm)
@@ -66,6 +66,13 @@ enum TimeStepMethod
     TimeStepMethod_BDFNumSteps = 2
 };
 
+enum TimeErrorEstimate
+{
+    TimeErrorEstimate_Undefined = -1,
+    TimeErrorEstimate_Embedded = 0,
+    TimeErrorEstimate_DoubleSolve = 1
+};
+
 enum LinearityType
 {
     LinearityType_Undefined = -1,
@@ -215,6 +222,16 @@ enum SceneViewPost3DMode
     SceneViewPost3DMode_Model = 2
 };
 
+// views processed by PostHermes
+enum PostViewMode
+{
+    PostViewMode_All = -1,
+    PostViewMode_None = 0,
+    PostViewMode_Mesh = 1,
+    PostViewMode_Post2D = 2,
+    PostViewMode_Post3D = 3
+};
+
 enum SceneTransformMode
 {
     SceneTransformMode_Translate = 0,
@@ -329,6 +346,12 @@ AGROS_LIBRARY_API QStringList timeStepMethodStringKeys();
 AGROS_LIBRARY_API QString timeStepMethodToStringKey(TimeStepMethod timeStepMethod);
 AGROS_LIBRARY_API TimeStepMethod timeStepMethodFromStringKey(const QString &timeStepMethod);
 
+// time error estimate
+AGROS_LIBRARY_API QString timeErrorEstimateString(TimeErrorEstimate timeErrorEstimate);
+AGROS_LIBRARY_API QStringList timeErrorEstimateStringKeys();
+AGROS_LIBRARY_API QString timeErrorEstimateToStringKey(TimeErrorEstimate timeErrorEstimate);
+AGROS_LIBRARY_API TimeErrorEstimate timeErrorEstimateFromStringKey(const QString &timeErrorEstimate);
+
 // solution mode
 AGROS_LIBRARY_API QString solutionTypeString(SolutionMode solutionMode);
 AGROS_LIBRARY_API QStringList solutionTypeStringKeys();
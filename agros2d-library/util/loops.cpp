@@ -28,6 +28,7 @@
 
 #include "pythonlab/pythonengine_agros.h"
 #include "util/global.h"
+#include "util/edge_hash.h"
 #include "poly2tri.h"
 
 #include "scene.h"
@@ -43,94 +44,85 @@ LoopsInfo::LoopsNodeEdgeData::LoopsNodeEdgeData() : node(LOOPS_NON_EXISTING)
 
 // **************************************************************************************
 
-bool LoopsInfo::LoopsNode::hasUnvisited()
+double LoopsInfo::edgeAngle(SceneNode *node, SceneEdge *edge)
 {
-    foreach(LoopsNodeEdgeData ned, data)
-        if(!ned.visited)
-            return true;
+    double angle = atan2(edge->nodeEnd()->point().y - edge->nodeStart()->point().y,
+                         edge->nodeEnd()->point().x - edge->nodeStart()->point().x);
+    if (angle < 0)
+        angle += 2 * M_PI;
 
-    return false;
+    // edge going from the end node
+    if (node != edge->nodeStart())
+    {
+        angle += M_PI;
+        if (angle >= 2 * M_PI)
+            angle -= 2 * M_PI;
+    }
+
+    return angle;
 }
 
-LoopsInfo::LoopsNodeEdgeData LoopsInfo::LoopsNode::startLoop()
+void LoopsInfo::insertAdjacentEdge(SceneNode *node, SceneEdge *edge)
 {
-    for (int i = 0; i < data.size(); i++){
-        LoopsNodeEdgeData ned = data.at(i);
-        if(!ned.visited){
-            data[i].visited = true;
-            //cout << "start loop " << i << endl;
-            return ned;
-        }
-    }
+    QList<LoopsAdjacentEdge> &data = m_adjacency[node];
+
+    double angle = edgeAngle(node, edge);
 
-    assert(0);
+    int index = 0;
+    for (int i = 0; i < data.size(); i++)
+        if (angle < data[i].angle)
+            index = i + 1;
+    data.insert(index, LoopsAdjacentEdge(edge, angle));
 }
 
-LoopsInfo::LoopsNodeEdgeData LoopsInfo::LoopsNode::continueLoop(int previousNode)
+void LoopsInfo::removeAdjacentEdge(SceneNode *node, SceneEdge *edge)
 {
-    LoopsNodeEdgeData previousNED;
-    int index;
-    for (int i = 0; i < data.size(); i++){
-        LoopsNodeEdgeData ned = data.at(i);
-        if(ned.node == previousNode){
-            previousNED = ned;
-            index = i;
+    QHash<SceneNode *, QList<LoopsAdjacentEdge> >::iterator it = m_adjacency.find(node);
+    if (it == m_adjacency.end())
+        return;
+
+    for (int i = 0; i < it.value().size(); i++)
+    {
+        if (it.value()[i].edge == edge)
+        {
+            it.value().removeAt(i);
             break;
         }
     }
 
-    assert(previousNED.node != LOOPS_NON_EXISTING);
-
-    int nextIdx = (index + 1) % data.size();
-    //cout << "continue loop " << previousNode << ", " << data[nextIdx].node << endl;
-    // assert(!data.at(nextIdx).visited);
-    if (data.at(nextIdx).visited)
-        throw AgrosGeometryException(QObject::tr("Node %1 already visited.").arg(nextIdx));
-    data[nextIdx].visited = true;
-    return data[nextIdx];
+    if (it.value().isEmpty())
+        m_adjacency.erase(it);
 }
 
-void LoopsInfo::LoopsNode::insertEdge(int endNode, int edgeIdx, bool reverse, double angle)
+void LoopsInfo::insertEdge(SceneEdge *edge)
 {
-    int index = 0;
-
-    for (int i = 0; i < data.size(); i++)
-        if(angle < data[i].angle)
-            index = i+1;
-    data.insert(index, LoopsNodeEdgeData(endNode, edgeIdx, reverse, angle));
+    insertAdjacentEdge(edge->nodeStart(), edge);
+    if (edge->nodeEnd() != edge->nodeStart())
+        insertAdjacentEdge(edge->nodeEnd(), edge);
 }
 
-// ***********************************************************************
-
-LoopsInfo::LoopsGraph::LoopsGraph(int numNodes)
+void LoopsInfo::removeEdge(SceneEdge *edge, SceneNode *nodeStart, SceneNode *nodeEnd)
 {
-    for (int i = 0; i < numNodes; i++)
-        data.push_back(LoopsNode());
+    removeAdjacentEdge(nodeStart, edge);
+    if (nodeEnd != nodeStart)
+        removeAdjacentEdge(nodeEnd, edge);
 }
 
-void LoopsInfo::LoopsGraph::addEdge(int startNode, int endNode, int edgeIdx, double angle)
+void LoopsInfo::updateNode(SceneNode *node)
 {
-    double angle2 = angle + M_PI;
-    if(angle2 >= 2 * M_PI)
-        angle2 -= 2 * M_PI;
-
-    data[startNode].insertEdge(endNode, edgeIdx, false, angle);
-    data[endNode].insertEdge(startNode, edgeIdx, true, angle2);
-}
+    if (!m_adjacency.contains(node))
+        return;
 
-void LoopsInfo::LoopsGraph::print()
-{
-    /*
-    for (int i = 0; i < data.size(); i++)
+    // edges of the node and their positions at the opposite nodes are ordered again
+    QList<LoopsAdjacentEdge> data = m_adjacency.take(node);
+    foreach (LoopsAdjacentEdge adjacent, data)
     {
-        cout << "node " << i << "\n";
-        foreach(LoopsNodeEdgeData ned, data[i].data)
-        {
-            cout << "     node " << ned.node << ", edge " << (ned.reverse ? "-" : "") << ned.edge << ", angle " << ned.angle << ", visited " << ned.visited << "\n";
-        }
+        SceneNode *opposite = (adjacent.edge->nodeStart() == node) ? adjacent.edge->nodeEnd() : adjacent.edge->nodeStart();
+
+        removeAdjacentEdge(opposite, adjacent.edge);
+        insertAdjacentEdge(opposite, adjacent.edge);
+        insertAdjacentEdge(node, adjacent.edge);
     }
-    cout << "\n";
-    */
 }
 
 bool LoopsInfo::isInsideSeg(double angleSegStart, double angleSegEnd, double angle)
@@ -284,7 +276,7 @@ LoopsInfo::Intersection LoopsInfo::intersects(Point point, double tangent, Scene
 // *********************************************************************************************
 
 LoopsInfo::LoopsInfo(Scene *scene)
-    : QObject(), m_scene(scene)
+    : QObject(), m_scene(scene), m_isProcessed(false)
 {
     connect(m_scene, SIGNAL(invalidated()), this, SLOT(processPolygonTriangles()));
     connect(m_scene, SIGNAL(cleared()), this, SLOT(processPolygonTriangles()));
@@ -504,50 +496,129 @@ void LoopsInfo::addEdgePoints(QList<Point> *polyline, const SceneEdge &edge, boo
     polyline->append(localPolyline);
 }
 
-void LoopsInfo::processLoops()
+QVector<double> LoopsInfo::processedGeometry() const
 {
-    // find loops
-    LoopsGraph graph(m_scene->nodes->length());
-    for (int i = 0; i < m_scene->edges->length(); i++)
-    {
-        SceneNode* startNode = m_scene->edges->at(i)->nodeStart();
-        SceneNode* endNode = m_scene->edges->at(i)->nodeEnd();
-        int startNodeIdx = m_scene->nodes->items().indexOf(startNode);
-        int endNodeIdx = m_scene->nodes->items().indexOf(endNode);
+    // node indices and coordinates of edges, coordinates of labels
+    QHash<SceneNode *, int> nodeIndices;
+    nodeIndices.reserve(m_scene->nodes->length());
+    for (int i = 0; i < m_scene->nodes->length(); i++)
+        nodeIndices.insert(m_scene->nodes->at(i), i);
+
+    QVector<double> geometry;
+    geometry.reserve(5 * m_scene->nodes->length() + 7 * m_scene->edges->length() + 2 * m_scene->labels->length());
+
+    foreach (SceneNode *node, m_scene->nodes->items())
+        geometry << node->point().x << node->point().y;
 
-        double angle = atan2(endNode->point().y - startNode->point().y,
-                             endNode->point().x - startNode->point().x);
-        if (angle < 0)
-            angle += 2 * M_PI;
+    foreach (SceneEdge *edge, m_scene->edges->items())
+        geometry << nodeIndices.value(edge->nodeStart(), -1) << nodeIndices.value(edge->nodeEnd(), -1) << edge->angle();
 
-        graph.addEdge(startNodeIdx, endNodeIdx, i, angle);
+    foreach (SceneLabel *label, m_scene->labels->items())
+        geometry << label->point().x << label->point().y;
+
+    return geometry;
+}
+
+QByteArray LoopsInfo::loopGeometry(const QList<LoopsNodeEdgeData> &loop) const
+{
+    // edges of the loop sorted by their coordinates, direction of traversal is kept in the reverse flag
+    QList<QByteArray> edges;
+    foreach (LoopsNodeEdgeData ned, loop)
+    {
+        SceneEdge *edge = m_scene->edges->at(ned.edge);
+
+        double data[6] = { edge->nodeStart()->point().x, edge->nodeStart()->point().y,
+                           edge->nodeEnd()->point().x, edge->nodeEnd()->point().y,
+                           edge->angle(), ned.reverse ? 1.0 : 0.0 };
+        edges.append(QByteArray((const char *) data, sizeof(data)));
     }
+    qSort(edges);
+
+    QByteArray geometry;
+    geometry.reserve(edges.size() * 6 * sizeof(double));
+    foreach (QByteArray edge, edges)
+        geometry.append(edge);
 
-    graph.print();
+    return geometry;
+}
 
+bool LoopsInfo::isGeometryProcessed(const QVector<double> &geometry) const
+{
+    return m_isProcessed
+            && (m_processedNodes == m_scene->nodes->items())
+            && (m_processedEdges == m_scene->edges->items())
+            && (m_processedLabels == m_scene->labels->items())
+            && (m_processedGeometry == geometry);
+}
+
+void LoopsInfo::processLoops()
+{
+    // loops of unchanged geometry are still valid
+    QVector<double> geometry = processedGeometry();
+    if (isGeometryProcessed(geometry))
+        return;
+
+    m_isProcessed = false;
+
+    // node indices
+    QHash<SceneNode *, int> nodeIndices;
+    nodeIndices.reserve(m_scene->nodes->length());
+    for (int i = 0; i < m_scene->nodes->length(); i++)
+        nodeIndices.insert(m_scene->nodes->at(i), i);
+
+    // edge indices
+    QHash<SceneEdge *, int> edgeIndices;
+    edgeIndices.reserve(m_scene->edges->length());
+    for (int i = 0; i < m_scene->edges->length(); i++)
+        edgeIndices.insert(m_scene->edges->at(i), i);
+
+    // find loops (edges leaving a node are already ordered by angle)
+    QSet<QPair<SceneNode *, SceneEdge *> > visited;
     m_loops.clear();
-    for (int i = 0; i < graph.data.size(); i++)
+    for (int i = 0; i < m_scene->nodes->length(); i++)
     {
+        SceneNode *node = m_scene->nodes->at(i);
         //cout << "** starting with node " << i << endl;
-        LoopsNode& node = graph.data[i];
-        int previousNodeIdx, currentNodeIdx;
-        while (node.hasUnvisited())
+        foreach (LoopsAdjacentEdge start, m_adjacency.value(node))
         {
-            graph.print();
+            if (visited.contains(qMakePair(node, start.edge)))
+                continue;
+            visited.insert(qMakePair(node, start.edge));
 
             QList<LoopsNodeEdgeData> loop;
-            LoopsNodeEdgeData ned = node.startLoop();
-            previousNodeIdx = i;
-            loop.push_back(ned);
+            SceneNode *currentNode = node;
+            SceneEdge *currentEdge = start.edge;
             do
             {
-                currentNodeIdx = ned.node;
-                LoopsNode& actualNode = graph.data[currentNodeIdx];
-                //cout << "call continue loop with node " << currentNodeIdx << "and previous node " << previousNodeIdx << endl;
-                ned = actualNode.continueLoop(previousNodeIdx);
-                previousNodeIdx = currentNodeIdx;
-                loop.push_back(ned);
-            } while (ned.node != i);
+                bool reverse = (currentEdge->nodeStart() != currentNode);
+                SceneNode *nextNode = reverse ? currentEdge->nodeStart() : currentEdge->nodeEnd();
+                loop.push_back(LoopsNodeEdgeData(nodeIndices.value(nextNode, -1), edgeIndices.value(currentEdge, -1),
+                                                 reverse, edgeAngle(currentNode, currentEdge)));
+
+                if (nextNode == node)
+                    break;
+
+                // continue with the next edge after the one we came from
+                const QList<LoopsAdjacentEdge> data = m_adjacency.value(nextNode);
+                int index = 0;
+                for (int j = 0; j < data.size(); j++)
+                {
+                    if (data[j].edge == currentEdge)
+                    {
+                        index = j;
+                        break;
+                    }
+                }
+
+                int nextIdx = (index + 1) % data.size();
+                //cout << "continue loop " << nodeIndices.value(currentNode) << ", " << nodeIndices.value(nextNode) << endl;
+                if (visited.contains(qMakePair(nextNode, data[nextIdx].edge)))
+                    throw AgrosGeometryException(QObject::tr("Node %1 already visited.").arg(nextIdx));
+                visited.insert(qMakePair(nextNode, data[nextIdx].edge));
+
+                currentNode = nextNode;
+                currentEdge = data[nextIdx].edge;
+            } while (true);
 
             if (areEdgeDuplicities(loop))
                 throw AgrosGeometryException(QObject::tr("Two loops connected by one edge."));
@@ -564,18 +635,63 @@ void LoopsInfo::processLoops()
 
     QMap<QPair<SceneLabel*, int>, int> windingNumbers;
 
+    // labels outside of the bounding box of a loop are not inside the loop (winding number and parity are zero)
+    QList<RectPoint> labelBoxes;
+    foreach (SceneLabel *label, m_scene->labels->items())
+        labelBoxes.append(RectPoint(label->point(), label->point()));
+    EdgeHash labelHash(labelBoxes);
+
+    QVector<RectPoint> edgeBoxes(m_scene->edges->length());
+    for (int i = 0; i < m_scene->edges->length(); i++)
+    {
+        SceneEdge *edge = m_scene->edges->at(i);
+        edgeBoxes[i] = EdgeHash::edgeBoundingBox(edge->nodeStart()->point(), edge->nodeEnd()->point(),
+                                                 edge->center(), edge->radius(), edge->angle());
+    }
+
+    // tests of loops and labels kept from the previous geometry
+    QHash<QByteArray, QPair<int, int> > labelLoopTests;
+
     // find what labels are inside what loops
     for (int loopIdx = 0; loopIdx < m_loops.size(); loopIdx++)
     {
+        QByteArray loopKey = loopGeometry(m_loops[loopIdx]);
+
+        RectPoint loopBox = edgeBoxes[m_loops[loopIdx].first().edge];
+        foreach (LoopsNodeEdgeData ned, m_loops[loopIdx])
+        {
+            const RectPoint &box = edgeBoxes[ned.edge];
+            loopBox.start.x = qMin(loopBox.start.x, box.start.x);
+            loopBox.start.y = qMin(loopBox.start.y, box.start.y);
+            loopBox.end.x = qMax(loopBox.end.x, box.end.x);
+            loopBox.end.y = qMax(loopBox.end.y, box.end.y);
+        }
+
         labelsInsideLoop.push_back(QList<SceneLabel*>());
-        for (int labelIdx = 0; labelIdx < m_scene->labels->count(); labelIdx++)
+        foreach (int labelIdx, labelHash.candidates(loopBox))
         {
             SceneLabel* label = m_scene->labels->at(labelIdx);
-            int wn = windingNumber(label->point(), m_loops[loopIdx]);
+
+            double labelPoint[2] = { label->point().x, label->point().y };
+            QByteArray testKey = loopKey + QByteArray((const char *) labelPoint, sizeof(labelPoint));
+
+            QPair<int, int> test;
+            if (m_labelLoopTests.contains(testKey))
+            {
+                test = m_labelLoopTests.value(testKey);
+            }
+            else
+            {
+                test.first = windingNumber(label->point(), m_loops[loopIdx]);
+                test.second = intersectionsParity(label->point(), m_loops[loopIdx]);
+            }
+            labelLoopTests.insert(testKey, test);
+
+            int wn = test.first;
             //cout << "winding number " << wn << endl;
             assert(wn < 2);
             windingNumbers[QPair<SceneLabel*, int>(label, loopIdx)] = wn;
-            int ip = intersectionsParity(label->point(), m_loops[loopIdx]);
+            int ip = test.second;
             // assert(abs(wn) == ip);
             if(ip == 1){
                 labelsInsideLoop[loopIdx].push_back(label);
@@ -694,6 +810,14 @@ void LoopsInfo::processLoops()
         else
             throw AgrosGeometryException(tr("There is multiple labels in the domain"));
     }
+
+    m_labelLoopTests = labelLoopTests;
+
+    m_processedNodes = m_scene->nodes->items();
+    m_processedEdges = m_scene->edges->items();
+    m_processedLabels = m_scene->labels->items();
+    m_processedGeometry = geometry;
+    m_isProcessed = true;
 }
 
 QList<LoopsInfo::Triangle> LoopsInfo::triangulateLabel(const QList<Point> &polyline, const QList<QList<Point> > &holes)
@@ -807,11 +931,32 @@ void LoopsInfo::processPolygonTriangles()
                     holes.append(hole);
                 }
 
-                QList<Triangle> triangles = triangulateLabel(polyline, holes);
-                m_polygonTriangles.insert(label, triangles);
+                // triangulate only changed polygons
+                QHash<SceneLabel *, LabelTriangulation>::iterator it = m_labelTriangulations.find(label);
+                if (it == m_labelTriangulations.end() || it.value().polyline != polyline || it.value().holes != holes)
+                {
+                    LabelTriangulation triangulation;
+                    triangulation.polyline = polyline;
+                    triangulation.holes = holes;
+                    triangulation.triangles = triangulateLabel(polyline, holes);
+
+                    it = m_labelTriangulations.insert(label, triangulation);
+                }
+
+                m_polygonTriangles.insert(label, it.value().triangles);
             }
         }
 
+        // remove triangulations of deleted labels
+        QHash<SceneLabel *, LabelTriangulation>::iterator it = m_labelTriangulations.begin();
+        while (it != m_labelTriangulations.end())
+        {
+            if (m_polygonTriangles.contains(it.key()))
+                ++it;
+            else
+                it = m_labelTriangulations.erase(it);
+        }
+
         // clear polylines
         foreach (QList<Point> polyline, polylines)
             polyline.clear();
@@ -833,4 +978,13 @@ void LoopsInfo::clear()
     m_outsideLoops.clear();
 
     m_polygonTriangles.clear();
+
+    m_processedNodes.clear();
+    m_processedEdges.clear();
+    m_processedLabels.clear();
+    m_processedGeometry.clear();
+    m_isProcessed = false;
+
+    m_labelTriangulations.clear();
+    m_labelLoopTests.clear();
 }
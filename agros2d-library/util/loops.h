@@ -21,6 +21,7 @@
 #define UTIL_LOOPS_H
 
 class Scene;
+class SceneNode;
 class SceneLabel;
 class SceneEdge;
 
@@ -54,26 +55,6 @@ public:
         bool visited;
     };
 
-    struct LoopsNode
-    {
-        void insertEdge(int endNode, int edgeIdx, bool reverse,  double angle);
-        bool hasUnvisited();
-        LoopsNodeEdgeData startLoop();
-        LoopsNodeEdgeData continueLoop(int previousNode);
-        void setVisited(int index) {data[index].visited = true;}
-
-        QList<LoopsNodeEdgeData> data;
-    };
-
-    struct LoopsGraph
-    {
-        LoopsGraph(int numNodes);
-        void addEdge(int startNode, int endNode, int edgeIdx, double angle);
-        void print();
-
-        QList<LoopsNode> data;
-    };
-
     struct Triangle
     {
         Triangle(const Point &a, const Point &b, const Point &c) : a(a), b(b), c(c)
@@ -92,6 +73,13 @@ public:
 
     inline bool isProcessPolygonError() { return m_isProcessPolygonError; }
 
+    // planar graph, kept up to date by the scene containers (edges are removed from the nodes they were inserted with)
+    void insertEdge(SceneEdge *edge);
+    void removeEdge(SceneEdge *edge, SceneNode *nodeStart, SceneNode *nodeEnd);
+    void clearEdges() { m_adjacency.clear(); }
+    // node has been moved (angles of connected edges changed)
+    void updateNode(SceneNode *node);
+
 public slots:
     void processLoops();
     void processPolygonTriangles();
@@ -109,6 +97,46 @@ private:
 
     QMap<SceneLabel*, QList<Triangle> > m_polygonTriangles;
 
+    // edge leaving the node
+    struct LoopsAdjacentEdge
+    {
+        LoopsAdjacentEdge(SceneEdge *edge, double angle) : edge(edge), angle(angle) {}
+
+        SceneEdge *edge;
+        double angle; // to order edges going from node (anti)clockwise
+    };
+
+    // edges of nodes ordered by angle (nodes and edges are identified by their pointers, indices change with every edit)
+    QHash<SceneNode *, QList<LoopsAdjacentEdge> > m_adjacency;
+
+    static double edgeAngle(SceneNode *node, SceneEdge *edge);
+    void insertAdjacentEdge(SceneNode *node, SceneEdge *edge);
+    void removeAdjacentEdge(SceneNode *node, SceneEdge *edge);
+
+    // geometry of the last successfully processed loops (loops are not searched again if unchanged)
+    QList<SceneNode *> m_processedNodes;
+    QList<SceneEdge *> m_processedEdges;
+    QList<SceneLabel *> m_processedLabels;
+    QVector<double> m_processedGeometry;
+    bool m_isProcessed;
+
+    // triangulation of labels (label is triangulated again only if its polylines changed)
+    struct LabelTriangulation
+    {
+        QList<Point> polyline;
+        QList<QList<Point> > holes;
+        QList<Triangle> triangles;
+    };
+    QHash<SceneLabel *, LabelTriangulation> m_labelTriangulations;
+
+    // winding number and intersection parity of label points in loops, keyed by the geometry of the oriented loop
+    // and the label point (only loops touched by an edit and moved labels are tested again)
+    QHash<QByteArray, QPair<int, int> > m_labelLoopTests;
+
+    QVector<double> processedGeometry() const;
+    QByteArray loopGeometry(const QList<LoopsNodeEdgeData> &loop) const;
+    bool isGeometryProcessed(const QVector<double> &geometry) const;
+
     Intersection intersects(Point point, double tangent, SceneEdge* edge);
     Intersection intersects(Point point, double tangent, SceneEdge* edge, Point& intersection);
     int intersectionsParity(Point point, QList<LoopsNodeEdgeData> loop);
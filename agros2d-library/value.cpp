@@ -24,16 +24,19 @@
 #include "pythonlab/pythonengine_agros.h"
 #include "hermes2d/problem_config.h"
 #include "parser/lex.h"
+#include "parser/expression.h"
+
+#include <limits>
 
 Value::Value(double value)
-    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable())
+    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_coordinateType(CoordinateType_Undefined), m_time(0.0), m_point(Point()), m_table(DataTable())
 {
     m_text = QString::number(value);
     m_number = value;
 }
 
 Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant)
-    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable())
+    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_coordinateType(CoordinateType_Undefined), m_time(0.0), m_point(Point()), m_table(DataTable())
 {
     assert(x.size() == y.size());
 
@@ -46,13 +49,13 @@ Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTab
 }
 
 Value::Value(const QString &value)
-    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable())
+    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_coordinateType(CoordinateType_Undefined), m_time(0.0), m_point(Point()), m_table(DataTable())
 {
     parseFromString(value.isEmpty() ? "0" : value);
 }
 
 Value::Value(const QString &value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant)
-    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable())
+    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_coordinateType(CoordinateType_Undefined), m_time(0.0), m_point(Point()), m_table(DataTable())
 {
     assert(x.size() == y.size());
 
@@ -64,7 +67,7 @@ Value::Value(const QString &value, std::vector<double> x, std::vector<double> y,
 }
 
 Value::Value(const QString &value, const DataTable &table)
-    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(table)
+    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_coordinateType(CoordinateType_Undefined), m_time(0.0), m_point(Point()), m_table(table)
 {
     parseFromString(value.isEmpty() ? "0" : value);
 }
@@ -155,6 +158,54 @@ double Value::numberAtTimeAndPoint(double time, const Point &point, bool evaluat
     return number();
 }
 
+void Value::numbersAtTimeAndPoints(int n, const double *times, const double *x, const double *y, double *values)
+{
+    if (n <= 0)
+        return;
+
+    if (m_isTimeDependent || m_isCoordinateDependent)
+    {
+        // coordinate type has been changed
+        if (m_coordinateType != Agros2D::problem()->config()->coordinateType())
+            compile();
+
+        if (m_expression)
+        {
+            // times and values may be the same array
+            QVarLengthArray<double, 64> compiledValues(n);
+            m_expression->evaluate(n, x, y, times, compiledValues.data());
+
+            bool isFinite = true;
+            for (int i = 0; i < n; i++)
+            {
+                if (!qIsFinite(compiledValues[i]))
+                {
+                    isFinite = false;
+                    break;
+                }
+            }
+
+            if (isFinite)
+            {
+                for (int i = 0; i < n; i++)
+                    values[i] = (fabs(compiledValues[i]) < EPS_ZERO) ? 0.0 : compiledValues[i];
+                return;
+            }
+        }
+
+        // Python expression (errors, e.g. math domain error, are reported by Python)
+        for (int i = 0; i < n; i++)
+            values[i] = evaluateAtTimeAndPoint(times[i], Point(x[i], y[i])) ? m_number : std::numeric_limits<double>::quiet_NaN();
+    }
+    else
+    {
+        // constant
+        double value = m_isEvaluated ? m_number : std::numeric_limits<double>::quiet_NaN();
+        for (int i = 0; i < n; i++)
+            values[i] = value;
+    }
+}
+
 double Value::numberFromTable(double key) const
 {
     if (Agros2D::problem()->isNonlinear() && hasTable())
@@ -181,15 +232,70 @@ Hermes::Ord Value::derivativeFromTable(Hermes::Ord key) const
     return Hermes::Ord(1);
 }
 
+void Value::numbersFromTable(int n, const double *keys, double *values) const
+{
+    if (Agros2D::problem()->isNonlinear() && hasTable())
+    {
+        m_table.values(n, keys, values);
+    }
+    else
+    {
+        double value = number();
+        for (int i = 0; i < n; i++)
+            values[i] = value;
+    }
+}
+
+void Value::derivativesFromTable(int n, const double *keys, double *values) const
+{
+    if (Agros2D::problem()->isNonlinear() && hasTable())
+    {
+        m_table.derivatives(n, keys, values);
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+            values[i] = 0.0;
+    }
+}
+
 void Value::setText(const QString &str)
 {
     m_isEvaluated = false;
     m_text = str;
 
+    compile();
+    evaluate();
+}
+
+// pi and e are compiled as constants unless the user redefined them in Python
+static bool isMathConstant(const QString &name, double constant)
+{
+    bool signalBlocked = currentPythonEngineAgros()->signalsBlocked();
+    currentPythonEngineAgros()->blockSignals(true);
+
+    double value = 0.0;
+    bool successfulRun = currentPythonEngineAgros()->runExpression(name, &value);
+    if (!successfulRun)
+        currentPythonEngineAgros()->parseError();
+
+    if (!signalBlocked)
+        currentPythonEngineAgros()->blockSignals(false);
+
+    // not defined or imported from the math module
+    return !successfulRun || (value == constant);
+}
+
+void Value::compile()
+{
     m_isTimeDependent = false;
     m_isCoordinateDependent = false;
 
+    // names of coordinates depend on the coordinate type
+    m_coordinateType = Agros2D::problem()->config()->coordinateType();
+
     LexicalAnalyser lex;
+    bool isParsed = true;
 
     // ToDo: Improve
     try
@@ -199,16 +305,26 @@ void Value::setText(const QString &str)
 
     catch(ParserException e)
     {
-        // Nothing to do at this point.
+        // Nothing to do at this point (expression is evaluated by Python).
+        isParsed = false;
     }
 
+    // compiled expression
+    m_expression.clear();
+
+    QMap<QString, double> constants;
     foreach (Token token, lex.tokens())
     {
         if (token.type() == ParserTokenType_VARIABLE)
         {
+            if (token.toString() == "pi" && !constants.contains("pi") && isMathConstant("pi", M_PI))
+                constants["pi"] = M_PI;
+            if (token.toString() == "e" && !constants.contains("e") && isMathConstant("e", M_E))
+                constants["e"] = M_E;
+
             if (token.toString() == "time")
                 m_isTimeDependent = true;
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
+            if (m_coordinateType == CoordinateType_Planar)
             {
                 if (token.toString() == "x" || token.toString() == "y")
                     m_isCoordinateDependent = true;
@@ -221,7 +337,19 @@ void Value::setText(const QString &str)
         }
     }
 
-    evaluate();
+    if (isParsed && !isNumber() && !lex.tokens().isEmpty())
+    {
+        QStringList variables;
+        if (m_coordinateType == CoordinateType_Planar)
+            variables << "x" << "y";
+        else
+            variables << "r" << "z";
+        variables << "time";
+
+        QSharedPointer<CompiledExpression> expression(new CompiledExpression(lex.tokens(), variables, constants));
+        if (expression->isValid())
+            m_expression = expression;
+    }
 }
 
 QString Value::toString() const
@@ -288,6 +416,22 @@ bool Value::evaluateExpression(const QString &expression)
         return true;
     }
 
+    // coordinate type has been changed
+    if (m_coordinateType != Agros2D::problem()->config()->coordinateType())
+        compile();
+
+    // compiled expression (errors, e.g. math domain error, are reported by Python)
+    if (m_expression)
+    {
+        double value = m_expression->evaluate(m_point.x, m_point.y, m_time);
+        if (qIsFinite(value))
+        {
+            m_number = (fabs(value) < EPS_ZERO) ? 0.0 : value;
+            m_isEvaluated = true;
+            return true;
+        }
+    }
+
     bool signalBlocked = currentPythonEngineAgros()->signalsBlocked();
     currentPythonEngineAgros()->blockSignals(true);
 
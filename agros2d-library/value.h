@@ -28,6 +28,7 @@
 
 class DataTable;
 class FieldInfo;
+class CompiledExpression;
 
 class AGROS_LIBRARY_API Value
 {
@@ -51,6 +52,9 @@ public:
     double numberAtPoint(const Point &point, bool evaluate = true);
     double numberAtTime(double time, bool evaluate = true);
     double numberAtTimeAndPoint(double time, const Point &point, bool evaluate = true);
+    // batch evaluation for n points (compiled expression evaluated at once, Python point by point)
+    // value is not finite if expression cannot be evaluated (times or coordinates and values may be the same array)
+    void numbersAtTimeAndPoints(int n, const double *times, const double *x, const double *y, double *values);
 
     bool isNumber();
     inline bool isTimeDependent() const { return m_isTimeDependent; }
@@ -65,6 +69,9 @@ public:
     Hermes::Ord numberFromTable(Hermes::Ord ord) const;
     double derivativeFromTable(double key) const;
     Hermes::Ord derivativeFromTable(Hermes::Ord ord) const;
+    // batch evaluation for n keys (keys and values may be the same array)
+    void numbersFromTable(int n, const double *keys, double *values) const;
+    void derivativesFromTable(int n, const double *keys, double *values) const;
 
     bool hasTable() const;
 
@@ -88,10 +95,18 @@ private:
     Point m_point;
     bool m_isTimeDependent;
     bool m_isCoordinateDependent;
+    // coordinate type of the dependency flags and the compiled expression
+    CoordinateType m_coordinateType;
+
+    // compiled expression (NULL if Python has to be used)
+    QSharedPointer<CompiledExpression> m_expression;
 
     // table
     DataTable m_table;
 
+    // dependency on coordinates and time, compiled expression
+    void compile();
+
     // evaluate
     bool evaluate();
     bool evaluateExpression(const QString &expression);
@@ -65,6 +65,8 @@ public:
 
     // local values
     virtual LocalValue *localValue(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point) { assert(0); return NULL; }
+    virtual void localValues(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                             const QVector<Point> &points, QMap<QString, PointValueColumns> &results) { assert(0); }
     // surface integrals
     virtual IntegralValue *surfaceIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) { assert(0); return NULL; }
     // volume integrals
@@ -74,6 +76,9 @@ public:
     virtual Point3 force(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                          Hermes::Hermes2D::Element *element, SceneMaterial *material,
                          const Point3 &point, const Point3 &velocity) { assert(0); return Point3(); }
+    virtual Point3 force(FieldInfo *fieldInfo, int timeStep, MultiArray<double> &multiArray,
+                         Hermes::Hermes2D::Element *element, SceneMaterial *material,
+                         const Point3 &point, const Point3 &velocity) { assert(0); return Point3(); }
     virtual bool hasForce(FieldInfo *fieldInfo) { return false; }
 
     // localization
@@ -35,15 +35,13 @@ class {{CLASS}}ErrorCalculatorNorm_{{COORDINATE_TYPE}}_{{LINEARITY_TYPE}}_{{ANAL
 {
 public:
     {{CLASS}}ErrorCalculatorNorm_{{COORDINATE_TYPE}}_{{LINEARITY_TYPE}}_{{ANALYSIS_TYPE}}_{{ID_CALCULATOR}}<Scalar>(FieldInfo *fieldInfo, int i, int j)
-        : Hermes::Hermes2D::NormFormVol<Scalar>(i, j), m_fieldInfo(fieldInfo) {}
+        : Hermes::Hermes2D::NormFormVol<Scalar>(i, j), m_fieldInfo(fieldInfo),
+          m_materialTable(fieldInfo, QStringList(){{#VARIABLE_SOURCE}} << QLatin1String("{{VARIABLE}}"){{/VARIABLE_SOURCE}}) {}
 
     virtual Scalar value(int n, double *wt, Hermes::Hermes2D::Func<Scalar> *u, Hermes::Hermes2D::Func<Scalar> *v, Hermes::Hermes2D::Geom<double> *e) const
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
-
         {{#VARIABLE_SOURCE}}
-        Value *{{VARIABLE_SHORT}} = &material->value(QLatin1String("{{VARIABLE}}"));{{/VARIABLE_SOURCE}}
+        Value *{{VARIABLE_SHORT}} = m_materialTable.value(e->elem_marker, {{VARIABLE_INDEX}});{{/VARIABLE_SOURCE}}
 
         Scalar result = Scalar(0);
         for (int i = 0; i < n; i++)
@@ -53,6 +51,8 @@ public:
     }
 
     FieldInfo *m_fieldInfo;
+    // materials by hermes marker
+    MaterialTable m_materialTable;
 };
 
 template class {{CLASS}}ErrorCalculatorNorm_{{COORDINATE_TYPE}}_{{LINEARITY_TYPE}}_{{ANALYSIS_TYPE}}_{{ID_CALCULATOR}}<double>;
@@ -30,19 +30,110 @@
 #include "hermes2d/plugin_interface.h"
 
 
+{{#VARIABLE_SOURCE}}
+class {{CLASS}}ViewScalarFilter_{{FILTER_ID}} : public {{CLASS}}ViewScalarFilter
+{
+public:
+    {{CLASS}}ViewScalarFilter_{{FILTER_ID}}(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                       Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln,
+                                       const QString &variable,
+                                       PhysicFieldVariableComp physicFieldVariableComp)
+        : {{CLASS}}ViewScalarFilter(fieldInfo, timeStep, adaptivityStep, solutionType, sln, variable, physicFieldVariableComp)
+    {
+    }
+
+protected:
+    virtual void calculateValues(int np, double **value, double **dudx, double **dudy,
+                                 double *x, double *y, int elementMarker, double *result)
+    {
+        // set material
+        SceneMaterial *material = m_materialTable.material(elementMarker);
+
+        {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = m_materialTable.value(elementMarker, {{MATERIAL_INDEX}});
+        {{/VARIABLE_MATERIAL}}
+        {{#SPECIAL_FUNCTION_SOURCE}}
+        {{SPECIAL_EXT_FUNCTION_FULL_NAME}} {{SPECIAL_FUNCTION_NAME}}(m_fieldInfo, 0);{{/SPECIAL_FUNCTION_SOURCE}}
+
+        for (int i = 0; i < np; i++)
+            result[i] = {{EXPRESSION}};
+    }
+};
+
+{{/VARIABLE_SOURCE}}
+{{CLASS}}ViewScalarFilter *{{CLASS}}ViewScalarFilter::create(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                                   Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln,
+                                                   const QString &variable,
+                                                   PhysicFieldVariableComp physicFieldVariableComp)
+{
+    CoordinateType coordinateType = Agros2D::problem()->config()->coordinateType();
+    AnalysisType analysisType = fieldInfo->analysisType();
+    uint variableHash = qHash(variable);
+
+    {{#VARIABLE_SOURCE}}
+    if ((coordinateType == {{COORDINATE_TYPE}})
+            && (analysisType == {{ANALYSIS_TYPE}})
+            && (physicFieldVariableComp == {{PHYSICFIELDVARIABLECOMP_TYPE}})
+            && (variableHash == {{VARIABLE_HASH}}))
+        return new {{CLASS}}ViewScalarFilter_{{FILTER_ID}}(fieldInfo, timeStep, adaptivityStep, solutionType, sln, variable, physicFieldVariableComp);
+    {{/VARIABLE_SOURCE}}
+
+    return new {{CLASS}}ViewScalarFilter(fieldInfo, timeStep, adaptivityStep, solutionType, sln, variable, physicFieldVariableComp);
+}
+
 {{CLASS}}ViewScalarFilter::{{CLASS}}ViewScalarFilter(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                                            Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln,
                                            const QString &variable,
                                            PhysicFieldVariableComp physicFieldVariableComp)
     : Hermes::Hermes2D::Filter<double>(sln), m_fieldInfo(fieldInfo), m_timeStep(timeStep), m_adaptivityStep(adaptivityStep), m_solutionType(solutionType),
-      m_variable(variable), m_physicFieldVariableComp(physicFieldVariableComp)
+      m_variable(variable), m_physicFieldVariableComp(physicFieldVariableComp),
+      m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}}),
+      m_value(this->num), m_dudx(this->num), m_dudy(this->num)
+{
+}
+
+void {{CLASS}}ViewScalarFilter::calculateValues(int np, double **value, double **dudx, double **dudy,
+                                            double *x, double *y, int elementMarker, double *result)
 {
-    m_variableHash = qHash(m_variable);
+    for (int i = 0; i < np; i++)
+        result[i] = 0.0;
 }
 
 Hermes::Hermes2D::Func<double> *{{CLASS}}ViewScalarFilter::get_pt_value(double x, double y, bool use_MeshHashGrid, Hermes::Hermes2D::Element* e)
 {
-    return NULL;
+    if (!e)
+        e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(use_MeshHashGrid, this->mesh, x, y);
+    if (!e)
+        return NULL;
+
+    QVector<Hermes::Hermes2D::Func<double> *> fns(this->num);
+    for (int k = 0; k < this->num; k++)
+    {
+        fns[k] = this->sln[k]->get_pt_value(x, y, use_MeshHashGrid, e);
+        m_value[k] = fns[k]->val;
+        m_dudx[k] = fns[k]->dx;
+        m_dudy[k] = fns[k]->dy;
+    }
+
+    double value;
+    calculateValues(1, m_value.data(), m_dudx.data(), m_dudy.data(), &x, &y, e->marker, &value);
+
+    // value of the filter is returned in the function allocated by Hermes (caller releases it by free_fn())
+    Hermes::Hermes2D::Func<double> *func = fns[0];
+    for (int k = 1; k < this->num; k++)
+    {
+        fns[k]->free_fn();
+        fns[k]->free_ord();
+        delete fns[k];
+    }
+
+    // derivatives of the filter are not evaluated
+    func->val[0] = value;
+    if (func->dx)
+        func->dx[0] = std::numeric_limits<double>::quiet_NaN();
+    if (func->dy)
+        func->dy[0] = std::numeric_limits<double>::quiet_NaN();
+
+    return func;
 }
 
 void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
@@ -51,16 +142,12 @@ void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
     int np = quad->get_num_points(order, this->get_active_element()->get_mode());
     Hermes::Hermes2D::Function<double>::Node* node = this->new_node(Hermes::Hermes2D::H2D_FN_DEFAULT, np);
 
-    double **value = new double*[this->num];
-    double **dudx = new double*[this->num];
-    double **dudy = new double*[this->num];
-
     for (int k = 0; k < this->num; k++)
     {
         this->sln[k]->set_quad_order(order, Hermes::Hermes2D::H2D_FN_DEFAULT);
-        dudx[k] = this->sln[k]->get_dx_values();
-        dudy[k] = this->sln[k]->get_dy_values();
-        value[k] = this->sln[k]->get_fn_values();
+        m_dudx[k] = this->sln[k]->get_dx_values();
+        m_dudy[k] = this->sln[k]->get_dy_values();
+        m_value[k] = this->sln[k]->get_fn_values();
     }
 
     this->update_refmap();
@@ -69,29 +156,7 @@ void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
     double *y = this->refmap->get_phys_y(order);
     Hermes::Hermes2D::Element *e = this->refmap->get_active_element();
 
-    // set material
-    SceneMaterial *material = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().
-                                                             get_user_marker(e->marker).marker.c_str()))->marker(m_fieldInfo);
-
-    int elementMarker = e->marker;
-
-    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = &material->value(QLatin1String("{{MATERIAL_VARIABLE}}"));
-    {{/VARIABLE_MATERIAL}}
-    {{#SPECIAL_FUNCTION_SOURCE}}
-    {{SPECIAL_EXT_FUNCTION_FULL_NAME}} {{SPECIAL_FUNCTION_NAME}}(m_fieldInfo, 0);{{/SPECIAL_FUNCTION_SOURCE}}
-
-    {{#VARIABLE_SOURCE}}
-    if ((Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}})
-            && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
-            && (m_physicFieldVariableComp == {{PHYSICFIELDVARIABLECOMP_TYPE}})
-            && (m_variableHash == {{VARIABLE_HASH}}))
-        for (int i = 0; i < np; i++)
-            node->values[0][0][i] = {{EXPRESSION}};
-    {{/VARIABLE_SOURCE}}
-
-    delete [] value;
-    delete [] dudx;
-    delete [] dudy;
+    calculateValues(np, m_value.data(), m_dudx.data(), m_dudy.data(), x, y, e->marker, node->values[0][0]);
 
     if(this->nodes->present(order))
     {
@@ -109,8 +174,5 @@ void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
     for (int i = 0; i < this->num; i++)
         slns.push_back(this->sln[i]->clone());
 
-    {{CLASS}}ViewScalarFilter *filter = new {{CLASS}}ViewScalarFilter(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType, slns, m_variable, m_physicFieldVariableComp);
-
-    return filter;
+    return create(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType, slns, m_variable, m_physicFieldVariableComp);
 }
-
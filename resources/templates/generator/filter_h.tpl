@@ -25,33 +25,49 @@
 #include "util.h"
 #include "util/enums.h"
 #include "hermes2d/field.h"
+#include "hermes2d/plugin_interface.h"
 #include "hermes2d.h"
 
 class {{CLASS}}ViewScalarFilter : public Hermes::Hermes2D::Filter<double>
 {
 public:
-    {{CLASS}}ViewScalarFilter(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
-                     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln,
-                     const QString &variable,
-                     PhysicFieldVariableComp physicFieldVariableComp);
+    // filter specialised to the variable, analysis type, coordinate type and component
+    static {{CLASS}}ViewScalarFilter *create(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln,
+                                     const QString &variable,
+                                     PhysicFieldVariableComp physicFieldVariableComp);
 
     virtual Hermes::Hermes2D::Func<double> *get_pt_value(double x, double y, bool use_MeshHashGrid = false, Hermes::Hermes2D::Element* e = NULL);
 
     {{CLASS}}ViewScalarFilter* clone() const;
 
 protected:
+    {{CLASS}}ViewScalarFilter(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln,
+                     const QString &variable,
+                     PhysicFieldVariableComp physicFieldVariableComp);
 
     void precalculate(int order, int mask);
 
-private:
+    // values of the variable in np points of the element (zero if variable is not defined)
+    virtual void calculateValues(int np, double **value, double **dudx, double **dudy,
+                                 double *x, double *y, int elementMarker, double *result);
+
     FieldInfo *m_fieldInfo;
     int m_timeStep;
     int m_adaptivityStep;
     SolutionMode m_solutionType;
 
     QString m_variable;
-    uint m_variableHash;
     PhysicFieldVariableComp m_physicFieldVariableComp;
+
+    MaterialTable m_materialTable;
+
+private:
+    // scratch buffers (linearizer clones the filter for each thread)
+    QVector<double *> m_value;
+    QVector<double *> m_dudx;
+    QVector<double *> m_dudy;
 };
 
 #endif // {{ID}}_FILTER_H
@@ -45,18 +45,13 @@ bool hasForce{{CLASS}}(FieldInfo *fieldInfo)
 Point3 force{{CLASS}}(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                       Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity)
 {
-    int numberOfSolutions = fieldInfo->numberOfSolutions();
-
-    FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionType);
-    MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
-
-    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = &material->value(QLatin1String("{{MATERIAL_VARIABLE}}"));
-    {{/VARIABLE_MATERIAL}}
-
     Point3 res;
 
     if (Agros2D::problem()->isSolved())
     {
+        FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionType);
+        MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
+
         // update time functions
         if (fieldInfo->analysisType() == AnalysisType_Transient)
         {
@@ -64,61 +59,63 @@ Point3 force{{CLASS}}(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, So
             Module::updateTimeFunctions(timeLevels[timeStep]);
         }
 
-        // set variables
-        double x = point.x;
-        double y = point.y;
+        res = force{{CLASS}}(fieldInfo, timeStep, ma, element, material, point, velocity);
+    }
 
-        double *value = new double[numberOfSolutions];
-        double *dudx = new double[numberOfSolutions];
-        double *dudy = new double[numberOfSolutions];
+    return res;
+}
 
-        for (int k = 0; k < numberOfSolutions; k++)
-        {
-            // point values
-            // point values
-            Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(point.x, point.y, true, element);
-            if (!values)
-            {
-                throw AgrosException(QObject::tr("Point [%1, %2] does not lie in any element").arg(x).arg(y));
-
-                delete [] value;
-                delete [] dudx;
-                delete [] dudy;
-
-                return res;
-            }
-
-            double val;
-            if ((fieldInfo->analysisType() == AnalysisType_Transient) && timeStep == 0)
-                // const solution at first time step
-                val = fieldInfo->value(FieldInfo::TransientInitialCondition).toDouble();
-            else
-                val = values->val[0];
-
-            // set variables
-            value[k] = val;
-            dudx[k] = values->dx[0];
-            dudy[k] = values->dy[0];
-
-            values->free_fn();
-            values->free_ord();
-            delete values;
-        }
+Point3 force{{CLASS}}(FieldInfo *fieldInfo, int timeStep, MultiArray<double> &multiArray,
+                      Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity)
+{
+    int numberOfSolutions = fieldInfo->numberOfSolutions();
 
-        {{#VARIABLE_SOURCE}}
-        if ((fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
-         && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-        {
-            res.x = {{EXPRESSION_X}};
-            res.y = {{EXPRESSION_Y}};
-            res.z = {{EXPRESSION_Z}};
-        }
-        {{/VARIABLE_SOURCE}}
+    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = &material->value(QLatin1String("{{MATERIAL_VARIABLE}}"));
+    {{/VARIABLE_MATERIAL}}
+
+    Point3 res;
+
+    // set variables
+    double x = point.x;
+    double y = point.y;
 
-        delete [] value;
-        delete [] dudx;
-        delete [] dudy;
+    QVarLengthArray<double, 4> value(numberOfSolutions);
+    QVarLengthArray<double, 4> dudx(numberOfSolutions);
+    QVarLengthArray<double, 4> dudy(numberOfSolutions);
+
+    for (int k = 0; k < numberOfSolutions; k++)
+    {
+        // point values
+        Hermes::Hermes2D::Func<double> *values = multiArray.solutions().at(k)->get_pt_value(point.x, point.y, true, element);
+        if (!values)
+            throw AgrosException(QObject::tr("Point [%1, %2] does not lie in any element").arg(x).arg(y));
+
+        double val;
+        if ((fieldInfo->analysisType() == AnalysisType_Transient) && timeStep == 0)
+            // const solution at first time step
+            val = fieldInfo->value(FieldInfo::TransientInitialCondition).toDouble();
+        else
+            val = values->val[0];
+
+        // set variables
+        value[k] = val;
+        dudx[k] = values->dx[0];
+        dudy[k] = values->dy[0];
+
+        values->free_fn();
+        values->free_ord();
+        delete values;
+    }
+
+    {{#VARIABLE_SOURCE}}
+    if ((fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
+     && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+    {
+        res.x = {{EXPRESSION_X}};
+        res.y = {{EXPRESSION_Y}};
+        res.z = {{EXPRESSION_Z}};
     }
+    {{/VARIABLE_SOURCE}}
 
     return res;
 }
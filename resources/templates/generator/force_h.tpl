@@ -24,6 +24,7 @@
 
 #include "util.h"
 #include "hermes2d/field.h"
+#include "hermes2d/solutiontypes.h"
 #include "hermes2d.h"
 
 bool hasForce{{CLASS}}(FieldInfo *fieldInfo);
@@ -31,5 +32,9 @@ bool hasForce{{CLASS}}(FieldInfo *fieldInfo);
 Point3 force{{CLASS}}(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                       Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity = Point3());
 
+// reentrant version, solutions are prepared and time functions updated by caller
+Point3 force{{CLASS}}(FieldInfo *fieldInfo, int timeStep, MultiArray<double> &multiArray,
+                      Hermes::Hermes2D::Element *element, SceneMaterial *material, const Point3 &point, const Point3 &velocity = Point3());
+
 
 #endif // {{ID}}_FORCE_H
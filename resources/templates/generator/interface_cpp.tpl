@@ -142,7 +142,7 @@ Hermes::Hermes2D::MeshFunctionSharedPtr<double> {{CLASS}}Interface::filter(Field
                                                      const QString &variable,
                                                      PhysicFieldVariableComp physicFieldVariableComp)
 {
-    return Hermes::Hermes2D::MeshFunctionSharedPtr<double>(new {{CLASS}}ViewScalarFilter(fieldInfo, timeStep, adaptivityStep, solutionType, sln, variable, physicFieldVariableComp));
+    return Hermes::Hermes2D::MeshFunctionSharedPtr<double>({{CLASS}}ViewScalarFilter::create(fieldInfo, timeStep, adaptivityStep, solutionType, sln, variable, physicFieldVariableComp));
 }
 
 LocalValue *{{CLASS}}Interface::localValue(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point)
@@ -150,6 +150,12 @@ LocalValue *{{CLASS}}Interface::localValue(FieldInfo *fieldInfo, int timeStep, i
     return new {{CLASS}}LocalValue(fieldInfo, timeStep, adaptivityStep, solutionType, point);
 }
 
+void {{CLASS}}Interface::localValues(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                     const QVector<Point> &points, QMap<QString, PointValueColumns> &results)
+{
+    localValues{{CLASS}}(fieldInfo, timeStep, adaptivityStep, solutionType, points, results);
+}
+
 IntegralValue *{{CLASS}}Interface::surfaceIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
 {
     return new {{CLASS}}SurfaceIntegral(fieldInfo, timeStep, adaptivityStep, solutionType);
@@ -167,6 +173,13 @@ Point3 {{CLASS}}Interface::force(FieldInfo *fieldInfo, int timeStep, int adaptiv
     return force{{CLASS}}(fieldInfo, timeStep, adaptivityStep, solutionType, element, material, point, velocity);
 }
 
+Point3 {{CLASS}}Interface::force(FieldInfo *fieldInfo, int timeStep, MultiArray<double> &multiArray,
+                                 Hermes::Hermes2D::Element *element, SceneMaterial *material,
+                                 const Point3 &point, const Point3 &velocity)
+{
+    return force{{CLASS}}(fieldInfo, timeStep, multiArray, element, material, point, velocity);
+}
+
 bool {{CLASS}}Interface::hasForce(FieldInfo *fieldInfo)
 {
     return hasForce{{CLASS}}(fieldInfo);
@@ -66,6 +66,8 @@ public:
 
     // local values
     virtual LocalValue *localValue(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point);
+    virtual void localValues(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                             const QVector<Point> &points, QMap<QString, PointValueColumns> &results);
     // surface integrals
     virtual IntegralValue *surfaceIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType);
     // volume integrals
@@ -75,6 +77,9 @@ public:
     virtual Point3 force(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                          Hermes::Hermes2D::Element *element, SceneMaterial *material,
                          const Point3 &point, const Point3 &velocity);
+    virtual Point3 force(FieldInfo *fieldInfo, int timeStep, MultiArray<double> &multiArray,
+                         Hermes::Hermes2D::Element *element, SceneMaterial *material,
+                         const Point3 &point, const Point3 &velocity);
     virtual bool hasForce(FieldInfo *fieldInfo);
 
 
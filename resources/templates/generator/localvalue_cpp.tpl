@@ -22,6 +22,7 @@
 
 #include "util.h"
 #include "util/global.h"
+#include "util/conf.h"
 
 
 #include "hermes2d/problem.h"
@@ -31,6 +32,14 @@
 
 #include "hermes2d/plugin_interface.h"
 
+#include "particle/mesh_hash.h"
+
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 {{CLASS}}LocalValue::{{CLASS}}LocalValue(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
                                          const Point &point)
     : LocalValue(fieldInfo, timeStep, adaptivityStep, solutionType, point)
@@ -58,12 +67,13 @@ void {{CLASS}}LocalValue::calculate()
         double x = m_point.x;
         double y = m_point.y;
 
-        Hermes::Hermes2D::Element *e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(false, m_fieldInfo->initialMesh(),
-                                                                                                 m_point.x, m_point.y);
+        // point location on the solution mesh (consecutive points are usually in the same element)
+        QSharedPointer<MeshHash> meshHash = Agros2D::solutionStore()->meshHash(fsid);
+        Hermes::Hermes2D::Element *e = meshHash->getElementCoherent(m_point.x, m_point.y);
         if (e)
         {
             // find marker
-            SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->marker).marker.c_str()));
+            SceneLabel *label = Agros2D::scene()->labels->at(m_fieldInfo->hermesMarkerToLabel(e->marker));
             SceneMaterial *material = label->marker(m_fieldInfo);
 
             int elementMarker = e->marker;
@@ -90,7 +100,8 @@ void {{CLASS}}LocalValue::calculate()
                 else
                 {
                     // point values
-                    Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(m_point.x, m_point.y, true);
+                    Hermes::Hermes2D::Element *element = (ma.solutions().at(k)->get_mesh() == meshHash->mesh()) ? e : NULL;
+                    Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(m_point.x, m_point.y, true, element);
 
                     // set variables
                     value[k] = values->val[0];
@@ -116,3 +127,163 @@ void {{CLASS}}LocalValue::calculate()
         }
     }
 }
+
+void localValues{{CLASS}}(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                          const QVector<Point> &points, QMap<QString, PointValueColumns> &results)
+{
+    int numberOfSolutions = fieldInfo->numberOfSolutions();
+
+    results.clear();
+
+    if (!Agros2D::problem()->isSolved())
+        return;
+
+    FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionType);
+    MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
+    QSharedPointer<MeshHash> meshHash = Agros2D::solutionStore()->meshHash(fsid);
+
+    // update time functions
+    if (!Agros2D::problem()->isSolving() && fieldInfo->analysisType() == AnalysisType_Transient)
+    {
+       Module::updateTimeFunctions(Agros2D::problem()->timeStepToTotalTime(timeStep));
+    }
+
+    // points outside of the mesh have not a number values
+    double nan = std::numeric_limits<double>::quiet_NaN();
+
+    // columns are allocated once, threads write only through the raw pointers (in the order of the expressions below)
+    QVector<double *> columns;
+    {{#VARIABLE_SOURCE}}
+    if ((fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
+            && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+    {
+        PointValueColumns &variable = results[QLatin1String("{{VARIABLE}}")];
+        variable.scalar = QVector<double>(points.count(), nan);
+        columns.append(variable.scalar.data());
+        {{#VARIABLE_VECTOR}}
+        variable.vectorX = QVector<double>(points.count(), nan);
+        variable.vectorY = QVector<double>(points.count(), nan);
+        columns.append(variable.vectorX.data());
+        columns.append(variable.vectorY.data());
+        {{/VARIABLE_VECTOR}}
+    }
+    {{/VARIABLE_SOURCE}}
+    double **columnsData = columns.data();
+
+    // materials by hermes marker (values are resolved before the evaluation threads are started)
+    MaterialTable materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}});
+
+    // point location (consecutive points are usually in the same element)
+    QVector<Hermes::Hermes2D::Element *> elements(points.count(), NULL);
+    QList<QPair<int, int> > elementPoints;
+    for (int i = 0; i < points.count(); i++)
+    {
+        Hermes::Hermes2D::Element *e = meshHash->getElementCoherent(points[i].x, points[i].y);
+        if (!e)
+            continue;
+
+        elements[i] = e;
+        elementPoints.append(QPair<int, int>(e->id, i));
+    }
+
+    if (elementPoints.isEmpty())
+        return;
+
+    // points of the same element are evaluated together
+    qSort(elementPoints);
+
+    // solutions are not shared between threads
+    int numberOfThreads = qBound(1, Agros2D::configComputer()->numberOfThreads, elementPoints.count());
+    QList<MultiArray<double> > multiArrays;
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        if (numberOfThreads > 1)
+        {
+            MultiArray<double> multiArray;
+            for (int comp = 0; comp < ma.size(); comp++)
+                multiArray.append(ma.spaces().at(comp),
+                                  Hermes::Hermes2D::MeshFunctionSharedPtr<double>(ma.solutions().at(comp)->clone()));
+
+            multiArrays.append(multiArray);
+        }
+        else
+        {
+            multiArrays.append(ma);
+        }
+    }
+
+    // special functions keep their evaluation state, every thread has its own
+    {{#SPECIAL_FUNCTION_SOURCE}}
+    QList<QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> > {{SPECIAL_FUNCTION_NAME}}Threads;
+    for (int t = 0; t < numberOfThreads; t++)
+        {{SPECIAL_FUNCTION_NAME}}Threads.append(QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(fieldInfo, 0)));{{/SPECIAL_FUNCTION_SOURCE}}
+
+    // static schedule keeps points of one element in one thread
+#pragma omp parallel for num_threads(numberOfThreads) schedule(static)
+    for (int j = 0; j < elementPoints.count(); j++)
+    {
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+#else
+        int thread = 0;
+#endif
+        MultiArray<double> &multiArray = multiArrays[thread];
+        {{#SPECIAL_FUNCTION_SOURCE}}
+        {{SPECIAL_EXT_FUNCTION_FULL_NAME}} &{{SPECIAL_FUNCTION_NAME}} = *{{SPECIAL_FUNCTION_NAME}}Threads[thread];{{/SPECIAL_FUNCTION_SOURCE}}
+
+        int i = elementPoints.at(j).second;
+        Hermes::Hermes2D::Element *e = elements.at(i);
+
+        double x = points.at(i).x;
+        double y = points.at(i).y;
+
+        int elementMarker = e->marker;
+
+        {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = materialTable.value(elementMarker, {{MATERIAL_INDEX}});
+        {{/VARIABLE_MATERIAL}}
+
+        QVarLengthArray<double, 4> value(numberOfSolutions);
+        QVarLengthArray<double, 4> dudx(numberOfSolutions);
+        QVarLengthArray<double, 4> dudy(numberOfSolutions);
+
+        for (int k = 0; k < numberOfSolutions; k++)
+        {
+            if ((fieldInfo->analysisType() == AnalysisType_Transient) && timeStep == 0)
+            {
+                // set variables
+                value[k] = fieldInfo->value(FieldInfo::TransientInitialCondition).toDouble();
+                dudx[k] = 0;
+                dudy[k] = 0;
+            }
+            else
+            {
+                // point values
+                Hermes::Hermes2D::Element *element = (multiArray.solutions().at(k)->get_mesh() == meshHash->mesh()) ? e : NULL;
+                Hermes::Hermes2D::Func<double> *values = multiArray.solutions().at(k)->get_pt_value(x, y, true, element);
+
+                // set variables
+                value[k] = values->val[0];
+                dudx[k] = values->dx[0];
+                dudy[k] = values->dy[0];
+
+                values->free_fn();
+                values->free_ord();
+                delete values;
+            }
+        }
+
+        // expressions (every point is written by exactly one thread)
+        int column = 0;
+        {{#VARIABLE_SOURCE}}
+        if ((fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
+                && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+        {
+            columnsData[column++][i] = {{EXPRESSION_SCALAR}};
+            {{#VARIABLE_VECTOR}}
+            columnsData[column++][i] = {{EXPRESSION_VECTORX}};
+            columnsData[column++][i] = {{EXPRESSION_VECTORY}};
+            {{/VARIABLE_VECTOR}}
+        }
+        {{/VARIABLE_SOURCE}}
+    }
+}
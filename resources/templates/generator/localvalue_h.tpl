@@ -38,4 +38,9 @@ public:
     void calculate();
 };
 
+// local values in many points, points are sorted by element and evaluated in parallel
+// (each variable has one value for every point, points outside of the mesh have no material)
+void localValues{{CLASS}}(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                          const QVector<Point> &points, QMap<QString, PointValueColumns> &results);
+
 #endif // {{ID}}_LOCALVALUE_H
@@ -34,25 +34,26 @@
 class {{CLASS}}SurfaceIntegralCalculator : public Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>
 {
 public:
-    {{CLASS}}SurfaceIntegralCalculator(FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals)
-        : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo)
+    {{CLASS}}SurfaceIntegralCalculator(FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals, const QVector<bool> &selected)
+        : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo), m_selected(selected),
+          m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}})
     {
     }
 
-    {{CLASS}}SurfaceIntegralCalculator(FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
-        : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo)
+    {{CLASS}}SurfaceIntegralCalculator(FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals, const QVector<bool> &selected)
+        : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo), m_selected(selected),
+          m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}})
     {
     }
 
     virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
+        SceneMaterial *material = m_materialTable.material(e->elem_marker);
 
         double *x = e->x;
         double *y = e->y;
 
-        {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = &material->value(QLatin1String("{{MATERIAL_VARIABLE}}"));
+        {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = m_materialTable.value(e->elem_marker, {{MATERIAL_INDEX}});
         {{/VARIABLE_MATERIAL}}
 
         // functions
@@ -69,7 +70,7 @@ public:
 
         // expressions
         {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+        if (m_selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
         {
             for (int i = 0; i < n; i++)
                 result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
@@ -83,26 +84,39 @@ public:
 
     virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
     {
+        // polynomial degree of the solution
+        int solutionOrder = 0;
+        for (int i = 0; i < source_functions.size(); i++)
+            solutionOrder = qMax(solutionOrder, fns[i]->val[0].get_order());
+
         {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-            result[{{POSITION}}] = Hermes::Ord(20);
+        if (m_selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+            result[{{POSITION}}] = integralOrder(solutionOrder, {{EXPRESSION_ORDER}}, {{COORDINATE_ORDER}});
         {{/VARIABLE_SOURCE}}
     }
 
 private:
     // field info
     FieldInfo *m_fieldInfo;
+    // requested integrals
+    QVector<bool> m_selected;
+    // materials by hermes marker
+    MaterialTable m_materialTable;
 };
 
 {{CLASS}}SurfaceIntegral::{{CLASS}}SurfaceIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
     : IntegralValue(fieldInfo, timeStep, adaptivityStep, solutionType)
 {
-    calculate();
 }
 
-void {{CLASS}}SurfaceIntegral::calculate()
+void {{CLASS}}SurfaceIntegral::calculate(const QStringList &ids)
 {
-    m_values.clear();
+    // requested integrals (all if ids are empty)
+    QVector<bool> selected({{INTEGRAL_COUNT}}, ids.isEmpty());
+    {{#VARIABLE_SOURCE}}
+    if (ids.contains(QLatin1String("{{VARIABLE}}")))
+        selected[{{POSITION}}] = true;
+    {{/VARIABLE_SOURCE}}
 
     FieldSolutionID fsid(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType);
     MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
@@ -130,14 +144,14 @@ void {{CLASS}}SurfaceIntegral::calculate()
             }
         }
 
-        if (internalMarkers.size() > 0 || boundaryMarkers.size() > 0)
+        if ((internalMarkers.size() > 0 || boundaryMarkers.size() > 0) && selected.contains(true))
         {
-            {{CLASS}}SurfaceIntegralCalculator calc(m_fieldInfo, ma.solutions(), {{INTEGRAL_COUNT}});
+            {{CLASS}}SurfaceIntegralCalculator calc(m_fieldInfo, ma.solutions(), {{INTEGRAL_COUNT}}, selected);
             double *internalValues = calc.calculate(internalMarkers);
             double *boundaryValues = calc.calculate(boundaryMarkers);
 
             {{#VARIABLE_SOURCE}}
-            if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+            if (selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
                 m_values[QLatin1String("{{VARIABLE}}")] = 0.5 * internalValues[{{POSITION}}] + boundaryValues[{{POSITION}}];
             {{/VARIABLE_SOURCE}}
 
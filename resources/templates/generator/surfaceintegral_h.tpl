@@ -34,7 +34,8 @@ class {{CLASS}}SurfaceIntegral : public IntegralValue
 public:
     {{CLASS}}SurfaceIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType);
 
-    void calculate();
+protected:
+    virtual void calculate(const QStringList &ids);
 };
 
 #endif // {{ID}}_SURFACEINTEGRAL_H
@@ -34,25 +34,26 @@
 class {{CLASS}}VolumetricIntegralEggShellCalculator : public Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>
 {
 public:
-{{CLASS}}VolumetricIntegralEggShellCalculator(FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals)
-    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo)
+{{CLASS}}VolumetricIntegralEggShellCalculator(FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals, const QVector<bool> &selected)
+    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo), m_selected(selected),
+      m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}})
 {
 }
 
-{{CLASS}}VolumetricIntegralEggShellCalculator(FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
-    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo)
+{{CLASS}}VolumetricIntegralEggShellCalculator(FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals, const QVector<bool> &selected)
+    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo), m_selected(selected),
+      m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}})
 {
 }
 
 virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
 {
-    SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-    SceneMaterial *material = label->marker(m_fieldInfo);
+    SceneMaterial *material = m_materialTable.material(e->elem_marker);
 
     double *x = e->x;
     double *y = e->y;
 
-    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = &material->value(QLatin1String("{{MATERIAL_VARIABLE}}"));
+    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = m_materialTable.value(e->elem_marker, {{MATERIAL_INDEX}});
     {{/VARIABLE_MATERIAL}}
     {{#SPECIAL_FUNCTION_SOURCE}}
     {{SPECIAL_EXT_FUNCTION_FULL_NAME}} {{SPECIAL_FUNCTION_NAME}}(m_fieldInfo, 0);{{/SPECIAL_FUNCTION_SOURCE}}
@@ -71,7 +72,7 @@ virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, H
 
     // expressions
     {{#VARIABLE_SOURCE_EGGSHELL}}
-    if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+    if (m_selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
     {
         for (int i = 0; i < n; i++)
             result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
@@ -85,40 +86,50 @@ virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, H
 
 virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
 {
+    // polynomial degree of the solution
+    int solutionOrder = 0;
+    for (int i = 0; i < source_functions.size(); i++)
+        solutionOrder = qMax(solutionOrder, fns[i]->val[0].get_order());
+
     {{#VARIABLE_SOURCE_EGGSHELL}}
-    if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-        result[{{POSITION}}] = Hermes::Ord(20);
+    if (m_selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+        result[{{POSITION}}] = integralOrder(solutionOrder, {{EXPRESSION_ORDER}}, {{COORDINATE_ORDER}});
     {{/VARIABLE_SOURCE_EGGSHELL}}
 }
 
 private:
 // field info
 FieldInfo *m_fieldInfo;
+// requested integrals
+QVector<bool> m_selected;
+// materials by hermes marker
+MaterialTable m_materialTable;
 };
 
 class {{CLASS}}VolumetricIntegralCalculator : public Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>
 {
 public:
-{{CLASS}}VolumetricIntegralCalculator(FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals)
-    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo)
+{{CLASS}}VolumetricIntegralCalculator(FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals, const QVector<bool> &selected)
+    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo), m_selected(selected),
+      m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}})
 {
 }
 
-{{CLASS}}VolumetricIntegralCalculator(FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
-    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo)
+{{CLASS}}VolumetricIntegralCalculator(FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals, const QVector<bool> &selected)
+    : Hermes::Hermes2D::PostProcessing::VolumetricIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo), m_selected(selected),
+      m_materialTable(fieldInfo, QStringList(){{#VARIABLE_MATERIAL}} << QLatin1String("{{MATERIAL_VARIABLE}}"){{/VARIABLE_MATERIAL}})
 {
 }
 
 virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
 {
-    SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-    SceneMaterial *material = label->marker(m_fieldInfo);
+    SceneMaterial *material = m_materialTable.material(e->elem_marker);
 
     double *x = e->x;
     double *y = e->y;
     int elementMarker = e->elem_marker;
 
-    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = &material->value(QLatin1String("{{MATERIAL_VARIABLE}}"));
+    {{#VARIABLE_MATERIAL}}Value *material_{{MATERIAL_VARIABLE}} = m_materialTable.value(e->elem_marker, {{MATERIAL_INDEX}});
     {{/VARIABLE_MATERIAL}}
     {{#SPECIAL_FUNCTION_SOURCE}}
     {{SPECIAL_EXT_FUNCTION_FULL_NAME}} {{SPECIAL_FUNCTION_NAME}}(m_fieldInfo, 0);{{/SPECIAL_FUNCTION_SOURCE}}
@@ -137,7 +148,7 @@ virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, H
 
     // expressions
     {{#VARIABLE_SOURCE}}
-    if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+    if (m_selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
     {
         for (int i = 0; i < n; i++)
             result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
@@ -151,26 +162,44 @@ virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, H
 
 virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
 {
+    // polynomial degree of the solution
+    int solutionOrder = 0;
+    for (int i = 0; i < source_functions.size(); i++)
+        solutionOrder = qMax(solutionOrder, fns[i]->val[0].get_order());
+
     {{#VARIABLE_SOURCE}}
-    if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-        result[{{POSITION}}] = Hermes::Ord(20);
+    if (m_selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+        result[{{POSITION}}] = integralOrder(solutionOrder, {{EXPRESSION_ORDER}}, {{COORDINATE_ORDER}});
     {{/VARIABLE_SOURCE}}
 }
 
 private:
 // field info
 FieldInfo *m_fieldInfo;
+// requested integrals
+QVector<bool> m_selected;
+// materials by hermes marker
+MaterialTable m_materialTable;
 };
 
 {{CLASS}}VolumeIntegral::{{CLASS}}VolumeIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
     : IntegralValue(fieldInfo, timeStep, adaptivityStep, solutionType)
 {
-    calculate();
 }
 
-void {{CLASS}}VolumeIntegral::calculate()
+void {{CLASS}}VolumeIntegral::calculate(const QStringList &ids)
 {
-    m_values.clear();
+    // requested integrals (all if ids are empty)
+    QVector<bool> selected({{INTEGRAL_COUNT}}, ids.isEmpty());
+    {{#VARIABLE_SOURCE}}
+    if (ids.contains(QLatin1String("{{VARIABLE}}")))
+        selected[{{POSITION}}] = true;
+    {{/VARIABLE_SOURCE}}
+    QVector<bool> selectedEggShell({{INTEGRAL_COUNT_EGGSHELL}}, ids.isEmpty());
+    {{#VARIABLE_SOURCE_EGGSHELL}}
+    if (ids.contains(QLatin1String("{{VARIABLE}}")))
+        selectedEggShell[{{POSITION}}] = true;
+    {{/VARIABLE_SOURCE_EGGSHELL}}
 
     FieldSolutionID fsid(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType);
     MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
@@ -199,22 +228,22 @@ void {{CLASS}}VolumeIntegral::calculate()
             }
         }
 
-        if (markers.size() > 0)
+        if (markers.size() > 0 && selected.contains(true))
         {
-            {{CLASS}}VolumetricIntegralCalculator calc(m_fieldInfo, ma.solutions(), {{INTEGRAL_COUNT}});
+            {{CLASS}}VolumetricIntegralCalculator calc(m_fieldInfo, ma.solutions(), {{INTEGRAL_COUNT}}, selected);
             double *values = calc.calculate(markers);
 
             {{#VARIABLE_SOURCE}}
-            if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+            if (selected[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
                 m_values[QLatin1String("{{VARIABLE}}")] = values[{{POSITION}}];
             {{/VARIABLE_SOURCE}}
 
             ::free(values);
         }
 
-        if ({{INTEGRAL_COUNT_EGGSHELL}} > 0 && markers.size() > 0 && markersInverted.size() > 0)
+        if (selectedEggShell.contains(true) && markers.size() > 0 && markersInverted.size() > 0)
         {
-            Hermes::Hermes2D::MeshSharedPtr eggShellMesh = Hermes::Hermes2D::EggShell::get_egg_shell(ma.solutions().at(0)->get_mesh(), markers, 3);
+            Hermes::Hermes2D::MeshSharedPtr eggShellMesh = Agros2D::solutionStore()->eggShellMesh(fsid, markers);
             Hermes::Hermes2D::MeshFunctionSharedPtr<double> eggShell(new Hermes::Hermes2D::ExactSolutionEggShell(eggShellMesh, 3));
 
             Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > slns;
@@ -222,11 +251,11 @@ void {{CLASS}}VolumeIntegral::calculate()
                 slns.push_back(ma.solutions().at(i));
             slns.push_back(eggShell);
 
-            {{CLASS}}VolumetricIntegralEggShellCalculator calcEggShell(m_fieldInfo, slns, {{INTEGRAL_COUNT_EGGSHELL}});
+            {{CLASS}}VolumetricIntegralEggShellCalculator calcEggShell(m_fieldInfo, slns, {{INTEGRAL_COUNT_EGGSHELL}}, selectedEggShell);
             double *valuesEggShell = calcEggShell.calculate(markersInverted);
 
             {{#VARIABLE_SOURCE_EGGSHELL}}
-            if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
+            if (selectedEggShell[{{POSITION}}] && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
                 m_values[QLatin1String("{{VARIABLE}}")] = valuesEggShell[{{POSITION}}];
             {{/VARIABLE_SOURCE_EGGSHELL}}
 
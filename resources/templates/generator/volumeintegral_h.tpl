@@ -34,7 +34,8 @@ class {{CLASS}}VolumeIntegral : public IntegralValue
 public:
     {{CLASS}}VolumeIntegral(FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType);
 
-    void calculate();
+protected:
+    virtual void calculate(const QStringList &ids);
 };
 
 #endif // {{CLASS}}_VOLUMEINTEGRAL_H
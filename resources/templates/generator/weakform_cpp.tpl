@@ -43,13 +43,27 @@
 
 void {{EXT_FUNCTION_NAME}}::value (int n, Hermes::Hermes2D::Func<double>** u_ext, Hermes::Hermes2D::Func<double>* result, Hermes::Hermes2D::Geom<double>* e) const
 {
-    int labelIndex = atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str());
-    Value* value = m_valuesPointers[labelIndex];
-
+    Value* value = m_valuesPointers[e->elem_marker];
+{{#VALUE_TABLE}}
+    // keys are stored in result and the table is evaluated for the whole element at once
+    for(int i = 0; i < n; i++)
+    {
+        result->val[i] = {{DEPENDENCE}};
+    }
+    value->{{BATCH_METHOD}}(n, result->val, result->val);
+{{/VALUE_TABLE}}{{#VALUE_POINTS}}
+    // times are stored in result and the expression is evaluated for the whole element at once
+    for(int i = 0; i < n; i++)
+    {
+        result->val[i] = Agros2D::problem()->actualTime();
+    }
+    value->numbersAtTimeAndPoints(n, result->val, e->x, e->y, result->val);
+{{/VALUE_POINTS}}{{#VALUE_POINTWISE}}
     for(int i = 0; i < n; i++)
     {
         result->val[i] = value->{{VALUE_METHOD}}({{DEPENDENCE}});
     }
+{{/VALUE_POINTWISE}}
 }
 {{/EXT_FUNCTION}}
 
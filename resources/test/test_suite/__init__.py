@@ -36,6 +36,7 @@ fields.heat.HeatPlanar,
 fields.heat.HeatAxisymmetric,
 fields.heat.HeatNonlinPlanar,
 fields.heat.HeatTransientAxisymmetric,
+fields.heat.HeatTransientBenchmarkHigherOrder,
 # magnetic field
 fields.magnetic.MagneticPlanar,
 fields.magnetic.MagneticPlanarTotalCurrent,
@@ -81,6 +81,20 @@ class ElectrostaticPlanar(Agros2DTestCase):
         # surface integral
         surface_integrals = self.electrostatic.surface_integrals([0, 1, 2, 3])
         self.value_test("Electric charge", surface_integrals["Q"], 1.048981e-7)
+
+    def test_values_batch(self):
+        # points in different materials and one point outside of the geometry
+        x = [13.257584, 3.37832, 12.3992, 10.3839, 25.0]
+        y = [11.117738, 15.8626, 0.556005, 15.7187, 25.0]
+        values = self.electrostatic.local_values_batch(x, y)
+
+        for i in range(len(x) - 1):
+            local_values = self.electrostatic.local_values(x[i], y[i])
+            for variable in ["V", "E", "Ex", "Ey", "D", "we"]:
+                self.value_test("{0} in point {1}".format(variable, i), values[variable][i], local_values[variable], 1e-10)
+
+        self.assertEqual(len(values["V"]), len(x))
+        self.assertTrue(values["V"][-1] != values["V"][-1])
             
 class ElectrostaticAxisymmetric(Agros2DTestCase):
     def setUp(self):       
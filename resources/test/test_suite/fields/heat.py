@@ -258,6 +258,59 @@ class HeatTransientBenchmarkAxisymmetric(Agros2DTestCase):
         # point value
         point = self.heat.local_values(0.1, 0.3)
         self.value_test("Temperature", point["T"], 186.5, 0.0004) # permissible error 0.02 %
+
+class HeatTransientBenchmarkHigherOrder(Agros2DTestCase):
+    # NAFEMS benchmark T3 solved by the BDF methods of orders 4 and 5
+    def model(self, order, time_step_method = "fixed", variable_order = False):
+        problem = agros2d.problem(clear = True)
+        problem.coordinate_type = "axisymmetric"
+        problem.mesh_type = "triangle"
+
+        problem.time_step_method = time_step_method
+        problem.time_method_order = order
+        problem.time_method_variable_order = variable_order
+        problem.time_method_tolerance = 1.0
+        problem.time_steps = 100
+        problem.time_total = 190
+
+        # disable view
+        agros2d.view.mesh.disable()
+        agros2d.view.post2d.disable()
+
+        heat = agros2d.field("heat")
+        heat.analysis_type = "transient"
+        heat.transient_initial_condition = 0
+        heat.number_of_refinements = 2
+        heat.polynomial_order = 3
+        heat.solver = "linear"
+
+        heat.add_boundary("Symmetry", "heat_heat_flux", {"heat_heat_flux" : 0})
+        heat.add_boundary("Temperature", "heat_temperature", {"heat_temperature" : 1000})
+        heat.add_material("Material", {"heat_conductivity" : 52, "heat_density" : 7850, "heat_specific_heat" : 460})
+
+        geometry = agros2d.geometry
+        geometry.add_edge(0, 0.4, 0, 0, boundaries = {"heat" : "Symmetry"})
+        geometry.add_edge(0.3, 0.4, 0.3, 0, boundaries = {"heat" : "Temperature"})
+        geometry.add_edge(0.3, 0, 0, 0, boundaries = {"heat" : "Temperature"})
+        geometry.add_edge(0, 0.4, 0.3, 0.4, boundaries = {"heat" : "Temperature"})
+        geometry.add_label(0.151637, 0.112281, materials = {"heat" : "Material"}, area = 0.01)
+
+        problem.solve()
+
+        self.assertAlmostEqual(problem.time_steps_total()[-1], 190)
+        self.value_test("Temperature", heat.local_values(0.1, 0.3)["T"], 186.5, 0.001)
+
+    def test_order_4(self):
+        self.model(4)
+
+    def test_order_5(self):
+        self.model(5)
+
+    def test_order_5_adaptive(self):
+        self.model(5, "adaptive")
+
+    def test_variable_order(self):
+        self.model(5, "adaptive", True)
         
 class HeatTransientAxisymmetric(Agros2DTestCase):
     def setUp(self):  
@@ -363,5 +416,6 @@ if __name__ == '__main__':
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(HeatNonlinPlanar))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(HeatTransientAxisymmetric))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(HeatTransientBenchmarkAxisymmetric))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(HeatTransientBenchmarkHigherOrder))
     suite.run(result)
     
\ No newline at end of file
@@ -83,6 +83,45 @@ class ParticleTracingPlanar(Agros2DTestCase):
         self.value_test("Particle position", x[-1], 0.080043)
         self.value_test("Particle position", y[-1], 0.015374)
 
+    def test_multiple_particles(self):
+        tracing = agros2d.particle_tracing
+        tracing.drag_force_density = 1.2041
+        tracing.drag_force_coefficient = 0
+        tracing.drag_force_reference_area = 1e-06
+        tracing.mass = 9.109e-31
+        tracing.charge = -1.602e-19
+        
+        tracing.reflect_on_different_material = True
+        tracing.reflect_on_boundary = False
+        tracing.coefficient_of_restitution = 0
+        
+        tracing.maximum_number_of_steps = 1e3
+        tracing.maximum_relative_error = 0.0001
+        tracing.minimum_step = 0.0003
+        
+        tracing.initial_position = (0.01, 0.0)
+        tracing.initial_velocity = (8e7, 0)
+        tracing.number_of_particles = 50
+        tracing.particles_dispersion = 0.002
+        
+        tracing.solve_particles(seed = 3)
+        self.assertEqual(tracing.particles(), 50)
+        
+        # first particle starts at the initial position
+        x, y, z = tracing.positions(0)
+        self.value_test("Particle position", x[-1], 0.080043)
+        self.value_test("Particle position", y[-1], 0.015374)
+        
+        # the same seed gives identical trajectories
+        trajectories = [tracing.positions(i) for i in range(tracing.particles())]
+        tracing.solve_particles(seed = 3)
+        for i in range(tracing.particles()):
+            self.assertEqual(tracing.positions(i), trajectories[i])
+        
+        # other seed spreads the particles differently
+        tracing.solve_particles(seed = 4)
+        self.assertNotEqual(tracing.positions(1), trajectories[1])
+        
 class ParticleTracingAxisymmetric(Agros2DTestCase):
     def setUp(self): 
         # problem
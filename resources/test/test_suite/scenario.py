@@ -4,6 +4,8 @@ import unittest as ut
 class Agros2DTestCase(ut.TestCase):
     def __init__(self, methodName='runTest'):
         ut.TestCase.__init__(self, methodName)
+        # additional information reported with the result of the test
+        self.info = ""
 
     def value_test(self, text, value, normal, error = 0.03):
         if ((normal == 0.0) and (abs(value) < 1e-14)):
@@ -36,11 +38,12 @@ class Agros2DTestResult(ut.TestResult):
         cls = test.id().split(".")[-2]
         id = cls + "." + tst
         
-        self.output.append([modu, cls, tst, -self.time * 1000, "OK", ""])
+        info = getattr(test, "info", "")
+        self.output.append([modu, cls, tst, -self.time * 1000, "OK", info])
         
         print("{0}".format(id.ljust(60, "."))),
         print("{0:08.2f}".format(-self.time * 1000).rjust(15, " ") + " ms " +
-              "{0}".format("OK".rjust(10, ".")))
+              "{0}".format("OK".rjust(10, ".")) + (" ({0})".format(info) if info else ""))
 
     def addError(self, test, err):
         ut.TestResult.addError(self, test, err)
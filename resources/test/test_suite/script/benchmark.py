@@ -3,6 +3,7 @@ from test_suite.scenario import Agros2DTestCase
 from test_suite.scenario import Agros2DTestResult
 
 from math import sin, cos
+import time
 
 class BenchmarkGeometryTransformation(Agros2DTestCase):
     def setUp(self):
@@ -26,10 +27,401 @@ class BenchmarkGeometryTransformation(Agros2DTestCase):
         for i in range(25):
             self.geometry.scale_selection(0, 0, 0.5)
             
+class BenchmarkGeometryConstruction(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.geometry = a2d.geometry
+
+    def test_add_edges(self):
+        # grid of squares (shared nodes and edges are found by coordinates)
+        n = 100
+        for i in range(n):
+            for j in range(n):
+                self.geometry.add_edge(i, j, i + 1, j)
+                self.geometry.add_edge(i, j, i, j + 1)
+
+        self.assertEqual(self.geometry.nodes_count(), n*(n+1) + n)
+        self.assertEqual(self.geometry.edges_count(), 2*n*n)
+
+    def test_add_edges_batch(self):
+        n = 100
+        with self.geometry.batch():
+            for i in range(n):
+                for j in range(n):
+                    self.geometry.add_edge(i, j, i + 1, j)
+                    self.geometry.add_edge(i, j, i, j + 1)
+
+        self.assertEqual(self.geometry.nodes_count(), n*(n+1) + n)
+        self.assertEqual(self.geometry.edges_count(), 2*n*n)
+
+    def test_add_nodes_and_labels(self):
+        n = 20000
+        for i in range(n):
+            self.geometry.add_node(i*sin(i), i*cos(i))
+            self.geometry.add_label(i*sin(i) + 0.5, i*cos(i) + 0.5)
+
+        self.assertEqual(self.geometry.nodes_count(), n)
+        self.assertEqual(self.geometry.labels_count(), n)
+
+class BenchmarkMeshGenerator(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.mesh_type = "triangle"
+
+        electrostatic = a2d.field("electrostatic")
+        electrostatic.add_boundary("Source", "electrostatic_potential", {"electrostatic_potential" : 1})
+        electrostatic.add_material("Air", {"electrostatic_permittivity" : 1})
+
+        self.geometry = a2d.geometry
+        self.geometry.add_rect(0, 0, 1, 1, boundaries = {"electrostatic" : "Source"})
+        for i in range(5):
+            for j in range(5):
+                self.geometry.add_circle(0.1 + 0.2*i, 0.1 + 0.2*j, 0.05, boundaries = {"electrostatic" : "Source"})
+        self.geometry.add_label(0.01, 0.01, materials = {"electrostatic" : "Air"})
+
+        self.triangle_library = a2d.options.mesh_triangle_library
+
+    def tearDown(self):
+        a2d.options.mesh_triangle_library = self.triangle_library
+
+    def mesh(self):
+        for i in range(10):
+            self.problem.mesh()
+        self.assertTrue(a2d.field("electrostatic").initial_mesh_info()["elements"] > 0)
+
+    def test_triangle_library(self):
+        a2d.options.mesh_triangle_library = True
+        self.mesh()
+
+    def test_triangle_process(self):
+        a2d.options.mesh_triangle_library = False
+        self.mesh()
+
+    def test_triangle_compare(self):
+        # the library and the executable get the same switches and have to give the same mesh
+        info = dict()
+        elapsed = dict()
+        for library in [True, False]:
+            a2d.options.mesh_triangle_library = library
+            start = time.time()
+            for i in range(10):
+                self.problem.mesh()
+            elapsed[library] = time.time() - start
+            info[library] = a2d.field("electrostatic").initial_mesh_info()
+
+        self.assertEqual(info[True]["nodes"], info[False]["nodes"])
+        self.assertEqual(info[True]["elements"], info[False]["elements"])
+        self.info = "library {0:.3f} s, process {1:.3f} s".format(elapsed[True], elapsed[False])
+
+class BenchmarkMaterialSweep(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = "planar"
+        self.problem.mesh_type = "triangle"
+
+        self.electrostatic = a2d.field("electrostatic")
+        self.electrostatic.analysis_type = "steadystate"
+        self.electrostatic.number_of_refinements = 1
+        self.electrostatic.polynomial_order = 2
+        self.electrostatic.add_boundary("Source", "electrostatic_potential", {"electrostatic_potential" : 1})
+        self.electrostatic.add_boundary("Ground", "electrostatic_potential", {"electrostatic_potential" : 0})
+        self.electrostatic.add_material("Air", {"electrostatic_permittivity" : 1})
+        self.electrostatic.add_material("Dielectric", {"electrostatic_permittivity" : 3})
+
+        self.geometry = a2d.geometry
+        self.geometry.add_rect(0, 0, 1, 1, boundaries = {"electrostatic" : "Ground"})
+        for i in range(3):
+            for j in range(3):
+                self.geometry.add_circle(0.2 + 0.3*i, 0.2 + 0.3*j, 0.05, boundaries = {"electrostatic" : "Source"})
+        self.geometry.add_rect(0.1, 0.05, 0.8, 0.05)
+        self.geometry.add_label(0.01, 0.01, materials = {"electrostatic" : "Air"})
+        self.geometry.add_label(0.5, 0.075, materials = {"electrostatic" : "Dielectric"})
+        for i in range(3):
+            for j in range(3):
+                self.geometry.add_label(0.2 + 0.3*i, 0.2 + 0.3*j, materials = {"electrostatic" : "none"})
+
+    def sweep(self, remesh):
+        energy = []
+        for i in range(100):
+            self.electrostatic.modify_material("Dielectric", {"electrostatic_permittivity" : 1 + 0.1*i})
+            if (remesh):
+                self.problem.mesh()
+            self.problem.solve()
+            energy.append(self.electrostatic.volume_integrals()["We"])
+
+        # energy increases with permittivity
+        self.assertTrue(energy[-1] > energy[0])
+
+    def test_material_sweep(self):
+        # initial mesh is reused (geometry and mesh parameters are unchanged)
+        self.sweep(False)
+
+    def test_material_sweep_remesh(self):
+        # previous behaviour, remeshing before each solve
+        self.sweep(True)
+
+class BenchmarkElementMaterials(Agros2DTestCase):
+    def setUp(self):
+        # many labels and elements (per element cost of material lookup dominates)
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = "planar"
+        self.problem.mesh_type = "triangle"
+
+        self.electrostatic = a2d.field("electrostatic")
+        self.electrostatic.analysis_type = "steadystate"
+        self.electrostatic.number_of_refinements = 2
+        self.electrostatic.polynomial_order = 2
+        self.electrostatic.add_boundary("Source", "electrostatic_potential", {"electrostatic_potential" : 1})
+        self.electrostatic.add_boundary("Ground", "electrostatic_potential", {"electrostatic_potential" : 0})
+        self.electrostatic.add_boundary("Neumann", "electrostatic_surface_charge_density", {"electrostatic_surface_charge_density" : 0})
+        self.electrostatic.add_material("Air", {"electrostatic_permittivity" : 1})
+        self.electrostatic.add_material("Dielectric", {"electrostatic_permittivity" : 3})
+
+        # strips with alternating materials
+        n = 20
+        self.geometry = a2d.geometry
+        self.geometry.add_edge(0, 0, 0, 1, boundaries = {"electrostatic" : "Neumann"})
+        for i in range(n):
+            self.geometry.add_edge(float(i)/n, 0, float(i + 1)/n, 0, boundaries = {"electrostatic" : "Ground"})
+            self.geometry.add_edge(float(i)/n, 1, float(i + 1)/n, 1, boundaries = {"electrostatic" : "Source"})
+            self.geometry.add_edge(float(i + 1)/n, 0, float(i + 1)/n, 1, boundaries = {"electrostatic" : "Neumann"} if (i == n - 1) else {})
+            self.geometry.add_label((i + 0.5)/n, 0.5, materials = {"electrostatic" : "Dielectric" if (i % 2) else "Air"})
+
+        self.problem.solve()
+
+    def test_volume_integrals(self):
+        for i in range(10):
+            self.electrostatic.volume_integrals()
+
+    def test_local_values_batch(self):
+        x = [0.001 + 0.998*(i % 300)/300.0 for i in range(90000)]
+        y = [0.001 + 0.998*(i // 300)/300.0 for i in range(90000)]
+        values = self.electrostatic.local_values_batch(x, y)
+        self.assertEqual(len(values["V"]), len(x))
+
+class BenchmarkNonlinearMaterial(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = "planar"
+        self.problem.mesh_type = "triangle"
+
+        self.magnetic = a2d.field("magnetic")
+        self.magnetic.analysis_type = "steadystate"
+        self.magnetic.number_of_refinements = 2
+        self.magnetic.polynomial_order = 3
+        self.magnetic.solver = "newton"
+        self.magnetic.solver_parameters['residual'] = 0.01
+        self.magnetic.solver_parameters['damping'] = 'automatic'
+        self.magnetic.solver_parameters['jacobian_reuse'] = False
+
+        # dense B-H curve (assembly of Newton method is dominated by table lookups)
+        b = [2.5*i/500.0 for i in range(501)]
+        mur = [1 + 4000.0/(1 + (value/1.2)**8) for value in b]
+
+        self.magnetic.add_boundary("A = 0", "magnetic_potential", {"magnetic_potential_real" : 0})
+        self.magnetic.add_material("Iron", {"magnetic_permeability" : { "value" : 4000, "x" : b, "y" : mur }})
+        self.magnetic.add_material("Coil", {"magnetic_permeability" : 1, "magnetic_current_density_external_real" : 2e6})
+        self.magnetic.add_material("Air", {"magnetic_permeability" : 1})
+
+        self.geometry = a2d.geometry
+        self.geometry.add_rect(-0.2, -0.2, 0.4, 0.4, boundaries = {"magnetic" : "A = 0"})
+        self.geometry.add_rect(-0.05, -0.05, 0.1, 0.1)
+        self.geometry.add_rect(0.07, -0.03, 0.03, 0.06)
+        self.geometry.add_label(0.15, 0.15, materials = {"magnetic" : "Air"})
+        self.geometry.add_label(0, 0, materials = {"magnetic" : "Iron"})
+        self.geometry.add_label(0.085, 0, materials = {"magnetic" : "Coil"})
+
+    def test_newton_assembly(self):
+        self.problem.solve()
+        self.assertTrue(self.magnetic.volume_integrals([1])["Wm"] > 0)
+
+class BenchmarkTransientIntegrals(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = "axisymmetric"
+        self.problem.mesh_type = "triangle"
+        self.problem.time_step_method = "fixed"
+        self.problem.time_method_order = 2
+        self.problem.time_total = 100
+        self.problem.time_steps = 50
+
+        self.heat = a2d.field("heat")
+        self.heat.analysis_type = "transient"
+        self.heat.number_of_refinements = 1
+        self.heat.polynomial_order = 2
+        self.heat.transient_initial_condition = 20
+        self.heat.add_boundary("Convection", "heat_heat_flux", {"heat_convection_heat_transfer_coefficient" : 10, "heat_convection_external_temperature" : 20})
+        self.heat.add_material("Heater", {"heat_conductivity" : 10, "heat_volume_heat" : 1e4, "heat_density" : 1000, "heat_specific_heat" : 500})
+        self.heat.add_material("Insulation", {"heat_conductivity" : 0.5, "heat_density" : 200, "heat_specific_heat" : 1000})
+
+        self.geometry = a2d.geometry
+        self.geometry.add_rect(0, 0, 1, 1, boundaries = {"heat" : "Convection"})
+        self.geometry.add_rect(0, 0.25, 0.25, 0.5)
+        self.geometry.add_label(0.1, 0.5, materials = {"heat" : "Heater"})
+        self.geometry.add_label(0.5, 0.1, materials = {"heat" : "Insulation"})
+
+        self.problem.solve()
+
+    def test_volume_integrals(self):
+        # integrals are integrated at the order given by the solution (instead of the fixed order)
+        temperature = [self.heat.volume_integrals([0], time_step = step)["T"] for step in range(len(self.problem.time_steps_total()))]
+        self.assertTrue(temperature[-1] > temperature[0])
+
+    def test_surface_integrals(self):
+        for step in range(len(self.problem.time_steps_total())):
+            self.heat.surface_integrals([0, 1, 2, 3], time_step = step)
+
+class BenchmarkTimeErrorEstimate(Agros2DTestCase):
+    # adaptive time stepping (wall time and number of time steps of both error estimates and of the variable order are reported by the test result)
+    def heat(self, estimate, variable_order = False):
+        problem = a2d.problem(clear = True)
+        problem.coordinate_type = "axisymmetric"
+        problem.mesh_type = "triangle"
+        problem.time_step_method = "adaptive"
+        problem.time_method_error_estimate = estimate
+        problem.time_method_order = 5 if variable_order else 2
+        problem.time_method_variable_order = variable_order
+        problem.time_method_tolerance = 1.0
+        problem.time_steps = 20
+        problem.time_total = 190
+
+        heat = a2d.field("heat")
+        heat.analysis_type = "transient"
+        heat.transient_initial_condition = 0
+        heat.number_of_refinements = 2
+        heat.polynomial_order = 3
+        heat.solver = "linear"
+        heat.add_boundary("Symmetry", "heat_heat_flux", {"heat_heat_flux" : 0})
+        heat.add_boundary("Temperature", "heat_temperature", {"heat_temperature" : 1000})
+        heat.add_material("Material", {"heat_conductivity" : 52, "heat_density" : 7850, "heat_specific_heat" : 460})
+
+        geometry = a2d.geometry
+        geometry.add_edge(0, 0.4, 0, 0, boundaries = {"heat" : "Symmetry"})
+        geometry.add_edge(0.3, 0.4, 0.3, 0, boundaries = {"heat" : "Temperature"})
+        geometry.add_edge(0.3, 0, 0, 0, boundaries = {"heat" : "Temperature"})
+        geometry.add_edge(0, 0.4, 0.3, 0.4, boundaries = {"heat" : "Temperature"})
+        geometry.add_label(0.15, 0.1, materials = {"heat" : "Material"}, area = 0.01)
+
+        problem.solve()
+        self.info = "{0} time steps".format(len(problem.time_steps_total()) - 1)
+
+        # NAFEMS benchmark T3 (186.5 deg)
+        self.value_test("Temperature", heat.local_values(0.1, 0.3)["T"], 186.5, 0.01)
+
+    def magnetic(self, estimate, variable_order = False):
+        problem = a2d.problem(clear = True)
+        problem.coordinate_type = "planar"
+        problem.mesh_type = "triangle"
+        problem.time_step_method = "adaptive"
+        problem.time_method_error_estimate = estimate
+        problem.time_method_order = 5 if variable_order else 2
+        problem.time_method_variable_order = variable_order
+        problem.time_method_tolerance = 0.05
+        problem.time_steps = 50
+        problem.time_total = 0.4
+
+        magnetic = a2d.field("magnetic")
+        magnetic.analysis_type = "transient"
+        magnetic.transient_initial_condition = 0
+        magnetic.number_of_refinements = 3
+        magnetic.polynomial_order = 2
+        magnetic.solver = "linear"
+        magnetic.add_boundary("A = 0", "magnetic_potential", {"magnetic_potential_real" : 0})
+        magnetic.add_material("Copper", {"magnetic_permeability" : 1, "magnetic_conductivity" : 57e6})
+        magnetic.add_material("Coil", {"magnetic_permeability" : 1, "magnetic_current_density_external_real" : { "expression" : "1e7*(exp(-10/0.7*time) - exp(-12/0.7*time))" }})
+        magnetic.add_material("Air", {"magnetic_permeability" : 1})
+
+        geometry = a2d.geometry
+        geometry.add_rect(-0.75, -0.25, 1.5, 1.0, boundaries = {"magnetic" : "A = 0"})
+        geometry.add_edge(-0.25, 0, 0.2, 0.05)
+        geometry.add_edge(0.1, 0.2, 0.2, 0.05)
+        geometry.add_edge(0.1, 0.2, -0.2, 0.1)
+        geometry.add_edge(-0.2, 0.1, -0.25, 0)
+        geometry.add_rect(-0.2, 0.2, 0.15, 0.15)
+        geometry.add_label(0.1879, 0.520366, materials = {"magnetic" : "Air"})
+        geometry.add_label(-0.15588, 0.306142, materials = {"magnetic" : "Coil"})
+        geometry.add_label(-0.00331733, 0.106999, materials = {"magnetic" : "Copper"})
+
+        problem.solve()
+        self.info = "{0} time steps".format(len(problem.time_steps_total()) - 1)
+
+        self.assertAlmostEqual(problem.time_steps_total()[-1], 0.4)
+
+    def test_heat_embedded(self):
+        self.heat("embedded")
+
+    def test_heat_double_solve(self):
+        self.heat("double_solve")
+
+    def test_heat_variable_order(self):
+        self.heat("embedded", True)
+
+    def test_magnetic_embedded(self):
+        self.magnetic("embedded")
+
+    def test_magnetic_double_solve(self):
+        self.magnetic("double_solve")
+
+    def test_magnetic_variable_order(self):
+        self.magnetic("embedded", True)
+
+class BenchmarkFieldMetadata(Agros2DTestCase):
+    def test_startup(self):
+        # field creation and module metadata (boundary types and material variables are checked)
+        for i in range(20):
+            problem = a2d.problem(clear = True)
+            electrostatic = a2d.field("electrostatic")
+            electrostatic.add_boundary("Source", "electrostatic_potential", {"electrostatic_potential" : 1})
+            electrostatic.add_material("Air", {"electrostatic_permittivity" : 1})
+            magnetic = a2d.field("magnetic")
+            magnetic.add_boundary("A = 0", "magnetic_potential", {"magnetic_potential_real" : 0})
+            magnetic.add_material("Air", {"magnetic_permeability" : 1})
+            heat = a2d.field("heat")
+            heat.add_boundary("Flux", "heat_heat_flux", {"heat_heat_flux" : 0})
+            heat.add_material("Air", {"heat_conductivity" : 0.02})
+
+    def test_transient(self):
+        # many short time steps (metadata is read per component and per material in each step)
+        problem = a2d.problem(clear = True)
+        problem.coordinate_type = "planar"
+        problem.mesh_type = "triangle"
+        problem.time_step_method = "fixed"
+        problem.time_method_order = 2
+        problem.time_total = 100
+        problem.time_steps = 200
+
+        heat = a2d.field("heat")
+        heat.analysis_type = "transient"
+        heat.number_of_refinements = 0
+        heat.polynomial_order = 1
+        heat.transient_initial_condition = 20
+        heat.add_boundary("Convection", "heat_heat_flux", {"heat_convection_heat_transfer_coefficient" : 10, "heat_convection_external_temperature" : 20})
+        for i in range(10):
+            heat.add_material("Material {0}".format(i), {"heat_conductivity" : 1 + i, "heat_volume_heat" : { "expression" : "1e4*(time < 50)" }, "heat_density" : 1000, "heat_specific_heat" : 500})
+
+        geometry = a2d.geometry
+        geometry.add_edge(0, 0, 0, 1, boundaries = {"heat" : "Convection"})
+        for i in range(10):
+            geometry.add_edge(i/10.0, 0, (i + 1)/10.0, 0, boundaries = {"heat" : "Convection"})
+            geometry.add_edge(i/10.0, 1, (i + 1)/10.0, 1, boundaries = {"heat" : "Convection"})
+            geometry.add_edge((i + 1)/10.0, 0, (i + 1)/10.0, 1, boundaries = {"heat" : "Convection"} if (i == 9) else {})
+            geometry.add_label((i + 0.5)/10.0, 0.5, materials = {"heat" : "Material {0}".format(i)})
+
+        problem.solve()
+        self.assertAlmostEqual(problem.time_steps_total()[-1], 100)
+
 if __name__ == '__main__':        
     import unittest as ut
     
     suite = ut.TestSuite()
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkGeometryTransformation))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkGeometryConstruction))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkMeshGenerator))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkMaterialSweep))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkElementMaterials))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkNonlinearMaterial))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkTransientIntegrals))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkTimeErrorEstimate))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkFieldMetadata))
     suite.run(result)
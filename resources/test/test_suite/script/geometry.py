@@ -142,6 +142,21 @@ class TestGeometry(Agros2DTestCase):
     def test_modify_label(self):
         pass
 
+    """ batch() """
+    def test_batch(self):
+        with self.geometry.batch():
+            self.model()
+
+        self.assertEqual(self.geometry.nodes_count(), 4)
+        self.assertEqual(self.geometry.edges_count(), 4)
+
+        self.problem.solve()
+        self.assertAlmostEqual(self.electrostatic.volume_integrals([0])['S'], self.a * self.b)
+
+    def test_end_batch_without_begin(self):
+        with self.assertRaises(RuntimeError):
+            self.geometry.end_batch()
+
 class TestGeometryTransformations(Agros2DTestCase):
     def model(self):
         self.problem = a2d.problem(clear = True)
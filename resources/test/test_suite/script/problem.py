@@ -121,6 +121,21 @@ class TestProblemTime(Agros2DTestCase):
         with self.assertRaises(RuntimeError):
             self.problem.elapsed_time()
 
+    """ cache_statistics """
+    def test_cache_statistics(self):
+        self.problem.solve()
+        a2d.cache_statistics_reset()
+
+        heat = a2d.field('heat')
+        for time_step in range(11):
+            heat.local_values(0.5, 0.5, time_step = time_step)
+        heat.local_values(0.5, 0.5, time_step = 10)
+
+        statistics = a2d.cache_statistics()
+        self.assertEqual(statistics['hits'] + statistics['misses'], 12)
+        self.assertTrue(statistics['hits'] >= 1)
+        self.assertTrue(statistics['memory'] <= a2d.options.cache_size)
+
 class TestProblemSolution(Agros2DTestCase):
     def setUp(self):
         self.problem = a2d.problem(clear = True)
@@ -158,6 +173,34 @@ class TestProblemSolution(Agros2DTestCase):
         self.problem.clear()
         self.assertEqual(a2d.geometry.nodes_count(), 0)
 
+class TestProblemExpression(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = "planar"
+
+        self.heat = a2d.field('heat')
+        self.heat.analysis_type = 'steadystate'
+        self.heat.number_of_refinements = 1
+        self.heat.polynomial_order = 2
+        self.heat.add_boundary("Temperature", "heat_temperature", {"heat_temperature" : 0})
+        self.heat.add_material("Material", {"heat_conductivity" : 10, "heat_volume_heat" : 0})
+
+        a2d.geometry.add_rect(0, 0, 1, 1, boundaries = {'heat' : 'Temperature'}, materials = {'heat' : 'Material'})
+
+    def solve(self, expression):
+        self.heat.modify_material("Material", {"heat_volume_heat" : { "expression" : expression }})
+        self.problem.solve()
+
+        return self.heat.local_values(0.3, 0.4)["T"]
+
+    def test_compiled_expression(self):
+        # compiled expression and Python fallback (conditional expression is not supported) give the same result
+        expression = "1e3*(1 + x**2 - sin(pi*y)/2) + max(x, y)"
+        compiled = self.solve(expression)
+        python = self.solve("(" + expression + ") if True else 0")
+
+        self.value_test("Temperature", compiled, python)
+
 if __name__ == '__main__':        
     import unittest as ut
     
@@ -166,4 +209,5 @@ if __name__ == '__main__':
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblem))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemTime))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemSolution))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemExpression))
     suite.run(result)
\ No newline at end of file
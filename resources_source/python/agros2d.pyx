@@ -7,6 +7,8 @@ from libcpp.map cimport map
 from cython.operator cimport preincrement as incr
 from cython.operator cimport dereference as deref
 
+import array
+
 cdef extern from "limits.h":
     int c_INT_MIN "INT_MIN"
     int c_INT_MAX "INT_MAX"
@@ -114,6 +116,10 @@ cdef extern from "../../agros2d-library/pythonlab/pythonengine_agros.h":
     int appTime()
     void memoryUsage(vector[int] &time, vector[int] &usage)
 
+    # solution cache
+    void cacheStatistics(map[string, double] &statistics)
+    void cacheStatisticsReset()
+
     # PyOptions
     cdef cppclass PyOptions:
         int getNumberOfThreads()
@@ -125,6 +131,9 @@ cdef extern from "../../agros2d-library/pythonlab/pythonengine_agros.h":
         bool getSolverCache()
         void setSolverCache(bool cache)
 
+        bool getMeshTriangleLibrary()
+        void setMeshTriangleLibrary(bool library)
+
         bool getSaveMatrixRHS()
         void setSaveMatrixRHS(bool save)
 
@@ -156,6 +165,21 @@ def memory_usage():
 
     return time, usage
 
+def cache_statistics():
+    cdef map[string, double] statistics_map
+    cacheStatistics(statistics_map)
+
+    statistics = dict()
+    it = statistics_map.begin()
+    while it != statistics_map.end():
+        statistics[deref(it).first.c_str()] = deref(it).second
+        incr(it)
+
+    return statistics
+
+def cache_statistics_reset():
+    cacheStatisticsReset()
+
 cdef class __Options__:
     cdef PyOptions *thisptr
 
@@ -182,6 +206,12 @@ cdef class __Options__:
         def __set__(self, cache):
             self.thisptr.setSolverCache(cache)
 
+    property mesh_triangle_library:
+        def __get__(self):
+            return self.thisptr.getMeshTriangleLibrary()
+        def __set__(self, library):
+            self.thisptr.setMeshTriangleLibrary(library)
+
     property save_matrix_and_rhs:
         def __get__(self):
             return self.thisptr.getSaveMatrixRHS()
@@ -75,6 +75,8 @@ cdef extern from "../../agros2d-library/pythonlab/pyfield.h":
 
         void localValues(double x, double y, int timeStep, int adaptivityStep,
                          string &solutionType, map[string, double] &results) except +
+        void localValuesBatch(vector[double] &x, vector[double] &y, int timeStep, int adaptivityStep,
+                              string &solutionType, map[string, vector[double]] &results) except +
         void surfaceIntegrals(vector[int], int timeStep, int adaptivityStep,
                               string &solutionType, map[string, double] &results) except +
         void volumeIntegrals(vector[int], int timeStep, int adaptivityStep,
@@ -524,6 +526,46 @@ cdef class __Field__:
 
         return out
 
+    def local_values_batch(self, x, y, time_step = None, adaptivity_step = None, solution_type = "normal"):
+        """Compute local values in many points and return dictionary with arrays of results (one value for each point).
+
+        local_values_batch(x, y, time_step = None, adaptivity_step = None, solution_type = "normal")
+
+        Points outside of the geometry have values nan.
+
+        Keyword arguments:
+        x -- list of x or r coordinates of points
+        y -- list of y or z coordinates of points
+        time_step -- time step (default is None - use last time step)
+        adaptivity_step -- adaptivity step (default is None - use adaptive step)
+        solution_type -- solution type (default is "normal")
+        """
+        cdef vector[double] x_vector
+        for value in x:
+            x_vector.push_back(value)
+
+        cdef vector[double] y_vector
+        for value in y:
+            y_vector.push_back(value)
+
+        cdef map[string, vector[double]] results
+        self.thisptr.localValuesBatch(x_vector, y_vector,
+                                      int(-1 if time_step is None else time_step),
+                                      int(-1 if adaptivity_step is None else adaptivity_step),
+                                      string(solution_type), results)
+
+        # columns are copied as raw memory into arrays of doubles
+        out = dict()
+        it = results.begin()
+        while it != results.end():
+            column = array.array('d')
+            if (deref(it).second.size() > 0):
+                column.fromstring((<char *> &deref(it).second[0])[:deref(it).second.size() * sizeof(double)])
+            out[deref(it).first.c_str()] = column
+            incr(it)
+
+        return out
+
     # surface integrals
     def surface_integrals(self, edges = [], time_step = None, adaptivity_step = None, solution_type = "normal"):
         """Compute surface integrals on edges and return dictionary with results.
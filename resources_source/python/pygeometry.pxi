@@ -9,6 +9,9 @@ cdef extern from "../../agros2d-library/pythonlab/pygeometry.h":
         int addEdgeByNodes(int nodeStartIndex, int nodeEndIndex, double angle, int segments, int is_curvilinear, map[string, int] &refinements, map[string, string] &boundaries) except +
         int addLabel(double x, double y, double area, map[string, int] &refinements, map[string, int] &orders, map[string, string] &materials) except +
 
+        void beginBatch()
+        void endBatch() except +
+
         void modifyEdge(int index, double angle, int segments, int is_curvilinear, map[string, int] &refinements, map[string, string] &boundaries) except +
         void modifyLabel(int index, double area, map[string, int] &refinements, map[string, int] &orders, map[string, string] &materials) except +
 
@@ -37,6 +40,18 @@ cdef extern from "../../agros2d-library/pythonlab/pygeometry.h":
         
         void exportVTK(string filename)
 
+class __GeometryBatch__(object):
+    def __init__(self, geometry):
+        self.geometry = geometry
+
+    def __enter__(self):
+        self.geometry.begin_batch()
+        return self.geometry
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.geometry.end_batch()
+        return False
+
 cdef class __Geometry__:
     cdef PyGeometry *thisptr
 
@@ -49,6 +64,22 @@ cdef class __Geometry__:
         """Activate preprocessor mode."""
         self.thisptr.activate()
 
+    def begin_batch(self):
+        """Start batch of geometry changes (checks of geometry are postponed to end_batch())."""
+        self.thisptr.beginBatch()
+
+    def end_batch(self):
+        """Finish batch of geometry changes and check the whole geometry at once."""
+        self.thisptr.endBatch()
+
+    def batch(self):
+        """Return context manager for batch of geometry changes.
+
+        with geometry.batch():
+            geometry.add_edge(0, 0, 1, 0)
+        """
+        return __GeometryBatch__(self)
+
     def add_node(self, x, y):
         """Add a new node according to coordinates and return its index.
 
@@ -21,9 +21,15 @@ cdef extern from "../../agros2d-library/pythonlab/pyproblem.h":
         int getTimeMethodOrder()
         void setTimeMethodOrder(int timeMethodOrder) except +
 
+        bool getTimeMethodVariableOrder()
+        void setTimeMethodVariableOrder(bool variableOrder)
+
         double getTimeMethodTolerance()
         void setTimeMethodTolerance(double timeMethodTolerance) except +
 
+        string getTimeMethodErrorEstimate()
+        void setTimeMethodErrorEstimate(string &timeErrorEstimate) except +
+
         double getTimeTotal()
         void setTimeTotal(double timeTotal) except +
 
@@ -93,12 +99,24 @@ cdef class __Problem__:
         def __set__(self, time_method_order):
             self.thisptr.setTimeMethodOrder(time_method_order)
 
+    property time_method_variable_order:
+        def __get__(self):
+            return self.thisptr.getTimeMethodVariableOrder()
+        def __set__(self, variable_order):
+            self.thisptr.setTimeMethodVariableOrder(variable_order)
+
     property time_method_tolerance:
         def __get__(self):
             return self.thisptr.getTimeMethodTolerance()
         def __set__(self, time_method_tolerance):
             self.thisptr.setTimeMethodTolerance(time_method_tolerance)
 
+    property time_method_error_estimate:
+        def __get__(self):
+            return self.thisptr.getTimeMethodErrorEstimate().c_str()
+        def __set__(self, time_method_error_estimate):
+            self.thisptr.setTimeMethodErrorEstimate(string(time_method_error_estimate))
+
     property time_total:
         def __get__(self):
             return self.thisptr.getTimeTotal()